@@ -0,0 +1,162 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include "constraint_adder.h"
+#include "constraint_encoder.h"
+#include "global_vars.h"
+#include "parser.h"
+#include "timetabler.h"
+
+/*
+ * Benchmark for encoding the predefined constraints of a generated instance.
+ * It displays the time taken, the size of the formula, and the number and peak
+ * size of heap allocations made while encoding.
+ */
+
+Timetabler *timetabler;
+
+/*
+ * Counts the heap allocations made while counting is enabled, and tracks the
+ * number of bytes allocated at a time. The size of each allocation is stored
+ * in a header before the memory returned.
+ */
+static unsigned long allocationCount = 0;
+static bool countAllocations = false;
+static long liveBytes = 0;
+static long peakBytes = 0;
+static const std::size_t HEADER_SIZE = alignof(std::max_align_t);
+
+void *operator new(std::size_t size) {
+  if (countAllocations) allocationCount++;
+  char *p = static_cast<char *>(std::malloc(size + HEADER_SIZE));
+  if (p == nullptr) throw std::bad_alloc();
+  *reinterpret_cast<std::size_t *>(p) = size;
+  liveBytes += size;
+  if (liveBytes > peakBytes) peakBytes = liveBytes;
+  return p + HEADER_SIZE;
+}
+
+void operator delete(void *p) noexcept {
+  if (p == nullptr) return;
+  char *start = static_cast<char *>(p) - HEADER_SIZE;
+  liveBytes -= *reinterpret_cast<std::size_t *>(start);
+  std::free(start);
+}
+
+void operator delete(void *p, std::size_t) noexcept { operator delete(p); }
+
+/*
+ * Writes a fields file and an input file for an instance with the given
+ * number of courses. The other fields grow with the number of courses.
+ */
+void writeInstance(std::string fieldsFile, std::string inputFile,
+                   unsigned courseCount) {
+  std::mt19937 generator(42);
+  unsigned instructorCount = courseCount / 3 + 1;
+  unsigned classroomCount = courseCount / 8 + 1;
+  unsigned slotCount = 20;
+  unsigned programCount = 10;
+  const char *days[] = {"Monday", "Tuesday", "Wednesday", "Thursday",
+                        "Friday"};
+
+  std::ofstream fields(fieldsFile);
+  fields << "weights:\n"
+            "  instructor: [-1, 1]\n"
+            "  segment: [-1, 1]\n"
+            "  is_minor: [-1, 1]\n"
+            "  program: -1\n"
+            "  classroom: [1, 1]\n"
+            "  slot: [1, 1]\n"
+            "instructors:\n";
+  for (unsigned i = 0; i < instructorCount; i++) {
+    fields << "  - I" << i << "\n";
+  }
+  fields << "classrooms:\n";
+  for (unsigned i = 0; i < classroomCount; i++) {
+    fields << "  - number: R" << i << "\n    size: " << 40 + 20 * (i % 4)
+           << "\n";
+  }
+  fields << "segments:\n  start: 1\n  end: 6\nslots:\n";
+  for (unsigned i = 0; i < slotCount; i++) {
+    fields << "  - name: S" << i << "\n    is_minor: "
+           << (i % 10 == 9 ? "true" : "false") << "\n    time_periods:\n";
+    for (unsigned j = 0; j < 3; j++) {
+      unsigned hours = 8 + (i + 3 * j) % 10;
+      fields << "      - day: " << days[(i + 2 * j) % 5] << "\n"
+             << "        start: \"" << hours << ":00\"\n"
+             << "        end: \"" << hours + 1 << ":00\"\n";
+    }
+  }
+  fields << "programs:\n";
+  for (unsigned i = 0; i < programCount; i++) {
+    fields << "  - P" << i << "\n";
+  }
+
+  std::ofstream input(inputFile);
+  input << "name,class_size,instructor,segment,is_minor";
+  for (unsigned i = 0; i < programCount; i++) {
+    input << ",P" << i;
+  }
+  input << ",classroom,slot\n";
+  const char *segments[] = {"16", "13", "46", "12", "34", "56"};
+  for (unsigned i = 0; i < courseCount; i++) {
+    input << "C" << i << "," << 20 + generator() % 80 << ",I"
+          << generator() % instructorCount << ","
+          << segments[generator() % 6] << ","
+          << (generator() % 10 == 0 ? "Yes" : "No");
+    for (unsigned j = 0; j < programCount; j++) {
+      unsigned type = generator() % 6;
+      input << "," << (type == 0 ? "Core" : type == 1 ? "Elective" : "No");
+    }
+    input << ",,\n";
+  }
+}
+
+int main(int argc, char *argv[]) {
+  unsigned courseCount = (argc > 1) ? std::atoi(argv[1]) : 200;
+  std::string fieldsFile = "bench_encoding_fields.yaml";
+  std::string inputFile = "bench_encoding_input.csv";
+  writeInstance(fieldsFile, inputFile, courseCount);
+
+  timetabler = new Timetabler();
+  Parser parser(timetabler);
+  parser.parseFields(fieldsFile);
+  parser.parseInput(inputFile);
+
+  allocationCount = 0;
+  long startBytes = liveBytes;
+  peakBytes = liveBytes;
+  countAllocations = true;
+  auto start = std::chrono::steady_clock::now();
+  parser.addVars();
+  ConstraintEncoder encoder(timetabler);
+  ConstraintAdder constraintAdder(&encoder, timetabler);
+  constraintAdder.addConstraints();
+  timetabler->addHighLevelClauses();
+  timetabler->addExistingAssignments();
+  auto end = std::chrono::steady_clock::now();
+  countAllocations = false;
+
+  std::cout << "Courses: " << courseCount << std::endl;
+  std::cout << "Encoding time: "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << " ms" << std::endl;
+  std::cout << "Variables: " << timetabler->getFormula()->nVars()
+            << std::endl;
+  std::cout << "Hard clauses: " << timetabler->getFormula()->nHard()
+            << std::endl;
+  std::cout << "Soft clauses: " << timetabler->getFormula()->nSoft()
+            << std::endl;
+  std::cout << "Heap allocations: " << allocationCount << std::endl;
+  std::cout << "Peak heap growth: " << (peakBytes - startBytes) / 1024
+            << " KiB" << std::endl;
+  std::cout << "Final heap growth: " << (liveBytes - startBytes) / 1024
+            << " KiB" << std::endl;
+  delete timetabler;
+  return 0;
+}
@@ -0,0 +1,169 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "fields/is_minor.h"
+#include "fields/slot.h"
+
+/*
+ * Microbenchmarks for Slot intersection and morning tests, comparing the
+ * minute of the week representation with the previous representation of
+ * Time as separate hours and minutes, which is reproduced here.
+ */
+
+namespace legacy {
+
+struct Time {
+  unsigned hours, minutes;
+  bool operator==(const Time &other) {
+    return (hours == other.hours) && (minutes == other.minutes);
+  }
+  bool operator<(const Time &other) {
+    if (hours == other.hours) {
+      return minutes < other.minutes;
+    } else {
+      return hours < other.hours;
+    }
+  }
+  bool operator<=(const Time &other) {
+    return (*this < other) || (*this == other);
+  }
+  bool operator>=(const Time &other) { return !(*this < other); }
+  bool operator>(const Time &other) { return !(*this <= other); }
+  bool isMorningTime() { return hours < 13; }
+};
+
+struct SlotElement {
+  Time startTime, endTime;
+  Day day;
+  bool isIntersecting(SlotElement &other) {
+    if (day != other.day) {
+      return false;
+    }
+    if (startTime < other.startTime) {
+      return !(endTime <= other.startTime);
+    } else if (startTime > other.startTime) {
+      return !(startTime >= other.endTime);
+    }
+    return true;
+  }
+};
+
+struct Slot {
+  std::vector<SlotElement> slotElements;
+  bool isIntersecting(Slot &other) {
+    for (unsigned i = 0; i < slotElements.size(); i++) {
+      for (unsigned j = 0; j < other.slotElements.size(); j++) {
+        if (slotElements[i].isIntersecting(other.slotElements[j])) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+  bool isMorningSlot() {
+    for (unsigned i = 0; i < slotElements.size(); i++) {
+      if (!slotElements[i].startTime.isMorningTime()) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+}  // namespace legacy
+
+/*
+ * Runs a function a number of times and displays the time taken per call.
+ */
+template <typename F>
+unsigned long runBenchmark(std::string name, unsigned calls,
+                           unsigned repetitions, F function) {
+  unsigned long checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned r = 0; r < repetitions; r++) {
+    checksum += function();
+  }
+  auto end = std::chrono::steady_clock::now();
+  double nanoseconds =
+      std::chrono::duration<double, std::nano>(end - start).count();
+  std::cout << name << ": " << nanoseconds / calls / repetitions
+            << " ns per call" << std::endl;
+  return checksum;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned slotCount = (argc > 1) ? std::atoi(argv[1]) : 500;
+  unsigned repetitions = (argc > 2) ? std::atoi(argv[2]) : 20;
+
+  // slots of one to four one hour long elements, on working days
+  std::mt19937 generator(42);
+  std::vector<Slot> slots;
+  std::vector<legacy::Slot> legacySlots;
+  for (unsigned i = 0; i < slotCount; i++) {
+    std::vector<SlotElement> slotElements;
+    legacy::Slot legacySlot;
+    unsigned elementCount = 1 + generator() % 4;
+    for (unsigned j = 0; j < elementCount; j++) {
+      Day day = static_cast<Day>(generator() % 5);
+      unsigned hours = 8 + generator() % 10;
+      unsigned minutes = 30 * (generator() % 2);
+      Time start(hours, minutes), end(hours + 1, minutes);
+      slotElements.push_back(SlotElement(start, end, day));
+      legacySlot.slotElements.push_back(
+          {{hours, minutes}, {hours + 1, minutes}, day});
+    }
+    slots.push_back(Slot(std::to_string(i), IsMinor(false), slotElements));
+    legacySlots.push_back(legacySlot);
+  }
+
+  unsigned pairCount = slotCount * slotCount;
+  unsigned long legacyIntersections = runBenchmark(
+      "Slot::isIntersecting (hours and minutes)", pairCount, repetitions,
+      [&]() {
+        unsigned long count = 0;
+        for (unsigned i = 0; i < slotCount; i++) {
+          for (unsigned j = 0; j < slotCount; j++) {
+            count += legacySlots[i].isIntersecting(legacySlots[j]);
+          }
+        }
+        return count;
+      });
+  unsigned long intersections = runBenchmark(
+      "Slot::isIntersecting (minute of week)", pairCount, repetitions, [&]() {
+        unsigned long count = 0;
+        for (unsigned i = 0; i < slotCount; i++) {
+          for (unsigned j = 0; j < slotCount; j++) {
+            count += slots[i].isIntersecting(slots[j]);
+          }
+        }
+        return count;
+      });
+
+  unsigned long legacyMorning = runBenchmark(
+      "Slot::isMorningSlot (hours and minutes)", slotCount, repetitions * 100,
+      [&]() {
+        unsigned long count = 0;
+        for (unsigned i = 0; i < slotCount; i++) {
+          count += legacySlots[i].isMorningSlot();
+        }
+        return count;
+      });
+  unsigned long morning = runBenchmark(
+      "Slot::isMorningSlot (minute of week)", slotCount, repetitions * 100,
+      [&]() {
+        unsigned long count = 0;
+        for (unsigned i = 0; i < slotCount; i++) {
+          count += slots[i].isMorningSlot();
+        }
+        return count;
+      });
+
+  if (legacyIntersections != intersections || legacyMorning != morning) {
+    std::cout << "Results differ between the representations" << std::endl;
+    return 1;
+  }
+  return 0;
+}
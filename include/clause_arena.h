@@ -0,0 +1,149 @@
+/** @file */
+
+#ifndef CLAUSE_ARENA_H
+#define CLAUSE_ARENA_H
+
+#include <utility>
+#include <vector>
+#include "core/SolverTypes.h"
+#include "global.h"
+
+using namespace NSPACE;
+
+/**
+ * @brief      Class for the buffers of destroyed objects kept for reuse by the
+ * next objects made on the same thread.
+ *
+ * Short lived objects, such as temporary Clauses, then do not allocate memory
+ * for their buffers. At most Global::SPARE_BUFFER_COUNT buffers are kept, and
+ * only if their capacity is at most Global::SPARE_BUFFER_LIMIT.
+ *
+ * @tparam     T     The type of the elements of the buffers
+ */
+template <typename T>
+class SpareBuffers {
+ private:
+  /**
+   * The empty buffers
+   */
+  std::vector<std::vector<T>> buffers;
+  /**
+   * Whether the spare buffers of this thread have been destroyed, after which
+   * the buffers released on the thread are freed
+   */
+  static thread_local bool destroyed;
+  /**
+   * The spare buffers of this thread
+   */
+  static thread_local SpareBuffers pool;
+
+ public:
+  ~SpareBuffers() { destroyed = true; }
+
+  /**
+   * @brief      Gives a spare buffer to an object whose buffer has no memory.
+   *
+   * @param      buffer  The buffer of the object
+   */
+  static void take(std::vector<T> &buffer) {
+    if (destroyed || buffer.capacity() > 0 || pool.buffers.empty()) {
+      return;
+    }
+    buffer.swap(pool.buffers.back());
+    pool.buffers.pop_back();
+  }
+
+  /**
+   * @brief      Keeps the memory of the buffer of an object for reuse, if it
+   * is not too large and there is room for it. The buffer is left empty.
+   *
+   * @param      buffer  The buffer of the object
+   */
+  static void release(std::vector<T> &buffer) {
+    if (destroyed || buffer.capacity() == 0 ||
+        buffer.capacity() > Global::SPARE_BUFFER_LIMIT ||
+        pool.buffers.size() >= Global::SPARE_BUFFER_COUNT) {
+      buffer.clear();
+      return;
+    }
+    buffer.clear();
+    pool.buffers.emplace_back();
+    pool.buffers.back().swap(buffer);
+  }
+};
+
+template <typename T>
+thread_local bool SpareBuffers<T>::destroyed = false;
+
+template <typename T>
+thread_local SpareBuffers<T> SpareBuffers<T>::pool;
+
+/**
+ * @brief      Class for a read only view of the literals of a clause.
+ *
+ * A ClauseSpan does not own the literals, and is only valid as long as the
+ * ClauseArena it was taken from is not modified. The accessors are defined
+ * here so that they can be inlined.
+ */
+class ClauseSpan {
+ private:
+  /**
+   * A pointer to the first literal of the clause
+   */
+  const Lit *first;
+  /**
+   * The number of literals in the clause
+   */
+  unsigned length;
+
+ public:
+  ClauseSpan(const Lit *first, unsigned length)
+      : first(first), length(length) {}
+  const Lit *begin() const { return first; }
+  const Lit *end() const { return first + length; }
+  unsigned size() const { return length; }
+  const Lit &operator[](unsigned index) const { return first[index]; }
+};
+
+/**
+ * @brief      Class for a contiguous store of clauses.
+ *
+ * The literals of all the clauses are stored in a single buffer, and each
+ * clause is described by a header with its offset in the buffer and its
+ * number of literals. Adding a clause thus does not allocate memory, except
+ * when the buffers grow. The buffers of a destroyed arena are kept as
+ * SpareBuffers, so that the arenas of temporary Clauses do not allocate
+ * memory either.
+ */
+class ClauseArena {
+ private:
+  /**
+   * The literals of all the clauses, one clause after another
+   */
+  std::vector<Lit> lits;
+  /**
+   * The offset in lits and the number of literals of each clause
+   */
+  std::vector<std::pair<unsigned, unsigned>> headers;
+  void takeSpareBuffers();
+
+ public:
+  ClauseArena();
+  ClauseArena(const ClauseArena &);
+  ClauseArena(ClauseArena &&);
+  ~ClauseArena();
+  ClauseArena &operator=(const ClauseArena &);
+  ClauseArena &operator=(ClauseArena &&);
+  unsigned size() const;
+  unsigned litCount() const;
+  ClauseSpan operator[](unsigned) const;
+  void addClause(const Lit *, unsigned);
+  void addClause(const ClauseSpan &);
+  void addClause(const std::vector<Lit> &);
+  void addClauses(const ClauseArena &);
+  void addClauses(const ClauseArena &, unsigned, unsigned);
+  void reserve(unsigned, unsigned);
+  void clear();
+};
+
+#endif
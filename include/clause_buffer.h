@@ -0,0 +1,52 @@
+/** @file */
+
+#ifndef CLAUSE_BUFFER_H
+#define CLAUSE_BUFFER_H
+
+#include <vector>
+#include "MaxSATFormula.h"
+#include "clause_arena.h"
+#include "core/SolverTypes.h"
+
+using namespace NSPACE;
+using namespace openwbo;
+
+/**
+ * @brief      Class for the variables and clauses of a part of the formula
+ * that is encoded apart from the formula.
+ *
+ * The variables created for the part are numbered from a given first
+ * variable, which is the number of variables of the formula when the part is
+ * started, and variables below it are those of the formula. The clauses are
+ * kept in a ClauseArena with their weights. Merging the buffer into the
+ * formula renumbers its variables after the variables of the formula, so
+ * parts can be encoded by different threads and merged in a fixed order.
+ */
+class ClauseBuffer {
+ private:
+  /**
+   * The first variable of the part
+   */
+  Var firstVar;
+  /**
+   * The number of variables created for the part
+   */
+  int varCount;
+  /**
+   * The clauses of the part
+   */
+  ClauseArena clauses;
+  /**
+   * The weight of each clause, negative for hard clauses
+   */
+  std::vector<int> weights;
+
+ public:
+  ClauseBuffer(Var);
+  Var newVar();
+  int getVarCount();
+  void addClause(const ClauseSpan &, int);
+  void mergeInto(MaxSATFormula *);
+};
+
+#endif
@@ -0,0 +1,68 @@
+/** @file */
+
+#ifndef CLAUSE_SINK_H
+#define CLAUSE_SINK_H
+
+#include "clause_arena.h"
+#include "core/SolverTypes.h"
+#include "mtl/Vec.h"
+class Clauses;
+class Timetabler;
+
+using namespace NSPACE;
+
+/**
+ * @brief      Class for a destination to which clauses are written one at a
+ * time.
+ *
+ * Constraints can be written to a ClauseSink as they are encoded, instead of
+ * being collected as a whole in a Clauses object first, so that only the
+ * clauses of the part being encoded are held in memory.
+ */
+class ClauseSink {
+ public:
+  virtual ~ClauseSink() {}
+  /**
+   * @brief      Writes a clause to the sink.
+   *
+   * @param[in]  clause  The clause
+   */
+  virtual void addClause(const ClauseSpan &clause) = 0;
+  void addClauses(const Clauses &);
+};
+
+/**
+ * @brief      Class for a ClauseSink that adds clauses to the formula of a
+ * Timetabler, each implied by a guard literal.
+ *
+ * Given a guard literal x, every clause C written to the sink is added to the
+ * formula as (~x OR C), which is the CNF form of x -> C. If no guard is set,
+ * the clauses are added as they are. Clauses may be written to the sink by
+ * several threads at once, while the formula is encoded in parallel.
+ */
+class FormulaClauseSink : public ClauseSink {
+ private:
+  /**
+   * A pointer to the Timetabler to whose formula the clauses are added
+   */
+  Timetabler *timetabler;
+  /**
+   * The weight with which the clauses are added, negative for hard clauses
+   */
+  int weight;
+  /**
+   * The negation of the guard literal, which is prepended to every clause
+   */
+  Lit negatedGuard;
+  /**
+   * Whether a guard literal is set
+   */
+  bool guarded;
+
+ public:
+  FormulaClauseSink(Timetabler *, int);
+  FormulaClauseSink(Timetabler *, Lit, int);
+  void addClause(const ClauseSpan &);
+};
+
+#endif
@@ -5,6 +5,7 @@
 
 #include <vector>
 #include "cclause.h"
+#include "clause_arena.h"
 #include "timetabler.h"
 
 using namespace NSPACE;
@@ -14,7 +15,8 @@ class CClause;
 /**
  * @brief      Class for representing a set of clauses.
  *
- * A set of clauses is represented as a vector of type CClause.
+ * A set of clauses is stored contiguously in a ClauseArena, and individual
+ * clauses are accessed as ClauseSpan views.
  * This class defines operations between sets of clauses, such as
  * AND, OR, NOT, and IMPLIES. This also defines functions to
  * create Clauses, add clauses, and work with them. All clauses
@@ -23,9 +25,22 @@ class CClause;
 class Clauses {
  private:
   /**
-   * The clauses, each a CClause member object, in this set of Clauses
+   * The clauses in this set of Clauses
    */
-  std::vector<CClause> clauses;
+  ClauseArena clauses;
+  /**
+   * The clauses of the definitions of auxiliary variables that are needed
+   * only if this set of Clauses is negated. The clauses of each definition are
+   * stored consecutively, in the order of negativeDefinitionLits.
+   */
+  ClauseArena negativeDefinitionClauses;
+  /**
+   * The auxiliary literal of each definition needed only if this set of
+   * Clauses is negated, with the number of clauses that must imply it
+   */
+  std::vector<std::pair<Lit, unsigned>> negativeDefinitionLits;
+  void addNegativeDefinitions();
+  void addNegativeDefinitionsOf(const Clauses &);
 
  public:
   Clauses(const std::vector<CClause> &);
@@ -33,6 +48,11 @@ class Clauses {
   Clauses(const Lit &);
   Clauses(const Var &);
   Clauses();
+  Clauses(const Clauses &) = default;
+  Clauses(Clauses &&) = default;
+  ~Clauses();
+  Clauses &operator=(const Clauses &) = default;
+  Clauses &operator=(Clauses &&) = default;
   Clauses operator~();
   Clauses operator&(const Clauses &);
   Clauses operator&(const CClause &);
@@ -40,8 +60,12 @@ class Clauses {
   Clauses operator|(const CClause &);
   Clauses operator>>(const Clauses &);
   void addClauses(const CClause &);
+  void addClauses(const ClauseSpan &);
   void addClauses(const std::vector<CClause> &);
   void addClauses(const Clauses &);
+  void addClauses(Clauses &&);
+  unsigned size() const;
+  ClauseSpan getClause(unsigned) const;
   std::vector<CClause> getClauses() const;
   void print();
   void clear();
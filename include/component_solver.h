@@ -0,0 +1,81 @@
+/** @file */
+
+#ifndef COMPONENT_SOLVER_H
+#define COMPONENT_SOLVER_H
+
+#include <cstdint>
+#include <vector>
+#include "MaxSATFormula.h"
+#include "core/SolverTypes.h"
+#include "tsolver.h"
+
+using namespace NSPACE;
+
+/**
+ * @brief      Class for solving the independent components of a formula
+ * separately, and merging their models.
+ *
+ * Variables fixed by hard unit clauses are replaced by their values, and the
+ * remaining clauses are split into components that share no variables. Each
+ * component is loaded into a solver of its own, and the components are solved
+ * by several threads, largest component first. The cost and the lower bound
+ * of the merged model are the sums over the components, and the merged model
+ * is optimal if every component model is.
+ */
+class ComponentSolver {
+ private:
+  /**
+   * The formula, which is not changed
+   */
+  MaxSATFormula *formula;
+  /**
+   * The variables of each component, where the variable at position i is
+   * variable i of the component formula
+   */
+  std::vector<std::vector<Var>> componentVars;
+  /**
+   * The value of each variable fixed by a hard unit clause, and l_Undef for
+   * the others
+   */
+  std::vector<lbool> fixedValues;
+  /**
+   * The total weight of the soft clauses falsified by the fixed variables
+   */
+  uint64_t fixedCost;
+  /**
+   * The solver of each component, which owns the component formula
+   */
+  std::vector<TSolver *> solvers;
+  /**
+   * The merged model
+   */
+  std::vector<lbool> model;
+  /**
+   * The cost of the merged model
+   */
+  uint64_t cost;
+  /**
+   * The lower bound proved on the optimal cost
+   */
+  uint64_t lowerBound;
+  /**
+   * Whether the merged model was proved to be optimal
+   */
+  bool optimal;
+
+ public:
+  ComponentSolver(MaxSATFormula *);
+  ~ComponentSolver();
+  std::vector<MaxSATFormula *> splitFormula(std::vector<std::vector<Var>> &,
+                                            std::vector<lbool> &, uint64_t &);
+  bool loadComponents();
+  const std::vector<TSolver *> &getSolvers();
+  void setHint(const std::vector<Lit> &);
+  void solve(unsigned);
+  std::vector<lbool> getModel();
+  uint64_t getCost();
+  uint64_t getLowerBound();
+  bool isOptimal();
+};
+
+#endif
@@ -3,6 +3,8 @@
 #ifndef CONSTRAINT_ADDER_H
 #define CONSTRAINT_ADDER_H
 
+#include <functional>
+#include "clause_sink.h"
 #include "clauses.h"
 #include "constraint_encoder.h"
 #include "core/SolverTypes.h"
@@ -20,8 +22,12 @@ using namespace NSPACE;
  * courses are iterated over and calls are made to an object of
  * ConstraintEncoder to get Clauses corresponding to lower level constraints for
  * a given course, which are then joined together using the defined operations.
- * It also contains functions to add these predefined constraints with their
- * prescribed weights to the Timetabler, which then adds it to the solver.
+ * Constraints over all pairs of courses are written to a ClauseSink one pair at
+ * a time instead of being returned as a whole. The constraints of each course,
+ * and the pairs with each course, are encoded in parallel through
+ * Timetabler::encodeInParallel(). It also contains functions to add these
+ * predefined constraints with their prescribed weights to the Timetabler,
+ * which then adds it to the solver.
  */
 class ConstraintAdder {
  private:
@@ -35,20 +41,28 @@ class ConstraintAdder {
    * constraints to the solver
    */
   Timetabler *timetabler;
-  Clauses fieldSingleValueAtATime(FieldType);
-  std::vector<Clauses> exactlyOneFieldValuePerCourse(FieldType);
-  Clauses instructorSingleCourseAtATime();
-  Clauses classroomSingleCourseAtATime();
-  Clauses programSingleCoreCourseAtATime();
-  std::vector<Clauses> minorInMinorTime();
-  std::vector<Clauses> coreInMorningTime();
-  std::vector<Clauses> electiveInNonMorningTime();
+  void fieldSingleValueAtATime(FieldType, ClauseSink &);
+  Clauses exactlyOneFieldValuePerCourse(FieldType, int);
+  void instructorSingleCourseAtATime(ClauseSink &);
+  void classroomSingleCourseAtATime(ClauseSink &);
+  void classroomCapacityAtATime(ClauseSink &);
+  void programSingleCoreCourseAtATime(ClauseSink &);
+  Lit getConstraintLit(PredefinedClauses, const int course);
+  void addStreamedConstraint(PredefinedClauses,
+                             void (ConstraintAdder::*)(ClauseSink &));
+  void addCourseConstraint(PredefinedClauses,
+                           const std::function<Clauses(int)> &);
+  Clauses minorInMinorTime(int);
+  Clauses coreInMorningTime(int);
+  Clauses electiveInNonMorningTime(int);
   // Clauses existingAssignmentClauses();
-  std::vector<Clauses> programAtMostOneOfCoreOrElective();
+  Clauses programAtMostOneOfCoreOrElective(int);
+  void valuePrecedence(FieldType, const std::vector<unsigned> &, ClauseSink &);
 
  public:
   ConstraintAdder(ConstraintEncoder *, Timetabler *);
   void addConstraints();
+  void addSymmetryBreakingConstraints();
   void addSingleConstraint(PredefinedClauses, const Clauses &,
                            const int course);
 };
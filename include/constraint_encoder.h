@@ -3,6 +3,8 @@
 #ifndef CONSTRAINT_ENCODER_H
 #define CONSTRAINT_ENCODER_H
 
+#include <atomic>
+#include <unordered_map>
 #include <vector>
 #include "clauses.h"
 #include "core/SolverTypes.h"
@@ -34,7 +36,57 @@ class ConstraintEncoder {
    * A pointer to a Timetabler object for accessing field data
    */
   Timetabler *timetabler;
+  /**
+   * Stores, for each Course, the variables that are True if the Course is
+   * held in a given atomic slot time unit. These are created on first use.
+   */
+  std::vector<std::vector<Var>> slotTimeUnitVars;
+  /**
+   * Stores, for each Course, the variables that are True if the Course is
+   * held in a given segment unit. These are created on first use.
+   */
+  std::vector<std::vector<Var>> segmentTimeUnitVars;
+  /**
+   * The number of auxiliary variables created by the at most one encodings,
+   * which like the other counts of the at most one encodings may be updated
+   * by several threads
+   */
+  std::atomic<unsigned> atMostOneVarCount;
+  /**
+   * The number of clauses given by the at most one encodings
+   */
+  std::atomic<unsigned> atMostOneClauseCount;
+  /**
+   * The number of pairs of field values constrained by the at most one
+   * encodings, which determines the size of a pairwise encoding
+   */
+  std::atomic<unsigned> atMostOnePairCount;
+  /**
+   * The subformulas whose defining literals are cached
+   */
+  enum CachedFormula { sameFieldTypeAndValue };
+  /**
+   * Stores the literal defining each cached subformula, keyed by the
+   * subformula, the pair of courses, and the FieldType
+   */
+  std::unordered_map<unsigned long long, Lit> definitionCache;
+  /**
+   * The number of times a cached subformula was reused
+   */
+  unsigned cacheHitCount;
+  /**
+   * The number of subformulas that were encoded and cached
+   */
+  unsigned cacheMissCount;
+  unsigned long long getCacheKey(CachedFormula, int, int, FieldType);
   std::vector<Var> getAllowedVars(int, FieldType);
+  void addNotBoth(Var, Var, Clauses &);
+  void addTimeUnitVars(int);
+  AtMostOneEncoding getAtMostOneEncoding(FieldType, unsigned);
+  Clauses atMostOnePairwise(const std::vector<Lit> &);
+  Clauses atMostOneSequential(const std::vector<Lit> &);
+  Clauses atMostOneCommander(const std::vector<Lit> &);
+  Clauses atMostOneBimander(const std::vector<Lit> &);
 
  public:
   ConstraintEncoder(Timetabler *);
@@ -42,6 +94,9 @@ class ConstraintEncoder {
   Clauses hasSameFieldTypeNotSameValue(int, int, FieldType);
   Clauses notIntersectingTime(int, int);
   Clauses notIntersectingTimeField(int, int, FieldType);
+  Clauses fieldValueSingleCourseAtATime(FieldType, int);
+  Clauses coursesWithinCapacity(unsigned, unsigned, const std::vector<int> &,
+                                const std::vector<unsigned> &);
   Clauses hasExactlyOneFieldValueTrue(int, FieldType);
   Clauses hasAtLeastOneFieldValueTrue(int, FieldType);
   Clauses hasAtMostOneFieldValueTrue(int, FieldType);
@@ -54,6 +109,8 @@ class ConstraintEncoder {
   Clauses courseInMorningTime(int);
   Clauses programAtMostOneOfCoreOrElective(int);
   Clauses hasFieldTypeListedValues(int, FieldType, std::vector<int>);
+  unsigned getCacheHitCount();
+  void displayEncodingStatistics();
 };
 
 #endif
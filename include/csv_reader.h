@@ -0,0 +1,83 @@
+/** @file */
+
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief      Class for reading a CSV file row by row.
+ *
+ * The file is memory mapped, and the fields of a row point into the mapping,
+ * so that no string is made for a field unless it is asked for. The first row
+ * is the header, which names the columns, and the index of a column is looked
+ * up once by its name with getColumn(). Fields may be enclosed in double
+ * quotes, in which case they may contain separators, line breaks and doubled
+ * double quotes. Empty lines are skipped.
+ *
+ * A file that cannot be read, or an unterminated quoted field, is not logged
+ * but kept as the error of the reader, and no further rows are read, so that
+ * a file can be read by a thread other than the main thread.
+ */
+class CsvReader {
+ private:
+  /**
+   * The name of the file
+   */
+  std::string file;
+  /**
+   * The start of the mapping of the file
+   */
+  const char *begin;
+  /**
+   * The position up to which the file has been read
+   */
+  const char *cursor;
+  /**
+   * The end of the mapping of the file
+   */
+  const char *end;
+  /**
+   * The separator between the fields of a row
+   */
+  char separator;
+  /**
+   * The line of the file on which the current row starts
+   */
+  unsigned lineNumber;
+  /**
+   * The line of the file on which the next row starts
+   */
+  unsigned nextLineNumber;
+  /**
+   * Stores the names of the columns
+   */
+  std::vector<std::string> header;
+  /**
+   * Stores the start and the end of each field of the current row
+   */
+  std::vector<std::pair<const char *, const char *>> fields;
+  /**
+   * The error met while reading the file, or an empty string if there was
+   * none
+   */
+  std::string error;
+  bool split();
+  CsvReader(const CsvReader &);
+  CsvReader &operator=(const CsvReader &);
+
+ public:
+  CsvReader(std::string, char = ',');
+  ~CsvReader();
+  int getColumn(const std::string &);
+  bool readRow();
+  std::string getField(int);
+  bool isField(int, const char *);
+  unsigned getLineNumber();
+  std::string getError();
+};
+
+#endif
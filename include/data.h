@@ -4,7 +4,9 @@
 #define DATA_H
 
 #include <map>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "core/Solver.h"
 #include "fields/classroom.h"
@@ -13,6 +15,7 @@
 #include "fields/program.h"
 #include "fields/segment.h"
 #include "fields/slot.h"
+#include "global.h"
 
 using namespace NSPACE;
 
@@ -71,6 +74,22 @@ class Data {
    * solver by the Parser.
    */
   std::vector<std::vector<std::vector<Var>>> fieldValueVars;
+  /**
+   * Stores the field values that are fixed before the variables are created,
+   * in the form (Course, FieldType, field value). A field value is l_True or
+   * l_False if it is fixed by a hard unit fact, and l_Undef otherwise. No
+   * variable is created for a fixed field value, and trueVar or falseVar is
+   * used for it in fieldValueVars instead.
+   */
+  std::vector<std::vector<std::vector<lbool>>> fixedFieldValues;
+  /**
+   * A variable that is always True, used for field values fixed to True
+   */
+  Var trueVar;
+  /**
+   * A variable that is always False, used for field values fixed to False
+   */
+  Var falseVar;
   /**
    * Stores the high level variables. It is of the form
    * (Course, FieldType). If an assignment for a given
@@ -96,6 +115,13 @@ class Data {
    * Classroom or a Slot, the assigned value is l_Undef.
    */
   std::vector<std::vector<std::vector<lbool>>> existingAssignmentVars;
+  /**
+   * Stores the field values of a previous solution given as a hint, in the
+   * same form as existingAssignmentVars. Hints only guide the search of the
+   * solver, and do not change the constraints or the objective. If no hint is
+   * given, the Timetabler fills it with a greedy timetable before solving.
+   */
+  std::vector<std::vector<std::vector<lbool>>> hintValues;
   /**
    * Stores the weights for the high level variables of each
    * FieldType. This represents the weight that must be given to
@@ -126,7 +152,106 @@ class Data {
    * Stores the course with the associated custom constraint.
    */
   std::map<int, unsigned> customMap;
+  /**
+   * The encoding used for the constraints that prevent two courses with a
+   * common Instructor, Classroom or core Program from being scheduled at an
+   * intersecting time.
+   */
+  ClashEncoding clashEncoding;
+  /**
+   * Stores the encoding used for the constraint that at most one field value
+   * is True for a Course, for each FieldType.
+   */
+  std::vector<AtMostOneEncoding> atMostOneEncodings;
+  /**
+   * The encoding used for the auxiliary variables of a disjunction of Clauses
+   */
+  DisjunctionEncoding disjunctionEncoding;
+  /**
+   * Whether field values fixed by hard unit facts are found before the
+   * variables are created
+   */
+  bool presolve;
+  /**
+   * Whether clauses that break the symmetry between interchangeable
+   * Classrooms and between interchangeable Slots are added
+   */
+  bool symmetryBreaking;
+  /**
+   * The variable that guards the symmetry breaking clauses, which is made
+   * True by a hard unit clause, or var_Undef if there are no such clauses.
+   * An incremental session leaves the unit clause out, so that the clauses
+   * can be released
+   */
+  Var symmetryBreakingVar;
+  /**
+   * Whether the timetable is solved in two stages, the first of which only
+   * counts the Classrooms in use at each time, and the second of which
+   * assigns the Classrooms by matching
+   */
+  bool twoStage;
+  /**
+   * Stores, for each FieldType, the field values named in a custom constraint
+   */
+  std::vector<std::set<unsigned>> customFieldValues;
+  /**
+   * Stores, for each Slot, the indices of the atomic slot time units it
+   * covers. An atomic slot time unit is a maximal interval of the week in
+   * which no SlotElement of any Slot starts or ends, so two Slots intersect if
+   * and only if they cover a common atomic slot time unit.
+   */
+  std::vector<std::vector<unsigned>> slotTimeUnits;
+  /**
+   * Stores, for each Segment, the indices of the segment units it covers.
+   * Two Segments intersect if and only if they cover a common segment unit.
+   */
+  std::vector<std::vector<unsigned>> segmentTimeUnits;
+  /**
+   * The number of atomic slot time units
+   */
+  unsigned slotTimeUnitCount;
+  /**
+   * The number of segment units
+   */
+  unsigned segmentTimeUnitCount;
+  /**
+   * Stores, for every pair of Slots, whether they intersect
+   */
+  std::vector<std::vector<bool>> slotIntersections;
+  /**
+   * Stores, for every pair of Segments, whether they intersect
+   */
+  std::vector<std::vector<bool>> segmentIntersections;
+  /**
+   * Stores, for each Slot, the indices of the Slots that intersect it
+   */
+  std::vector<std::vector<unsigned>> intersectingSlots;
+  /**
+   * Stores, for each Segment, the indices of the Segments that intersect it
+   */
+  std::vector<std::vector<unsigned>> intersectingSegments;
+  /**
+   * Stores, for each FieldType, the index of each field value by its name.
+   * Programs are named with their CourseType.
+   */
+  std::vector<std::unordered_map<std::string, unsigned>> fieldValueIndices;
+  /**
+   * Stores the index of each Course by its name
+   */
+  std::unordered_map<std::string, unsigned> courseIndices;
   Data();
+  void computeTimeUnits();
+  void computeIntersections();
+  void indexFieldValues();
+  void indexCourse(unsigned);
+  int getFieldValueIndex(FieldType, const std::string &);
+  int getCourseIndex(const std::string &);
+  unsigned computeFixedFieldValues();
+  bool isIntersecting(FieldType, unsigned, unsigned);
+  const std::vector<unsigned> &getIntersectingValues(FieldType, unsigned);
+  std::vector<std::vector<unsigned>> getInterchangeableValues(FieldType);
+  void orderInterchangeableValues(FieldType, std::vector<int> &);
+  std::vector<unsigned> getMaximalTimeUnits(FieldType);
 };
 
 #endif
@@ -25,52 +25,50 @@ enum class Day {
 /**
  * @brief      Class for a time unit.
  *
- * This can represent the hours and minutes as a time unit.
+ * This can represent the hours and minutes as a time unit. It is stored as
+ * the number of minutes elapsed since midnight.
  */
 class Time {
  private:
   /**
-   * The hours in the 24 hour format. Range should be 0-23.
+   * The minutes elapsed since midnight. Range should be 0-1439.
    */
-  unsigned hours;
-  /**
-   * The minutes. Range should be 0-59.
-   */
-  unsigned minutes;
+  unsigned minutesOfDay;
 
  public:
   Time(unsigned, unsigned);
   Time(std::string);
   Time &operator=(const Time &);
-  bool operator==(const Time &);
-  bool operator<(const Time &);
-  bool operator<=(const Time &);
-  bool operator>=(const Time &);
-  bool operator>(const Time &);
-  std::string getTimeString();
-  bool isMorningTime();
+  bool operator==(const Time &) const;
+  bool operator<(const Time &) const;
+  bool operator<=(const Time &) const;
+  bool operator>=(const Time &) const;
+  bool operator>(const Time &) const;
+  std::string getTimeString() const;
+  unsigned getMinutesOfDay() const;
+  bool isMorningTime() const;
 };
 
 /**
  * @brief      Class for a slot element.
  *
- * A slot element consists of a Day, a starting Time, and an ending Time.
+ * A slot element consists of a Day, a starting Time, and an ending Time. It is
+ * stored as the half-open interval [start, end) of minutes elapsed since the
+ * start of the week (Monday, 00:00).
  */
 class SlotElement {
  private:
   /**
-   * The start and end Time of the slot element
-   */
-  Time startTime, endTime;
-  /**
-   * The Day of the slot element
+   * The start and end of the slot element as minutes of the week
    */
-  Day day;
+  unsigned startMinute, endMinute;
 
  public:
   SlotElement(Time &, Time &, Day);
-  bool isIntersecting(SlotElement &other);
-  bool isMorningSlotElement();
+  bool isIntersecting(const SlotElement &other) const;
+  bool isMorningSlotElement() const;
+  unsigned getStartMinuteOfWeek() const;
+  unsigned getEndMinuteOfWeek() const;
 };
 
 /**
@@ -91,20 +89,26 @@ class Slot : public Field {
    */
   IsMinor isMinor;
   /**
-   * The slot elements that define this Slot
+   * The slot elements that define this Slot, sorted by their start
    */
   std::vector<SlotElement> slotElements;
+  /**
+   * Represents whether all the SlotElements are morning SlotElements
+   */
+  bool isMorning;
+  void updateSlotElements();
 
  public:
   Slot(std::string, IsMinor, std::vector<SlotElement>);
   bool operator==(const Slot &other);
-  bool isIntersecting(Slot &other);
+  bool isIntersecting(const Slot &other) const;
   void addSlotElements(SlotElement);
+  std::vector<SlotElement> getSlotElements();
   bool isMinorSlot();
   FieldType getType();
   std::string getTypeName();
   std::string getName();
-  bool isMorningSlot();
+  bool isMorningSlot() const;
 };
 
 #endif
\ No newline at end of file
@@ -26,6 +26,93 @@ enum PredefinedClauses {
   programAtMostOneOfCoreOrElective
 };
 
+/**
+ * @brief      Enum Class that represents the encodings available for the
+ * constraints that prevent two courses sharing a field value from being
+ * scheduled at an intersecting time.
+ */
+enum class ClashEncoding {
+  /**
+   * Every pair of courses is checked for an intersecting Segment and Slot
+   */
+  pairwise,
+  /**
+   * Every field value has at most one course in each atomic time unit
+   */
+  timeUnits
+};
+
+/**
+ * @brief      Enum Class that represents the encodings available for the
+ * auxiliary variables introduced by a disjunction of Clauses.
+ */
+enum class DisjunctionEncoding {
+  /**
+   * Every auxiliary variable is equivalent to the clauses it represents
+   */
+  equivalence,
+  /**
+   * Every auxiliary variable only implies the clauses it represents, and the
+   * converse is added only if the disjunction is negated
+   */
+  polarity
+};
+
+/**
+ * @brief      Enum Class that represents the encodings available for the
+ * constraint that at most one value of a FieldType is True for a Course.
+ */
+enum class AtMostOneEncoding {
+  /**
+   * The encoding is chosen depending on the number of field values
+   */
+  automatic,
+  /**
+   * A binary clause for every pair of field values, with no auxiliary
+   * variables
+   */
+  pairwise,
+  /**
+   * A sequential counter over the field values, with a linear number of
+   * clauses and auxiliary variables
+   */
+  sequential,
+  /**
+   * The field values are split into groups of three, each represented by a
+   * commander variable, and the encoding is applied recursively to the
+   * commander variables
+   */
+  commander,
+  /**
+   * The field values are split into pairs, and the index of the pair which
+   * has a True value is represented in binary using auxiliary variables
+   */
+  bimander
+};
+
+/**
+ * @brief      Enum for the kinds of neighbourhoods freed by the large
+ * neighbourhood search.
+ */
+enum NeighbourhoodType {
+  /**
+   * The courses of one program
+   */
+  programNeighbourhood,
+  /**
+   * The courses of one instructor
+   */
+  instructorNeighbourhood,
+  /**
+   * The courses scheduled on one day
+   */
+  dayNeighbourhood,
+  /**
+   * A random subset of the courses
+   */
+  randomNeighbourhood
+};
+
 /**
  * @brief      Class for global values.
  */
@@ -39,6 +126,71 @@ class Global {
    * The number of predefined clauses in the PredefinedClauses enumerator
    */
   static const int PREDEFINED_CLAUSES_COUNT = 12;
+  /**
+   * The largest number of field values for which the automatic at most one
+   * encoding uses the pairwise encoding
+   */
+  static const unsigned PAIRWISE_AT_MOST_ONE_LIMIT = 6;
+  /**
+   * The largest number of field values for which the automatic at most one
+   * encoding uses the sequential encoding, beyond which the bimander encoding
+   * is used
+   */
+  static const unsigned SEQUENTIAL_AT_MOST_ONE_LIMIT = 64;
+  /**
+   * The number of minutes in an hour
+   */
+  static const unsigned MINUTES_PER_HOUR = 60;
+  /**
+   * The number of minutes in a day
+   */
+  static const unsigned MINUTES_PER_DAY = 24 * MINUTES_PER_HOUR;
+  /**
+   * The minute of the day at which morning time ends, which is 13:00
+   */
+  static const unsigned MORNING_END_MINUTE = 13 * MINUTES_PER_HOUR;
+  /**
+   * The number of conflicts the solver spends looking for a model that agrees
+   * with a hint
+   */
+  static const int HINT_CONFLICT_BUDGET = 10000;
+  /**
+   * The number of kinds of neighbourhoods in the NeighbourhoodType enumerator
+   */
+  static const unsigned NEIGHBOURHOOD_TYPE_COUNT = 4;
+  /**
+   * The number of conflicts the solver spends on each neighbourhood of the
+   * large neighbourhood search
+   */
+  static const int LNS_CONFLICT_LIMIT = 10000;
+  /**
+   * The number of courses in a random neighbourhood
+   */
+  static const unsigned LNS_RANDOM_NEIGHBOURHOOD_SIZE = 30;
+  /**
+   * The number of neighbourhoods in a row without improvement after which a
+   * worker of the large neighbourhood search stops, if there is no time limit
+   */
+  static const unsigned LNS_STALL_LIMIT = 50;
+  /**
+   * The version of the format of the instance snapshots, which must be changed
+   * whenever the encoding or the stored data change
+   */
+  static const unsigned SNAPSHOT_VERSION = 5;
+  /**
+   * The number of parts of the formula encoded in parallel before they are
+   * merged into the formula, which bounds the clauses held apart from it
+   */
+  static const unsigned ENCODING_BATCH_SIZE = 256;
+  /**
+   * The number of buffers of each type kept for reuse on each thread
+   */
+  static const unsigned SPARE_BUFFER_COUNT = 64;
+  /**
+   * The largest capacity of a buffer that is kept for reuse, so that large
+   * buffers are not held
+   */
+  static const unsigned SPARE_BUFFER_LIMIT = 4096;
 };
 
 #endif
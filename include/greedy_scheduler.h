@@ -0,0 +1,55 @@
+/** @file */
+
+#ifndef GREEDY_SCHEDULER_H
+#define GREEDY_SCHEDULER_H
+
+#include <vector>
+#include "core/SolverTypes.h"
+#include "data.h"
+
+using namespace NSPACE;
+
+/**
+ * @brief      Class for a greedy scheduler that constructs a timetable
+ * quickly, without the solver.
+ *
+ * Slots are given to the Courses in the style of DSatur graph colouring. Two
+ * Courses are adjacent in the conflict graph if their Segments intersect and
+ * they have a common Instructor or a common core Program, and adjacent Courses
+ * must be held in Slots that do not intersect. The Course with the most Slots
+ * ruled out by its scheduled neighbours is scheduled next, and it is given the
+ * smallest free Classroom that is large enough for it. Custom constraints are
+ * not considered, so the timetable is used as a starting point for the solver.
+ */
+class GreedyScheduler {
+ private:
+  /**
+   * The data of the problem
+   */
+  Data &data;
+  /**
+   * Stores, for each Course, the Courses adjacent to it in the conflict graph
+   */
+  std::vector<std::vector<unsigned>> neighbours;
+  /**
+   * Stores the Slot given to each Course, -1 if it has none
+   */
+  std::vector<int> slots;
+  /**
+   * Stores the Classroom given to each Course, -1 if it has none
+   */
+  std::vector<int> classrooms;
+  void buildConflictGraph();
+  bool isAllowedSlot(unsigned, unsigned);
+  unsigned getSlotPenalty(unsigned, unsigned);
+  int findClassroom(unsigned, unsigned);
+  void assign(unsigned, unsigned, int,
+              std::vector<std::vector<bool>> &, std::vector<unsigned> &);
+
+ public:
+  GreedyScheduler(Data &);
+  unsigned schedule();
+  std::vector<std::vector<std::vector<lbool>>> getFieldValues();
+};
+
+#endif
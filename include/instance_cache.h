@@ -0,0 +1,91 @@
+/** @file */
+
+#ifndef INSTANCE_CACHE_H
+#define INSTANCE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "core/SolverTypes.h"
+#include "timetabler.h"
+
+using namespace NSPACE;
+
+/**
+ * @brief      Class for a cache of encoded instances.
+ *
+ * A snapshot stores Data and the encoded MaxSATFormula in a binary form,
+ * after the fields, the input and the custom constraints have been parsed and
+ * encoded. Snapshots are kept in a directory, named by a hash of the contents
+ * of the input files and of Global::SNAPSHOT_VERSION, so that a snapshot is
+ * only used while its inputs are unchanged. Loading a snapshot memory maps it,
+ * checks its length and checksum, and restores the state of the Timetabler,
+ * so the parsing and the encoding can be skipped. The data derived from the
+ * fields, such as the time units and the intersections, is computed again
+ * instead of being stored.
+ */
+class InstanceCache {
+ private:
+  /**
+   * A pointer to the Timetabler object
+   */
+  Timetabler *timetabler;
+  /**
+   * The path of the snapshot of the input files
+   */
+  std::string snapshotFile;
+  /**
+   * The hash of the contents of the input files
+   */
+  uint64_t key;
+  /**
+   * The snapshot being written
+   */
+  std::string buffer;
+  /**
+   * The position up to which the snapshot being read has been read
+   */
+  const char *cursor;
+  /**
+   * The end of the snapshot being read
+   */
+  const char *end;
+  /**
+   * Whether the snapshot being read ended early
+   */
+  bool truncated;
+  void putBytes(const void *, size_t);
+  void getBytes(void *, size_t);
+  template <typename T>
+  void put(const T &);
+  void put(const std::string &);
+  void put(const lbool &);
+  void put(const std::set<unsigned> &);
+  void put(const std::map<int, unsigned> &);
+  template <typename T>
+  void put(const std::vector<T> &);
+  template <typename T>
+  void get(T &);
+  void get(std::string &);
+  void get(lbool &);
+  void get(std::set<unsigned> &);
+  void get(std::map<int, unsigned> &);
+  template <typename T>
+  void get(std::vector<T> &);
+  size_t getSize();
+  void putData();
+  void getData();
+  void putFormula();
+  void getFormula();
+
+ public:
+  InstanceCache(Timetabler *, std::string, const std::vector<std::string> &);
+  bool load();
+  void save();
+  std::string getSnapshotFile();
+};
+
+#endif
@@ -0,0 +1,95 @@
+/** @file */
+
+#ifndef NEIGHBOURHOOD_SEARCH_H
+#define NEIGHBOURHOOD_SEARCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "MaxSATFormula.h"
+#include "core/SolverTypes.h"
+#include "data.h"
+#include "global.h"
+#include "search_progress.h"
+#include "tsolver.h"
+
+using namespace NSPACE;
+
+/**
+ * @brief      Class for a large neighbourhood search, which improves a model
+ * of the formula instead of solving it to optimality.
+ *
+ * Each worker has its own incremental session on a copy of the formula. It
+ * repeatedly frees a neighbourhood of Courses, assumes the field values of the
+ * best model for all the other Courses, and solves again within a small
+ * conflict limit. A better model found by any worker becomes the best model
+ * for all of them.
+ */
+class NeighbourhoodSearch {
+ private:
+  /**
+   * The data of the problem
+   */
+  Data &data;
+  /**
+   * The formula, which is not changed by the search
+   */
+  MaxSATFormula *formula;
+  /**
+   * The workers, one for each thread
+   */
+  std::vector<TSolver *> workers;
+  /**
+   * The literals of the hint, used for the first model
+   */
+  std::vector<Lit> hintLits;
+  /**
+   * Whether the search is limited by the deadline
+   */
+  bool timed;
+  /**
+   * The time at which the search is stopped, if it is timed
+   */
+  std::chrono::steady_clock::time_point deadline;
+  /**
+   * The function called when a better model is found, if any
+   */
+  ProgressCallback progressCallback;
+  /**
+   * The best model found
+   */
+  std::vector<lbool> model;
+  /**
+   * The cost of the best model
+   */
+  uint64_t cost;
+  /**
+   * The lower bound proved on the optimal cost
+   */
+  uint64_t lowerBound;
+  /**
+   * Whether the best model was proved to be optimal
+   */
+  bool optimal;
+  bool isPastDeadline();
+  std::vector<bool> getNeighbourhood(NeighbourhoodType, std::mt19937 &,
+                                     const std::vector<lbool> &);
+  std::vector<Lit> getFixedCourseLits(const std::vector<lbool> &,
+                                      const std::vector<bool> &);
+
+ public:
+  NeighbourhoodSearch(Data &, MaxSATFormula *, unsigned);
+  ~NeighbourhoodSearch();
+  const std::vector<TSolver *> &getWorkers();
+  void setHint(const std::vector<Lit> &);
+  void setDeadline(std::chrono::steady_clock::time_point);
+  void setProgressCallback(ProgressCallback);
+  void search();
+  std::vector<lbool> getModel();
+  uint64_t getCost();
+  uint64_t getLowerBound();
+  bool isOptimal();
+};
+
+#endif
@@ -5,7 +5,8 @@
 
 #include <yaml-cpp/yaml.h>
 #include <string>
-#include "CSVparser.hpp"
+#include <tuple>
+#include <vector>
 #include "data.h"
 #include "timetabler.h"
 
@@ -21,12 +22,22 @@ class Parser {
    */
   Timetabler *timetabler;
   Day getDayFromString(std::string);
+  ClashEncoding getClashEncodingFromString(std::string);
+  AtMostOneEncoding getAtMostOneEncodingFromString(std::string);
+  DisjunctionEncoding getDisjunctionEncodingFromString(std::string);
+  Var getFieldValueVar(unsigned, FieldType, unsigned);
+  std::vector<lbool> getHintValues(FieldType, std::string);
+  std::string parseInputFile(std::string, std::vector<Course> &,
+                             std::vector<std::vector<std::vector<lbool>>> &);
 
  public:
   Parser(Timetabler *);
   void parseFields(std::string file);
   void parseInput(std::string file);
+  void parseInput(const std::vector<std::string> &files);
+  void parseHint(std::string file);
   void addVars();
+  std::vector<std::tuple<unsigned, unsigned, unsigned>> findClashes(FieldType);
   bool verify();
 };
 
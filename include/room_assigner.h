@@ -0,0 +1,56 @@
+/** @file */
+
+#ifndef ROOM_ASSIGNER_H
+#define ROOM_ASSIGNER_H
+
+#include <vector>
+#include "data.h"
+
+/**
+ * @brief      Class for a room assigner that gives Classrooms to Courses whose
+ * Slots and Segments are already chosen.
+ *
+ * The Courses are taken in blocks of Courses with the same Slot and Segment,
+ * largest Courses first, and each block is matched to the Classrooms that are
+ * large enough and not used at an intersecting time by an earlier block, with
+ * the Hopcroft-Karp algorithm. Classrooms named in custom constraints are
+ * only given to the Courses that already had them, so that the custom
+ * constraints are not affected.
+ */
+class RoomAssigner {
+ private:
+  /**
+   * The data of the problem
+   */
+  Data &data;
+  /**
+   * Stores the Slot of each Course
+   */
+  std::vector<int> slots;
+  /**
+   * Stores the Segment of each Course
+   */
+  std::vector<int> segments;
+  /**
+   * Stores the Classroom each Course had before the assignment, -1 if it had
+   * none
+   */
+  std::vector<int> preferredRooms;
+  /**
+   * Stores the Classroom given to each Course, -1 if it has none
+   */
+  std::vector<int> rooms;
+  std::vector<unsigned> getAllowedRooms(unsigned);
+  bool matchBlock(const std::vector<unsigned> &);
+  bool findAugmentingPath(unsigned, const std::vector<std::vector<unsigned>> &,
+                          std::vector<int> &, std::vector<int> &,
+                          std::vector<unsigned> &);
+
+ public:
+  RoomAssigner(Data &, const std::vector<int> &, const std::vector<int> &,
+               const std::vector<int> &);
+  bool assign();
+  std::vector<int> getRooms();
+};
+
+#endif
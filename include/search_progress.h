@@ -0,0 +1,94 @@
+/** @file */
+
+#ifndef SEARCH_PROGRESS_H
+#define SEARCH_PROGRESS_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * @brief      Enum for the kinds of events reported during the search.
+ */
+enum class ProgressEventType {
+  /**
+   * The SAT solver was built and the search started
+   */
+  Started,
+  /**
+   * A model with a lower cost was found
+   */
+  UpperBound,
+  /**
+   * A core was found, which increased the lower bound
+   */
+  LowerBound,
+  /**
+   * The search ended after proving its result
+   */
+  Completed,
+  /**
+   * The search was stopped by an interrupt or a limit before proving its
+   * result
+   */
+  Stopped
+};
+
+/**
+ * @brief      Class for a snapshot of the state of the search, reported when
+ * an event occurs.
+ */
+class SearchProgress {
+ public:
+  /**
+   * The event that caused the report
+   */
+  ProgressEventType type;
+  /**
+   * The index of the solver configuration that reported the event
+   */
+  unsigned configuration;
+  /**
+   * The number of seconds since the search started
+   */
+  double elapsedSeconds;
+  /**
+   * The cost of the best model found, valid if modelCount is not zero
+   */
+  uint64_t upperBound;
+  /**
+   * The lower bound proved on the optimal cost
+   */
+  uint64_t lowerBound;
+  /**
+   * The number of literals in the last core found
+   */
+  unsigned coreSize;
+  /**
+   * The number of cores found
+   */
+  int coreCount;
+  /**
+   * The number of models found
+   */
+  int modelCount;
+  /**
+   * The number of variables in the SAT solver
+   */
+  int variableCount;
+  /**
+   * The number of clauses in the SAT solver
+   */
+  int clauseCount;
+
+  SearchProgress();
+  std::string getEventName() const;
+  std::string toJson() const;
+};
+
+/**
+ * Function called with each progress report of the search
+ */
+typedef std::function<void(const SearchProgress &)> ProgressCallback;
+
+#endif
@@ -3,12 +3,22 @@
 #ifndef TIMETABLER_H
 #define TIMETABLER_H
 
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
 #include <vector>
 #include "MaxSATFormula.h"
 #include "cclause.h"
+#include "clause_arena.h"
 #include "core/SolverTypes.h"
 #include "data.h"
+#include "global.h"
 #include "mtl/Vec.h"
+#include "search_progress.h"
 #include "tsolver.h"
 
 using namespace NSPACE;
@@ -47,6 +57,11 @@ class Timetabler {
    * A pointer to the MaxSAT solver object
    */
   TSolver *solver;
+  /**
+   * The solver of the incremental session, or NULL if no session has been
+   * started. It owns its copy of the formula
+   */
+  TSolver *sessionSolver;
   /**
    * A pointer to the MaxSAT formula object
    */
@@ -55,6 +70,132 @@ class Timetabler {
    * Stores the values of each solver variable to be checked after solving
    */
   std::vector<lbool> model;
+  /**
+   * A buffer reused for passing clauses to the formula
+   */
+  vec<Lit> clauseBuffer;
+  /**
+   * The number of threads used for solving, each running a different
+   * configuration of the solver, and for encoding
+   */
+  unsigned threadCount;
+  /**
+   * The number of seconds after which the search is stopped, or 0 if the time
+   * is not limited
+   */
+  double timeLimit;
+  /**
+   * The time at which every phase of the current search is stopped, if the
+   * time is limited. It is set once at the start of solve() or resolve(), so
+   * that all the phases share the time limit
+   */
+  std::chrono::steady_clock::time_point deadline;
+  /**
+   * The number of conflicts after which the search of each solver is stopped,
+   * or 0 if the number of conflicts is not limited
+   */
+  uint64_t conflictLimit;
+  /**
+   * Whether the model was proved to be optimal
+   */
+  bool optimal;
+  /**
+   * The cost of the model, which is the sum of the weights of the unsatisfied
+   * soft clauses
+   */
+  uint64_t cost;
+  /**
+   * The lower bound proved on the optimal cost
+   */
+  uint64_t lowerBound;
+  /**
+   * Whether the search has finished, checked by the timer thread
+   */
+  bool searchFinished;
+  /**
+   * Guards searchFinished
+   */
+  std::mutex timerMutex;
+  /**
+   * Used to wake up the timer thread when the search finishes
+   */
+  std::condition_variable timerCondition;
+  /**
+   * The function called with the progress reports of the solvers, if any
+   */
+  ProgressCallback progressCallback;
+  /**
+   * Ensures that progressCallback is called by one solver thread at a time
+   */
+  std::mutex progressMutex;
+  /**
+   * The weight of each soft clause of the formula in the incremental session
+   */
+  std::vector<uint64_t> sessionWeights;
+  /**
+   * The index of the unit soft clause of each variable that has one, used to
+   * change the weights of constraints in the session
+   */
+  std::map<Var, unsigned> unitSoftClauses;
+  /**
+   * The values assumed for constraint variables in the incremental session
+   */
+  std::map<Var, bool> sessionAssumptions;
+  /**
+   * The values assumed for field values in the incremental session, by
+   * (course, field type, index of the field value). They are kept apart from
+   * the variables since fixed field values share trueVar and falseVar
+   */
+  std::map<std::tuple<int, FieldType, unsigned>, bool> fieldValueAssumptions;
+  /**
+   * Whether each variable is a Classroom or Slot of a class of
+   * interchangeable values, for which the symmetry breaking clauses are
+   * released in the session
+   */
+  std::vector<bool> interchangeableVars;
+  /**
+   * Whether a session clause has released the symmetry breaking clauses for
+   * the rest of the session
+   */
+  bool symmetryReleased;
+  /**
+   * Whether independent components of the formula are solved separately
+   */
+  bool decomposition;
+  /**
+   * Whether the model is improved by a large neighbourhood search
+   */
+  bool lns;
+  /**
+   * Whether a greedy timetable is used as the hint if none is given
+   */
+  bool greedyStart;
+  /**
+   * Whether the hint was made by the greedy scheduler
+   */
+  bool greedyHint;
+  /**
+   * Whether the model is the greedy timetable, used because the search found
+   * no model
+   */
+  bool greedyModel;
+  unsigned solvePortfolio(const std::vector<TSolver *> &);
+  void startDeadline();
+  bool isPastDeadline();
+  std::thread startTimer(const std::vector<TSolver *> &);
+  void stopTimer(std::thread &);
+  SolverStatus getModelStatus();
+  void configureSolver(TSolver *);
+  std::vector<Lit> getHintLits();
+  bool solveComponents();
+  void solveFormula();
+  void solveLns();
+  void scheduleGreedily();
+  void useGreedyModel();
+  void assignRooms();
+  void setSessionWeight(Var, int);
+  bool getAssumptionLits(std::vector<Lit> &);
+  bool isInterchangeableLit(Lit);
 
  public:
   /**
@@ -69,8 +210,26 @@ class Timetabler {
   bool checkAllTrue(const std::vector<std::vector<Var>> &);
   bool isVarTrue(const Var &);
   SolverStatus solve();
+  void setThreadCount(unsigned);
+  void setSearchLimits(double, uint64_t);
+  void setProgressCallback(ProgressCallback);
+  void setDecomposition(bool);
+  void setLns(bool);
+  void setGreedyStart(bool);
+  void startSession();
+  void setFieldValueAssumption(int, FieldType, unsigned, lbool);
+  void clearAssumptions();
+  void setConstraintWeight(PredefinedClauses, int, int);
+  void setCustomConstraintWeight(unsigned, int);
+  void addSessionClauses(const Clauses &);
+  SolverStatus resolve();
+  bool isOptimal();
+  uint64_t getCost();
+  uint64_t getLowerBound();
   Var newVar();
   Lit newLiteral(bool sign = false);
+  int getVarCount();
+  void encodeInParallel(unsigned, const std::function<void(unsigned)> &);
   void printResult(SolverStatus);
   void displayTimeTable();
   void displayUnsatisfiedOutputReasons();
@@ -81,7 +240,9 @@ class Timetabler {
   void addExistingAssignments();
   void addToFormula(vec<Lit> &, int);
   void addToFormula(Lit, int);
+  void addToFormula(const ClauseSpan &, int);
   void displayChangesInGivenAssignment();
+  MaxSATFormula *getFormula();
 };
 
 #endif
@@ -3,10 +3,14 @@
 #ifndef TSOLVER_H
 #define TSOLVER_H
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include <vector>
 #include "MaxSAT.h"
 #include "algorithms/Alg_OLL.h"
 #include "mtl/Vec.h"
+#include "search_progress.h"
 
 using namespace NSPACE;
 using namespace openwbo;
@@ -20,13 +24,113 @@ using namespace openwbo;
  * identical. The differences are that tSearch() does not print
  * the output to stdout and exit, instead, it returns the model.
  * tWeighted() also does not print to stdout, when the solver
- * terminates, it simply returns.
+ * terminates, it simply returns. The search can be interrupted from another
+ * thread, and the configuration of the search can be varied, so that several
+ * TSolver objects can be run as a portfolio. The search can also be limited to
+ * a number of conflicts, after which the best model found so far is returned,
+ * along with its cost and the lower bound proved on the optimal cost. The
+ * progress of the search can be followed through a callback.
+ *
+ * After startSession(), the SAT solver is kept between searches, so that the
+ * problem can be solved again with different assumptions and soft clause
+ * weights by tResolve(), reusing the clauses learnt by the earlier searches.
  */
 class TSolver : public OLL {
+ private:
+  /**
+   * Whether the search has been asked to stop
+   */
+  std::atomic<bool> interruptRequested;
+  /**
+   * Guards the SAT solver pointer against interrupts from other threads
+   */
+  std::mutex solverMutex;
+  /**
+   * Whether the last search ran until the result was proved, instead of
+   * being interrupted
+   */
+  bool searchCompleted;
+  /**
+   * The random seed given to the SAT solver
+   */
+  double randomSeed;
+  /**
+   * The frequency with which the SAT solver picks a random decision variable
+   */
+  double randomVarFreq;
+  /**
+   * Whether the soft clauses are considered in decreasing order of weight,
+   * instead of all at once
+   */
+  bool stratification;
+  /**
+   * The number of conflicts after which the search is stopped, or 0 if the
+   * number of conflicts is not limited
+   */
+  uint64_t conflictLimit;
+  /**
+   * The index of the configuration set by setConfiguration()
+   */
+  unsigned configuration;
+  /**
+   * The function called when a progress event occurs, if any
+   */
+  ProgressCallback progressCallback;
+  /**
+   * The time at which the last search started
+   */
+  std::chrono::steady_clock::time_point searchStartTime;
+  /**
+   * The number of literals in the last core found
+   */
+  unsigned lastCoreSize;
+  /**
+   * The number of conflicts of the SAT solver when the last search started
+   */
+  uint64_t conflictsAtStart;
+  /**
+   * The formula loaded when the incremental session started, or NULL if no
+   * session was started
+   */
+  MaxSATFormula *sessionFormula;
+  /**
+   * Literals assumed in every call to the SAT solver during the search
+   */
+  vec<Lit> fixedAssumptions;
+  /**
+   * A literal that guards the clauses learnt from the cores of the current
+   * incremental search, or lit_Undef if the search is not incremental
+   */
+  Lit searchGuard;
+  /**
+   * The literals of a previous solution used to guide the search
+   */
+  std::vector<Lit> hint;
+  /**
+   * Whether a model was found from the hint in the last search
+   */
+  bool hintModelFound;
+  void reportProgress(ProgressEventType);
+  lbool searchWithFixedAssumptions(vec<Lit> &);
+  void searchFromHint();
+
  public:
   TSolver(int verb = _VERBOSITY_MINIMAL_, int enc = _CARD_TOTALIZER_);
   std::vector<lbool> tSearch();
   void tWeighted();
+  void setConfiguration(unsigned);
+  void interrupt();
+  bool isSearchCompleted();
+  void setConflictLimit(uint64_t);
+  bool hasModel();
+  uint64_t getUpperBound();
+  uint64_t getLowerBound();
+  void setProgressCallback(ProgressCallback);
+  void setHint(const std::vector<Lit> &);
+  void startSession();
+  std::vector<lbool> tResolve(const std::vector<Lit> &,
+                              const std::vector<uint64_t> &);
+  void addSessionClause(vec<Lit> &);
 };
 
 #endif
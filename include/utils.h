@@ -3,15 +3,18 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <cstdint>
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <vector>
+#include "MaxSATFormula.h"
 #include "data.h"
 #include "global.h"
 #include "mtl/Vec.h"
 
 using namespace NSPACE;
+using namespace openwbo;
 
 namespace Utils {
 
@@ -118,6 +121,10 @@ std::string getPredefinedConstraintName(const PredefinedClauses clauseType);
 
 std::string getFieldName(FieldType fieldType, int index, Data &data);
 
+unsigned getFieldValueCount(FieldType fieldType, Data &data);
+
+uint64_t computeCost(MaxSATFormula *formula, const std::vector<lbool> &model);
+
 /**
  * @brief      Specify severity levels for logging
  */
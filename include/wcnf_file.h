@@ -0,0 +1,51 @@
+/** @file */
+
+#ifndef WCNF_FILE_H
+#define WCNF_FILE_H
+
+#include <string>
+#include <vector>
+#include "core/SolverTypes.h"
+#include "timetabler.h"
+
+using namespace NSPACE;
+
+/**
+ * @brief      Class for writing the encoded formula in the WCNF format, and
+ * reading it back.
+ *
+ * The formula is written as it is given to the solver, in the classic WCNF
+ * format, where hard clauses have the top weight. A variable map is written
+ * next to it, in the file with ".map" appended to its name. The map gives the
+ * variable of each (Course, FieldType, field value), the high level variables
+ * and the constraint variables, and the names of the Courses and field values.
+ * Reading the two files back restores the formula and the variables in Data,
+ * without parsing the fields, the input and the custom constraints, so that
+ * the formula can be solved and its model decoded by name.
+ */
+class WcnfFile {
+ private:
+  /**
+   * A pointer to the Timetabler object
+   */
+  Timetabler *timetabler;
+  /**
+   * Stores the name of each Course
+   */
+  std::vector<std::string> courseNames;
+  /**
+   * Stores the names of the field values of each FieldType
+   */
+  std::vector<std::vector<std::string>> valueNames;
+  void writeMap(std::string);
+  void readMap(std::string);
+  Var readVar(std::istream &);
+
+ public:
+  WcnfFile(Timetabler *);
+  void write(std::string);
+  void read(std::string);
+  void writeAssignment(std::string);
+};
+
+#endif
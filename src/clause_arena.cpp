@@ -0,0 +1,194 @@
+#include "clause_arena.h"
+
+#include <utility>
+#include <vector>
+#include "core/SolverTypes.h"
+
+using namespace NSPACE;
+
+/**
+ * @brief      Constructs the ClauseArena object, with no clauses in it.
+ */
+ClauseArena::ClauseArena() {}
+
+/**
+ * @brief      Constructs the ClauseArena object, with the clauses of another
+ * arena.
+ *
+ * @param[in]  other  The other arena
+ */
+ClauseArena::ClauseArena(const ClauseArena &other) { addClauses(other); }
+
+/**
+ * @brief      Constructs the ClauseArena object, taking over the buffers of
+ * another arena.
+ *
+ * @param      other  The other arena, which is left with no clauses
+ */
+ClauseArena::ClauseArena(ClauseArena &&other)
+    : lits(std::move(other.lits)), headers(std::move(other.headers)) {}
+
+/**
+ * @brief      Destroys the ClauseArena object, keeping its buffers for reuse.
+ */
+ClauseArena::~ClauseArena() {
+  SpareBuffers<Lit>::release(lits);
+  SpareBuffers<std::pair<unsigned, unsigned>>::release(headers);
+}
+
+/**
+ * @brief      Replaces the clauses with those of another arena.
+ *
+ * @param[in]  other  The other arena
+ *
+ * @return     This arena
+ */
+ClauseArena &ClauseArena::operator=(const ClauseArena &other) {
+  if (this != &other) {
+    clear();
+    addClauses(other);
+  }
+  return *this;
+}
+
+/**
+ * @brief      Replaces the clauses with those of another arena, taking over
+ * its buffers.
+ *
+ * @param      other  The other arena, which is left with no clauses
+ *
+ * @return     This arena
+ */
+ClauseArena &ClauseArena::operator=(ClauseArena &&other) {
+  if (this != &other) {
+    SpareBuffers<Lit>::release(lits);
+    SpareBuffers<std::pair<unsigned, unsigned>>::release(headers);
+    lits = std::move(other.lits);
+    headers = std::move(other.headers);
+    other.lits.clear();
+    other.headers.clear();
+  }
+  return *this;
+}
+
+/**
+ * @brief      Takes spare buffers for an arena that has none.
+ */
+void ClauseArena::takeSpareBuffers() {
+  SpareBuffers<Lit>::take(lits);
+  SpareBuffers<std::pair<unsigned, unsigned>>::take(headers);
+}
+
+/**
+ * @brief      Gets the number of clauses.
+ *
+ * @return     The number of clauses
+ */
+unsigned ClauseArena::size() const { return headers.size(); }
+
+/**
+ * @brief      Gets the total number of literals in all the clauses.
+ *
+ * @return     The number of literals
+ */
+unsigned ClauseArena::litCount() const { return lits.size(); }
+
+/**
+ * @brief      Gets a view of a clause.
+ *
+ * @param[in]  index  The index of the clause
+ *
+ * @return     A ClauseSpan of the literals of the clause
+ */
+ClauseSpan ClauseArena::operator[](unsigned index) const {
+  return ClauseSpan(lits.data() + headers[index].first, headers[index].second);
+}
+
+/**
+ * @brief      Adds a clause to the end of the arena.
+ *
+ * @param[in]  clauseLits  A pointer to the literals of the clause
+ * @param[in]  length      The number of literals
+ */
+void ClauseArena::addClause(const Lit *clauseLits, unsigned length) {
+  takeSpareBuffers();
+  headers.push_back(std::make_pair(lits.size(), length));
+  lits.insert(lits.end(), clauseLits, clauseLits + length);
+}
+
+/**
+ * @brief      Adds a clause to the end of the arena.
+ *
+ * The span must not be a view of this arena, since adding the clause may move
+ * the literals.
+ *
+ * @param[in]  clause  The clause
+ */
+void ClauseArena::addClause(const ClauseSpan &clause) {
+  addClause(clause.begin(), clause.size());
+}
+
+/**
+ * @brief      Adds a clause to the end of the arena.
+ *
+ * @param[in]  clauseLits  The literals of the clause
+ */
+void ClauseArena::addClause(const std::vector<Lit> &clauseLits) {
+  addClause(clauseLits.data(), clauseLits.size());
+}
+
+/**
+ * @brief      Adds all the clauses of another arena to the end of this arena.
+ *
+ * @param[in]  other  The other arena
+ */
+void ClauseArena::addClauses(const ClauseArena &other) {
+  addClauses(other, 0, other.size());
+}
+
+/**
+ * @brief      Adds a range of consecutive clauses of another arena to the end
+ * of this arena.
+ *
+ * @param[in]  other  The other arena, which must not be this arena
+ * @param[in]  first  The index of the first clause to add
+ * @param[in]  count  The number of clauses to add
+ */
+void ClauseArena::addClauses(const ClauseArena &other, unsigned first,
+                             unsigned count) {
+  if (count == 0) {
+    return;
+  }
+  takeSpareBuffers();
+  unsigned litStart = other.headers[first].first;
+  unsigned litEnd = other.headers[first + count - 1].first +
+                    other.headers[first + count - 1].second;
+  unsigned shift = lits.size();
+  lits.insert(lits.end(), other.lits.begin() + litStart,
+              other.lits.begin() + litEnd);
+  for (unsigned i = first; i < first + count; i++) {
+    headers.push_back(std::make_pair(other.headers[i].first - litStart + shift,
+                                     other.headers[i].second));
+  }
+}
+
+/**
+ * @brief      Reserves space so that clauses can be added without growing the
+ * buffers.
+ *
+ * @param[in]  clauseCount  The total number of clauses to reserve space for
+ * @param[in]  litCount     The total number of literals to reserve space for
+ */
+void ClauseArena::reserve(unsigned clauseCount, unsigned litCount) {
+  takeSpareBuffers();
+  headers.reserve(clauseCount);
+  lits.reserve(litCount);
+}
+
+/**
+ * @brief      Removes all the clauses, keeping the allocated space.
+ */
+void ClauseArena::clear() {
+  lits.clear();
+  headers.clear();
+}
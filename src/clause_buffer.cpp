@@ -0,0 +1,76 @@
+#include "clause_buffer.h"
+
+#include <vector>
+#include "MaxSATFormula.h"
+#include "clause_arena.h"
+#include "core/SolverTypes.h"
+#include "mtl/Vec.h"
+
+using namespace NSPACE;
+using namespace openwbo;
+
+/**
+ * @brief      Constructs the ClauseBuffer object.
+ *
+ * @param[in]  firstVar  The first variable of the part, which is the number of
+ *                       variables of the formula when the part is started
+ */
+ClauseBuffer::ClauseBuffer(Var firstVar) : firstVar(firstVar), varCount(0) {}
+
+/**
+ * @brief      Creates a variable for the part.
+ *
+ * @return     The variable, numbered from the first variable of the part
+ */
+Var ClauseBuffer::newVar() { return firstVar + varCount++; }
+
+/**
+ * @brief      Gets the number of variables of the formula and the part, as if
+ * the part had been added to the formula.
+ *
+ * @return     The number of variables
+ */
+int ClauseBuffer::getVarCount() { return firstVar + varCount; }
+
+/**
+ * @brief      Adds a clause to the part. Clauses with a zero weight are left
+ * out, as they are by Timetabler::addToFormula.
+ *
+ * @param[in]  clause  The clause
+ * @param[in]  weight  The weight, negative for hard clauses
+ */
+void ClauseBuffer::addClause(const ClauseSpan &clause, int weight) {
+  if (weight == 0) {
+    return;
+  }
+  clauses.addClause(clause);
+  weights.push_back(weight);
+}
+
+/**
+ * @brief      Adds the variables and the clauses of the part to a formula.
+ *
+ * The variables of the part are renumbered to follow the variables of the
+ * formula, which may have grown since the part was started.
+ *
+ * @param      formula  The formula
+ */
+void ClauseBuffer::mergeInto(MaxSATFormula *formula) {
+  Var offset = formula->nVars() - firstVar;
+  for (int i = 0; i < varCount; i++) {
+    formula->newVar();
+  }
+  vec<Lit> clause;
+  for (unsigned i = 0; i < clauses.size(); i++) {
+    clause.clear();
+    for (Lit lit : clauses[i]) {
+      clause.push(var(lit) < firstVar ? lit
+                                      : mkLit(var(lit) + offset, sign(lit)));
+    }
+    if (weights[i] < 0) {
+      formula->addHardClause(clause);
+    } else {
+      formula->addSoftClause(weights[i], clause);
+    }
+  }
+}
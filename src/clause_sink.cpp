@@ -0,0 +1,67 @@
+#include "clause_sink.h"
+
+#include "clause_arena.h"
+#include "clauses.h"
+#include "core/SolverTypes.h"
+#include "mtl/Vec.h"
+#include "timetabler.h"
+
+using namespace NSPACE;
+
+/**
+ * @brief      Writes all the clauses of a Clauses object to the sink.
+ *
+ * @param[in]  clauses  The clauses
+ */
+void ClauseSink::addClauses(const Clauses &clauses) {
+  for (unsigned i = 0; i < clauses.size(); i++) {
+    addClause(clauses.getClause(i));
+  }
+}
+
+/**
+ * @brief      Constructs the FormulaClauseSink object, without a guard
+ * literal.
+ *
+ * @param      timetabler  The Timetabler to whose formula clauses are added
+ * @param[in]  weight      The weight of the clauses, negative for hard clauses
+ */
+FormulaClauseSink::FormulaClauseSink(Timetabler *timetabler, int weight) {
+  this->timetabler = timetabler;
+  this->weight = weight;
+  guarded = false;
+}
+
+/**
+ * @brief      Constructs the FormulaClauseSink object, with a guard literal.
+ *
+ * @param      timetabler  The Timetabler to whose formula clauses are added
+ * @param[in]  guard       The guard literal which implies every clause
+ * @param[in]  weight      The weight of the clauses, negative for hard clauses
+ */
+FormulaClauseSink::FormulaClauseSink(Timetabler *timetabler, Lit guard,
+                                     int weight) {
+  this->timetabler = timetabler;
+  this->weight = weight;
+  negatedGuard = ~guard;
+  guarded = true;
+}
+
+/**
+ * @brief      Adds a clause to the formula, with the negation of the guard
+ * literal prepended to it if a guard is set.
+ *
+ * @param[in]  clause  The clause
+ */
+void FormulaClauseSink::addClause(const ClauseSpan &clause) {
+  // a buffer reused for building the guarded clauses, one for each thread
+  static thread_local vec<Lit> buffer;
+  buffer.clear();
+  if (guarded) {
+    buffer.push(negatedGuard);
+  }
+  for (Lit lit : clause) {
+    buffer.push(lit);
+  }
+  timetabler->addToFormula(buffer, weight);
+}
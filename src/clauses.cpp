@@ -1,6 +1,7 @@
 #include "clauses.h"
 
 #include <iostream>
+#include <utility>
 #include <vector>
 #include "cclause.h"
 #include "core/SolverTypes.h"
@@ -14,19 +15,14 @@ using namespace NSPACE;
  *
  * @param[in]  clauses  The clauses in the set of clauses
  */
-Clauses::Clauses(const std::vector<CClause> &clauses) {
-  this->clauses = clauses;
-}
+Clauses::Clauses(const std::vector<CClause> &clauses) { addClauses(clauses); }
 
 /**
  * @brief      Constructs the Clauses object.
  *
  * @param[in]  clause  A single clause that forms the set of clauses
  */
-Clauses::Clauses(const CClause &clause) {
-  clauses.clear();
-  clauses.push_back(clause);
-}
+Clauses::Clauses(const CClause &clause) { clauses.addClause(clause.getLits()); }
 
 /**
  * @brief      Constructs the Clauses object.
@@ -34,11 +30,7 @@ Clauses::Clauses(const CClause &clause) {
  * @param[in]  lit   A single literal, a Lit, that is converted
  *                   to a unit clause and forms the set of clauses
  */
-Clauses::Clauses(const Lit &lit) {
-  clauses.clear();
-  CClause clause(lit);
-  clauses.push_back(clause);
-}
+Clauses::Clauses(const Lit &lit) { clauses.addClause(&lit, 1); }
 
 /**
  * @brief      Constructs the Clauses object.
@@ -49,35 +41,59 @@ Clauses::Clauses(const Lit &lit) {
  *                   the set of clauses
  */
 Clauses::Clauses(const Var &var) {
-  clauses.clear();
-  CClause clause(var);
-  clauses.push_back(clause);
+  Lit lit = mkLit(var, false);
+  clauses.addClause(&lit, 1);
 }
 
 /**
  * @brief      Constructs the Clauses object, with no clauses in it
  */
-Clauses::Clauses() { clauses.clear(); }
+Clauses::Clauses() {}
+
+/**
+ * @brief      Destroys the Clauses object, keeping the buffer of the negative
+ * definitions for reuse.
+ */
+Clauses::~Clauses() {
+  SpareBuffers<std::pair<Lit, unsigned>>::release(negativeDefinitionLits);
+}
+
+/**
+ * @brief      Gets the negation of a clause, which is a set of unit clauses.
+ *
+ * @param[in]  clause  The clause
+ *
+ * @return     The negation of the clause
+ */
+static Clauses negation(const ClauseSpan &clause) {
+  Clauses result;
+  for (Lit lit : clause) {
+    Lit negated = ~lit;
+    result.addClauses(ClauseSpan(&negated, 1));
+  }
+  return result;
+}
 
 /**
  * @brief      Defines the negation operation on a set of clauses.
  *
  * The negation of a set of clauses ((a1 OR a2) AND (b1 OR b2)) is defined
  * as ((~a1 AND ~a2) OR (~b1 AND ~b2)). The OR operation defined in this
- * class is then used to convert the Clauses to CNF form.
+ * class is then used to convert the Clauses to CNF form. Any auxiliary
+ * variables in these clauses now occur negatively, so the definitions they
+ * need for that are added to the solver first.
  *
  * @return     The result of the negation operation on the set of clauses
  */
 Clauses Clauses::operator~() {
+  addNegativeDefinitions();
   if (clauses.size() == 0) {
     CClause clause;
     return Clauses(clause);
   }
-  Clauses negationClause(~(clauses[0]));
+  Clauses negationClause = negation(clauses[0]);
   for (unsigned i = 1; i < clauses.size(); i++) {
-    std::vector<CClause> negationClauseVector = ~(clauses[i]);
-    Clauses negationThisClause(negationClauseVector);
-    negationClause = (negationClause | negationThisClause);
+    negationClause = (negationClause | negation(clauses[i]));
   }
   return negationClause;
 }
@@ -96,11 +112,8 @@ Clauses Clauses::operator~() {
  * @return     A Clauses object with the result of the AND operation
  */
 Clauses Clauses::operator&(const Clauses &other) {
-  std::vector<CClause> thisClauses = clauses;
-  std::vector<CClause> otherClauses = other.clauses;
-  thisClauses.insert(std::end(thisClauses), std::begin(otherClauses),
-                     std::end(otherClauses));
-  Clauses result(thisClauses);
+  Clauses result(*this);
+  result.addClauses(other);
   return result;
 }
 
@@ -142,12 +155,21 @@ Clauses Clauses::operator&(const CClause &other) {
  * # Return the following as soft clause
  * x | y
  *
+ * With DisjunctionEncoding::polarity, only the implications from the
+ * auxiliary variables to the clauses they represent are added, which is
+ * sufficient while x and y occur only positively, as is the case for the
+ * consequent of an implication. Each auxiliary variable for a clause is then
+ * not needed, and ~x | a1 | a2 | a3 | a4 is added directly. The converse
+ * implications are kept in the result, and are added only if the result is
+ * negated. With DisjunctionEncoding::equivalence, the auxiliary variables are
+ * always defined in both directions, as in the example above.
+ *
  * @param      other  The Clauses object to perform the OR operation with
  *
  * @return     A Clauses object with the result of the OR operation
  */
 Clauses Clauses::operator|(const Clauses &other) {
-  if (other.getClauses().size() == 0) {
+  if (other.size() == 0) {
     Clauses result = other;
     return result;
   }
@@ -155,46 +177,76 @@ Clauses Clauses::operator|(const Clauses &other) {
   // disjunctioned
   Lit x = timetabler->newLiteral();
   Lit y = timetabler->newLiteral();
-  Clauses result(CClause(x) | CClause(y));
+  Lit xOrY[] = {x, y};
+  Clauses result;
+  result.clauses.addClause(xOrY, 2);
+  if (timetabler->data.disjunctionEncoding == DisjunctionEncoding::polarity) {
+    // reused between calls, so that no memory is allocated for the clauses
+    static thread_local std::vector<Lit> implies;
+    for (unsigned i = 0; i < clauses.size(); i++) {
+      implies.assign(1, ~x);
+      implies.insert(std::end(implies), clauses[i].begin(), clauses[i].end());
+      timetabler->addToFormula(ClauseSpan(implies.data(), implies.size()), -1);
+    }
+    for (unsigned i = 0; i < other.clauses.size(); i++) {
+      implies.assign(1, ~y);
+      implies.insert(std::end(implies), other.clauses[i].begin(),
+                     other.clauses[i].end());
+      timetabler->addToFormula(ClauseSpan(implies.data(), implies.size()), -1);
+    }
+    result.addNegativeDefinitionsOf(*this);
+    result.addNegativeDefinitionsOf(other);
+    result.negativeDefinitionClauses.addClauses(clauses);
+    SpareBuffers<std::pair<Lit, unsigned>>::take(result.negativeDefinitionLits);
+    result.negativeDefinitionLits.push_back(std::make_pair(x, clauses.size()));
+    result.negativeDefinitionClauses.addClauses(other.clauses);
+    result.negativeDefinitionLits.push_back(
+        std::make_pair(y, other.clauses.size()));
+    return result;
+  }
   vec<Lit> xrep;
   xrep.push(x);
   vec<Lit> yrep;
   yrep.push(y);
+  vec<Lit> clause;
+  vec<Lit> c1rep;
   for (unsigned i = 0; i < clauses.size(); i++) {
     // c1 is the auxiliary variable for a ith clause
     Lit c1 = timetabler->newLiteral();
     xrep.push(~c1);
-    vec<Lit> clause;
+    clause.clear();
     clause.push(c1);
     clause.push(~x);
     timetabler->addToFormula(clause, -1);
-    CClause c1rep(~c1);
-    for (unsigned j = 0; j < clauses[i].getLits().size(); j++) {
-      c1rep.addLits(clauses[i].getLits()[j]);
-      vec<Lit> clause;
+    c1rep.clear();
+    c1rep.push(~c1);
+    for (Lit lit : clauses[i]) {
+      c1rep.push(lit);
+      clause.clear();
       clause.push(c1);
-      clause.push(~clauses[i].getLits()[j]);
+      clause.push(~lit);
       timetabler->addToFormula(clause, -1);
     }
-    timetabler->addClauses(c1rep, -1);
+    timetabler->addToFormula(c1rep, -1);
   }
   for (unsigned i = 0; i < other.clauses.size(); i++) {
     // c1 is the auxiliary variable for a ith clause
     Lit c1 = timetabler->newLiteral();
     yrep.push(~c1);
-    vec<Lit> clause;
+    clause.clear();
     clause.push(c1);
     clause.push(~y);
     timetabler->addToFormula(clause, -1);
-    CClause c1rep(~c1);
-    for (unsigned j = 0; j < other.clauses[i].getLits().size(); j++) {
-      c1rep.addLits(other.clauses[i].getLits()[j]);
-      vec<Lit> clause;
+    c1rep.clear();
+    c1rep.push(~c1);
+    for (Lit lit : other.clauses[i]) {
+      c1rep.push(lit);
+      clause.clear();
       clause.push(c1);
-      clause.push(~other.clauses[i].getLits()[j]);
+      clause.push(~lit);
       timetabler->addToFormula(clause, -1);
     }
-    timetabler->addClauses(c1rep, -1);
+    timetabler->addToFormula(c1rep, -1);
   }
   timetabler->addToFormula(xrep, -1);
   timetabler->addToFormula(yrep, -1);
@@ -230,12 +282,80 @@ Clauses Clauses::operator>>(const Clauses &other) {
   return (negateThis | other);
 }
 
+/**
+ * @brief      Adds the definitions needed when this set of clauses is negated
+ * to the solver as hard clauses.
+ *
+ * For every auxiliary literal x which was defined only by x -> (C1 AND C2 AND
+ * ...), the converse is added, using an auxiliary variable c for every clause
+ * that has more than one literal:
+ * c | ~a1
+ * c | ~a2
+ * ...
+ * x | ~c1 | ~c2 | ...
+ */
+void Clauses::addNegativeDefinitions() {
+  unsigned next = 0;
+  vec<Lit> xrep;
+  vec<Lit> c1rep;
+  for (auto &definition : negativeDefinitionLits) {
+    xrep.clear();
+    xrep.push(definition.first);
+    for (unsigned i = next; i < next + definition.second; i++) {
+      ClauseSpan clause = negativeDefinitionClauses[i];
+      if (clause.size() == 1) {
+        xrep.push(~clause[0]);
+        continue;
+      }
+      Lit c1 = timetabler->newLiteral();
+      xrep.push(~c1);
+      for (Lit lit : clause) {
+        c1rep.clear();
+        c1rep.push(c1);
+        c1rep.push(~lit);
+        timetabler->addToFormula(c1rep, -1);
+      }
+    }
+    timetabler->addToFormula(xrep, -1);
+    next += definition.second;
+  }
+  negativeDefinitionClauses.clear();
+  negativeDefinitionLits.clear();
+}
+
+/**
+ * @brief      Keeps the definitions needed when another set of clauses is
+ * negated in this object.
+ *
+ * @param[in]  other  The Clauses object whose definitions are to be kept
+ */
+void Clauses::addNegativeDefinitionsOf(const Clauses &other) {
+  if (other.negativeDefinitionLits.empty()) {
+    return;
+  }
+  negativeDefinitionClauses.addClauses(other.negativeDefinitionClauses);
+  SpareBuffers<std::pair<Lit, unsigned>>::take(negativeDefinitionLits);
+  negativeDefinitionLits.insert(std::end(negativeDefinitionLits),
+                                std::begin(other.negativeDefinitionLits),
+                                std::end(other.negativeDefinitionLits));
+}
+
 /**
  * @brief      Adds a CClause to the set of clauses.
  *
  * @param[in]  other  The CClause to add
  */
-void Clauses::addClauses(const CClause &other) { clauses.push_back(other); }
+void Clauses::addClauses(const CClause &other) {
+  clauses.addClause(other.getLits());
+}
+
+/**
+ * @brief      Adds a clause given by its literals to the set of clauses.
+ *
+ * @param[in]  other  The literals of the clause, which must not be a view of
+ * this object
+ */
+void Clauses::addClauses(const ClauseSpan &other) { clauses.addClause(other); }
 
 /**
  * @brief      Adds a vector of CClause to the set of clauses.
@@ -243,7 +363,9 @@ void Clauses::addClauses(const CClause &other) { clauses.push_back(other); }
  * @param[in]  other  The CClause vector to append
  */
 void Clauses::addClauses(const std::vector<CClause> &other) {
-  clauses.insert(std::end(clauses), std::begin(other), std::end(other));
+  for (const CClause &clause : other) {
+    clauses.addClause(clause.getLits());
+  }
 }
 
 /**
@@ -252,22 +374,64 @@ void Clauses::addClauses(const std::vector<CClause> &other) {
  * @param[in]  other  The Clauses object whose clauses are to be added
  */
 void Clauses::addClauses(const Clauses &other) {
-  std::vector<CClause> otherClauses = other.getClauses();
-  addClauses(otherClauses);
+  clauses.addClauses(other.clauses);
+  addNegativeDefinitionsOf(other);
+}
+
+/**
+ * @brief      Adds the clauses of a temporary Clauses object to this object.
+ *
+ * If this object is empty, the buffers of the other object are taken over
+ * instead of being copied.
+ *
+ * @param[in]  other  The Clauses object whose clauses are to be added
+ */
+void Clauses::addClauses(Clauses &&other) {
+  if (clauses.size() == 0 && negativeDefinitionLits.empty()) {
+    *this = std::move(other);
+    return;
+  }
+  addClauses(static_cast<const Clauses &>(other));
 }
 
+/**
+ * @brief      Gets the number of clauses in this object.
+ *
+ * @return     The number of clauses
+ */
+unsigned Clauses::size() const { return clauses.size(); }
+
+/**
+ * @brief      Gets a view of a clause in this object.
+ *
+ * The view is valid until this object is modified.
+ *
+ * @param[in]  index  The index of the clause
+ *
+ * @return     The literals of the clause
+ */
+ClauseSpan Clauses::getClause(unsigned index) const { return clauses[index]; }
+
 /**
  * @brief      Gets the clauses in this object.
  *
  * @return     The clauses
  */
-std::vector<CClause> Clauses::getClauses() const { return clauses; }
+std::vector<CClause> Clauses::getClauses() const {
+  std::vector<CClause> result;
+  result.reserve(clauses.size());
+  for (unsigned i = 0; i < clauses.size(); i++) {
+    result.push_back(
+        CClause(std::vector<Lit>(clauses[i].begin(), clauses[i].end())));
+  }
+  return result;
+}
 
 /**
  * @brief      Displays the clauses in this object.
  */
 void Clauses::print() {
-  for (CClause c : clauses) {
+  for (CClause c : getClauses()) {
     c.printClause();
   }
   LOG_DEBUG(INFO) << "";
@@ -276,4 +440,8 @@ void Clauses::print() {
 /**
  * @brief      Clears the Clauses object by removing all the clauses.
  */
-void Clauses::clear() { clauses.clear(); }
+void Clauses::clear() {
+  clauses.clear();
+  negativeDefinitionClauses.clear();
+  negativeDefinitionLits.clear();
+}
@@ -0,0 +1,300 @@
+#include "component_solver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "mtl/Vec.h"
+
+using namespace NSPACE;
+
+/**
+ * @brief      Constructs the ComponentSolver object.
+ *
+ * @param      formula  The formula
+ */
+ComponentSolver::ComponentSolver(MaxSATFormula *formula)
+    : formula(formula), fixedCost(0), cost(0), lowerBound(0), optimal(false) {}
+
+/**
+ * @brief      Destroys the ComponentSolver object, and the solvers of the
+ * components.
+ */
+ComponentSolver::~ComponentSolver() {
+  for (unsigned i = 0; i < solvers.size(); i++) {
+    // the solver owns the component formula, and deletes it when it is deleted
+    delete solvers[i];
+  }
+}
+
+/**
+ * @brief      Splits the formula into components that share no variables.
+ *
+ * Variables fixed by hard unit clauses, such as the variables of hard
+ * constraints and of hard existing assignments, are replaced by their values
+ * first, since they would otherwise connect every course. The remaining
+ * variables are grouped with a union-find over the clauses, and each group
+ * becomes a formula of its own, with its variables renumbered from zero.
+ *
+ * @param[out] componentVars  The variables of each component, where the
+ * variable at position i is variable i of the component formula
+ * @param[out] fixedValues    The value of each fixed variable, and l_Undef
+ * for the others
+ * @param[out] fixedCost      The total weight of the soft clauses falsified
+ * by the fixed variables alone
+ *
+ * @return     The formula of each component, or no formulas if the hard unit
+ * clauses contradict each other. The formulas are owned by the caller, until
+ * they are loaded into a solver
+ */
+std::vector<MaxSATFormula *> ComponentSolver::splitFormula(
+    std::vector<std::vector<Var>> &componentVars,
+    std::vector<lbool> &fixedValues, uint64_t &fixedCost) {
+  std::vector<MaxSATFormula *> components;
+  int varCount = formula->nVars();
+  fixedValues.assign(varCount, l_Undef);
+  fixedCost = 0;
+  for (int i = 0; i < formula->nHard(); i++) {
+    const vec<Lit> &clause = formula->getHardClause(i).clause;
+    if (clause.size() != 1) {
+      continue;
+    }
+    lbool value = sign(clause[0]) ? l_False : l_True;
+    if (fixedValues[var(clause[0])] == (value ^ true)) {
+      return components;
+    }
+    fixedValues[var(clause[0])] = value;
+  }
+
+  std::vector<int> parent(varCount);
+  for (int i = 0; i < varCount; i++) {
+    parent[i] = i;
+  }
+  auto find = [&parent](int v) {
+    while (parent[v] != v) {
+      parent[v] = parent[parent[v]];
+      v = parent[v];
+    }
+    return v;
+  };
+  // returns the first free variable of a clause, or -1 if it has none
+  auto joinClause = [&](const vec<Lit> &clause) {
+    int first = -1;
+    for (int j = 0; j < clause.size(); j++) {
+      if (fixedValues[var(clause[j])] != l_Undef) {
+        continue;
+      }
+      if (first == -1) {
+        first = var(clause[j]);
+      } else {
+        parent[find(var(clause[j]))] = find(first);
+      }
+    }
+    return first;
+  };
+  for (int i = 0; i < formula->nHard(); i++) {
+    joinClause(formula->getHardClause(i).clause);
+  }
+  for (int i = 0; i < formula->nSoft(); i++) {
+    joinClause(formula->getSoftClause(i).clause);
+  }
+
+  std::vector<int> componentOf(varCount, -1);
+  std::vector<int> localVar(varCount, -1);
+  // adds the clause to its component, and returns false if it cannot be
+  // satisfied
+  auto addClause = [&](const vec<Lit> &clause, bool hard, uint64_t weight) {
+    for (int j = 0; j < clause.size(); j++) {
+      if (fixedValues[var(clause[j])] == (sign(clause[j]) ? l_False : l_True)) {
+        return true;
+      }
+    }
+    vec<Lit> localClause;
+    int component = -1;
+    for (int j = 0; j < clause.size(); j++) {
+      Var v = var(clause[j]);
+      if (fixedValues[v] != l_Undef) {
+        continue;
+      }
+      int root = find(v);
+      if (componentOf[root] == -1) {
+        componentOf[root] = components.size();
+        components.push_back(new MaxSATFormula());
+        components.back()->setProblemType(_WEIGHTED_);
+        componentVars.push_back(std::vector<Var>());
+      }
+      component = componentOf[root];
+      if (localVar[v] == -1) {
+        localVar[v] = componentVars[component].size();
+        componentVars[component].push_back(v);
+        components[component]->newVar();
+      }
+      localClause.push(mkLit(localVar[v], sign(clause[j])));
+    }
+    if (component == -1) {
+      if (hard) {
+        return false;
+      }
+      fixedCost += weight;
+    } else if (hard) {
+      components[component]->addHardClause(localClause);
+    } else {
+      components[component]->addSoftClause(weight, localClause);
+    }
+    return true;
+  };
+  for (int i = 0; i < formula->nHard(); i++) {
+    if (!addClause(formula->getHardClause(i).clause, true, 0)) {
+      for (unsigned j = 0; j < components.size(); j++) {
+        delete components[j];
+      }
+      components.clear();
+      componentVars.clear();
+      return components;
+    }
+  }
+  for (int i = 0; i < formula->nSoft(); i++) {
+    addClause(formula->getSoftClause(i).clause, false,
+              formula->getSoftClause(i).weight);
+  }
+  return components;
+}
+
+/**
+ * @brief      Splits the formula, and loads each component into a solver of
+ * its own.
+ *
+ * @return     True, if the formula has at least two components, False if it
+ * must be solved as a whole, in which case no solver is made
+ */
+bool ComponentSolver::loadComponents() {
+  std::vector<MaxSATFormula *> components =
+      splitFormula(componentVars, fixedValues, fixedCost);
+  if (components.size() < 2) {
+    for (unsigned i = 0; i < components.size(); i++) {
+      delete components[i];
+    }
+    return false;
+  }
+  for (unsigned i = 0; i < components.size(); i++) {
+    TSolver *componentSolver = new TSolver(1, _CARD_TOTALIZER_);
+    componentSolver->loadFormula(components[i]);
+    solvers.push_back(componentSolver);
+  }
+  return true;
+}
+
+/**
+ * @brief      Gets the solvers of the components, so that they can be
+ * configured and interrupted.
+ *
+ * @return     The solvers
+ */
+const std::vector<TSolver *> &ComponentSolver::getSolvers() { return solvers; }
+
+/**
+ * @brief      Gives each solver the part of a hint on the formula that lies in
+ * its component, renumbered to the variables of the component.
+ *
+ * @param[in]  hintLits  The literals of the hint
+ */
+void ComponentSolver::setHint(const std::vector<Lit> &hintLits) {
+  std::vector<int> componentOf(formula->nVars(), -1);
+  std::vector<int> localVar(formula->nVars(), -1);
+  for (unsigned i = 0; i < componentVars.size(); i++) {
+    for (unsigned j = 0; j < componentVars[i].size(); j++) {
+      componentOf[componentVars[i][j]] = i;
+      localVar[componentVars[i][j]] = j;
+    }
+  }
+  std::vector<std::vector<Lit>> componentHints(solvers.size());
+  for (unsigned i = 0; i < hintLits.size(); i++) {
+    int component = componentOf[var(hintLits[i])];
+    if (component != -1) {
+      componentHints[component].push_back(
+          mkLit(localVar[var(hintLits[i])], sign(hintLits[i])));
+    }
+  }
+  for (unsigned i = 0; i < solvers.size(); i++) {
+    solvers[i]->setHint(componentHints[i]);
+  }
+}
+
+/**
+ * @brief      Solves the loaded components, and merges their models.
+ *
+ * @param[in]  threadCount  The number of threads solving the components
+ */
+void ComponentSolver::solve(unsigned threadCount) {
+  std::vector<unsigned> order(solvers.size());
+  for (unsigned i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](unsigned a, unsigned b) {
+    return componentVars[a].size() > componentVars[b].size();
+  });
+  std::vector<std::vector<lbool>> componentModels(solvers.size());
+  std::atomic<unsigned> next(0);
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < std::min<unsigned>(threadCount, solvers.size());
+       t++) {
+    threads.push_back(std::thread([&]() {
+      for (unsigned i = next++; i < order.size(); i = next++) {
+        componentModels[order[i]] = solvers[order[i]]->tSearch();
+      }
+    }));
+  }
+  for (unsigned i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+
+  model.assign(formula->nVars(), l_False);
+  for (int v = 0; v < formula->nVars(); v++) {
+    if (fixedValues[v] != l_Undef) {
+      model[v] = fixedValues[v];
+    }
+  }
+  optimal = true;
+  cost = fixedCost;
+  lowerBound = fixedCost;
+  for (unsigned i = 0; i < solvers.size(); i++) {
+    optimal = optimal && solvers[i]->isSearchCompleted();
+    cost += solvers[i]->getUpperBound();
+    lowerBound += solvers[i]->getLowerBound();
+    if (componentModels[i].size() == 0) {
+      model.clear();
+    }
+    for (unsigned j = 0; j < componentVars[i].size() && model.size() > 0;
+         j++) {
+      model[componentVars[i][j]] = componentModels[i][j];
+    }
+  }
+}
+
+/**
+ * @brief      Gets the merged model.
+ *
+ * @return     The model, which is empty if a component has no model
+ */
+std::vector<lbool> ComponentSolver::getModel() { return model; }
+
+/**
+ * @brief      Gets the cost of the merged model.
+ *
+ * @return     The cost
+ */
+uint64_t ComponentSolver::getCost() { return cost; }
+
+/**
+ * @brief      Gets the lower bound proved on the optimal cost.
+ *
+ * @return     The lower bound
+ */
+uint64_t ComponentSolver::getLowerBound() { return lowerBound; }
+
+/**
+ * @brief      Checks if the merged model was proved to be optimal.
+ *
+ * @return     True, if the model is optimal, False otherwise
+ */
+bool ComponentSolver::isOptimal() { return optimal; }
@@ -1,7 +1,11 @@
 #include "constraint_adder.h"
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <utility>
 #include <vector>
+#include "clause_sink.h"
 #include "clauses.h"
 #include "constraint_encoder.h"
 #include "core/SolverTypes.h"
@@ -33,26 +37,40 @@ ConstraintAdder::ConstraintAdder(ConstraintEncoder *encoder,
  * other functions.
  *
  * @param[in]  fieldType  The field type on which this constraint is imposed
- *
- * @return     A Clauses object describing this constraint
+ * @param      sink       The ClauseSink to which the clauses are written
  */
-Clauses ConstraintAdder::fieldSingleValueAtATime(FieldType fieldType) {
-  Clauses result;
-  result.clear();
-  std::vector<Course> courses = timetabler->data.courses;
-  for (unsigned i = 0; i < courses.size(); i++) {
-    for (unsigned j = i + 1; j < courses.size(); j++) {
+void ConstraintAdder::fieldSingleValueAtATime(FieldType fieldType,
+                                              ClauseSink &sink) {
+  if (timetabler->data.clashEncoding == ClashEncoding::timeUnits) {
+    /*
+     * For every field value, at most one course with that value is held
+     * in each atomic time unit
+     */
+    unsigned valueCount =
+        Utils::getFieldValueCount(fieldType, timetabler->data);
+    for (unsigned i = 0; i < valueCount; i++) {
+      sink.addClauses(encoder->fieldValueSingleCourseAtATime(fieldType, i));
+    }
+    return;
+  }
+  // the pairs with each first course are encoded in parallel
+  unsigned courseCount = timetabler->data.courses.size();
+  timetabler->encodeInParallel(courseCount, [&](unsigned i) {
+    for (unsigned j = i + 1; j < courseCount; j++) {
       /*
        * For every pair of courses, either the field value of the
        * FieldType is different or their times do not intersect
        */
       Clauses antecedent =
           encoder->hasSameFieldTypeNotSameValue(i, j, fieldType);
+      // no clauses if the field values are known to be different
+      if (antecedent.size() == 0) {
+        continue;
+      }
       Clauses consequent = encoder->notIntersectingTime(i, j);
-      result.addClauses(antecedent | consequent);
+      sink.addClauses(antecedent | consequent);
     }
-  }
-  return result;
+  });
 }
 
 /**
@@ -62,10 +80,10 @@ Clauses ConstraintAdder::fieldSingleValueAtATime(FieldType fieldType) {
  * This simply calls fieldSingleValueAtATime with the FieldType as
  * FieldType::instructor. By default, this constraint is hard.
  *
- * @return     A Clauses object describing this constraint
+ * @param      sink  The ClauseSink to which the clauses are written
  */
-Clauses ConstraintAdder::instructorSingleCourseAtATime() {
-  return fieldSingleValueAtATime(FieldType::instructor);
+void ConstraintAdder::instructorSingleCourseAtATime(ClauseSink &sink) {
+  fieldSingleValueAtATime(FieldType::instructor, sink);
 }
 
 /**
@@ -73,12 +91,76 @@ Clauses ConstraintAdder::instructorSingleCourseAtATime() {
  *             course at a given time.
  *
  * This simply calls fieldSingleValueAtATime with the FieldType as
- * FieldType::classroom. By default, this constraint is hard.
+ * FieldType::classroom, or classroomCapacityAtATime if the timetable is solved
+ * in two stages. By default, this constraint is hard.
  *
- * @return     A Clauses object describing this constraint
+ * @param      sink  The ClauseSink to which the clauses are written
  */
-Clauses ConstraintAdder::classroomSingleCourseAtATime() {
-  return fieldSingleValueAtATime(FieldType::classroom);
+void ConstraintAdder::classroomSingleCourseAtATime(ClauseSink &sink) {
+  if (timetabler->data.twoStage) {
+    classroomCapacityAtATime(sink);
+    return;
+  }
+  fieldSingleValueAtATime(FieldType::classroom, sink);
+}
+
+/**
+ * @brief      Imposes the constraint that the Courses held at a given time
+ * fit in the Classrooms, without choosing their Classrooms.
+ *
+ * For every size of Course, the number of Courses at least that large held in
+ * an atomic time unit is at most the number of Classrooms large enough for
+ * them. This is the condition for the Courses held in a single atomic time
+ * unit to be matched to distinct Classrooms, so it is a relaxation of
+ * classroomSingleCourseAtATime, and the Classrooms are assigned after the
+ * search. Only the time units that are not covered by fewer field values than
+ * another unit are needed. Courses whose Classroom is fixed are not counted,
+ * and instead, Courses fixed to the same Classroom are not held at an
+ * intersecting time.
+ *
+ * @param      sink  The ClauseSink to which the clauses are written
+ */
+void ConstraintAdder::classroomCapacityAtATime(ClauseSink &sink) {
+  Data &data = timetabler->data;
+  std::vector<int> courses;
+  std::vector<std::vector<int>> fixedCourses(data.classrooms.size());
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    const std::vector<Var> &vars =
+        data.fieldValueVars[i][FieldType::classroom];
+    int fixed = -1;
+    for (unsigned k = 0; k < vars.size(); k++) {
+      if (vars[k] == data.trueVar) {
+        fixed = k;
+      }
+    }
+    if (fixed == -1) {
+      courses.push_back(i);
+      continue;
+    }
+    for (int other : fixedCourses[fixed]) {
+      sink.addClauses(encoder->notIntersectingTime(other, i));
+    }
+    fixedCourses[fixed].push_back(i);
+  }
+  std::stable_sort(courses.begin(), courses.end(), [&data](int a, int b) {
+    return data.courses[a].getClassSize() > data.courses[b].getClassSize();
+  });
+  std::vector<unsigned> capacities;
+  for (int course : courses) {
+    unsigned capacity = 0;
+    for (unsigned i = 0; i < data.classrooms.size(); i++) {
+      capacity +=
+          (data.classrooms[i].getSize() >= data.courses[course].getClassSize());
+    }
+    capacities.push_back(capacity);
+  }
+  std::vector<unsigned> slotUnits = data.getMaximalTimeUnits(FieldType::slot);
+  for (unsigned segmentUnit : data.getMaximalTimeUnits(FieldType::segment)) {
+    for (unsigned slotUnit : slotUnits) {
+      sink.addClauses(encoder->coursesWithinCapacity(segmentUnit, slotUnit,
+                                                     courses, capacities));
+    }
+  }
 }
 
 /**
@@ -88,24 +170,39 @@ Clauses ConstraintAdder::classroomSingleCourseAtATime() {
  *
  * By default, this constraint is hard.
  *
- * @return     A Clauses object describing the constraint
+ * @param      sink  The ClauseSink to which the clauses are written
  */
-Clauses ConstraintAdder::programSingleCoreCourseAtATime() {
-  Clauses result;
-  result.clear();
-  std::vector<Course> courses = timetabler->data.courses;
-  for (unsigned i = 0; i < courses.size(); i++) {
-    for (unsigned j = i + 1; j < courses.size(); j++) {
+void ConstraintAdder::programSingleCoreCourseAtATime(ClauseSink &sink) {
+  if (timetabler->data.clashEncoding == ClashEncoding::timeUnits) {
+    /*
+     * For every core Program, at most one course that is core for it is
+     * held in each atomic time unit
+     */
+    for (unsigned i = 0; i < timetabler->data.programs.size(); i++) {
+      if (timetabler->data.programs[i].isCoreProgram()) {
+        sink.addClauses(
+            encoder->fieldValueSingleCourseAtATime(FieldType::program, i));
+      }
+    }
+    return;
+  }
+  // the pairs with each first course are encoded in parallel
+  unsigned courseCount = timetabler->data.courses.size();
+  timetabler->encodeInParallel(courseCount, [&](unsigned i) {
+    for (unsigned j = i + 1; j < courseCount; j++) {
       /*
        * For every pair of courses, either there is no Program for which
        * they are both core or their times do not intersect
        */
       Clauses antecedent = encoder->hasNoCommonCoreProgram(i, j);
+      // no clauses if there is known to be no common core Program
+      if (antecedent.size() == 0) {
+        continue;
+      }
       Clauses consequent = encoder->notIntersectingTime(i, j);
-      result.addClauses(antecedent | consequent);
+      sink.addClauses(antecedent | consequent);
     }
-  }
-  return result;
+  });
 }
 
 /**
@@ -114,22 +211,20 @@ Clauses ConstraintAdder::programSingleCoreCourseAtATime() {
  *
  * By default, this constraint is hard.
  *
+ * @param[in]  course  The course
+ *
  * @return     A Clauses object describing the constraint
  */
-std::vector<Clauses> ConstraintAdder::minorInMinorTime() {
-  std::vector<Course> courses = timetabler->data.courses;
-  std::vector<Clauses> result(courses.size());
-  for (unsigned i = 0; i < courses.size(); i++) {
-    result[i].clear();
-    /*
-     * a minor course must be in a minor Slot.
-     * a non-minor course must not be in a minor Slot.
-     */
-    Clauses antecedent = encoder->isMinorCourse(i);
-    Clauses consequent = encoder->slotInMinorTime(i);
-    result[i].addClauses(antecedent >> consequent);
-    result[i].addClauses(consequent >> antecedent);
-  }
+Clauses ConstraintAdder::minorInMinorTime(int course) {
+  Clauses result;
+  /*
+   * a minor course must be in a minor Slot.
+   * a non-minor course must not be in a minor Slot.
+   */
+  Clauses antecedent = encoder->isMinorCourse(course);
+  Clauses consequent = encoder->slotInMinorTime(course);
+  result.addClauses(antecedent >> consequent);
+  result.addClauses(consequent >> antecedent);
   return result;
 }
 
@@ -144,30 +239,46 @@ std::vector<Clauses> ConstraintAdder::minorInMinorTime() {
  * modifications.
  *
  * @param[in]  fieldType  The field type on which this constraint is imposed
+ * @param[in]  course     The course
  *
  * @return     A Clauses object describing the constraint
  */
-std::vector<Clauses> ConstraintAdder::exactlyOneFieldValuePerCourse(
-    FieldType fieldType) {
-  std::vector<Course> courses = timetabler->data.courses;
-  std::vector<Clauses> result(courses.size());
-  for (unsigned i = 0; i < courses.size(); i++) {
-    result[i].clear();
-    // exactly one field value must be true
-    Clauses exactlyOneFieldValue =
-        encoder->hasExactlyOneFieldValueTrue(i, fieldType);
-    Clauses cclause(timetabler->data.highLevelVars[i][fieldType]);
-    // high level variable implies the clause, and by default is hard
-    // if high level variable is false, this clause could not be satisfied
-    // this provides a reason to the user
-    result[i].addClauses(cclause >> exactlyOneFieldValue);
-  }
-  return result;
+Clauses ConstraintAdder::exactlyOneFieldValuePerCourse(FieldType fieldType,
+                                                       int course) {
+  // exactly one field value must be true
+  Clauses exactlyOneFieldValue =
+      encoder->hasExactlyOneFieldValueTrue(course, fieldType);
+  Clauses cclause(timetabler->data.highLevelVars[course][fieldType]);
+  // high level variable implies the clause, and by default is hard
+  // if high level variable is false, this clause could not be satisfied
+  // this provides a reason to the user
+  return cclause >> exactlyOneFieldValue;
+}
+
+/**
+ * @brief      Gets the literal of the high level variable of a predefined
+ * constraint, which implies the constraint.
+ *
+ * @param[in]  clauseType  The PredefinedClauses member denoting the constraint
+ * type
+ * @param[in]  course      The corresponding course index (-1 for if there is no
+ * corresponding course)
+ *
+ * @return     The literal
+ */
+Lit ConstraintAdder::getConstraintLit(PredefinedClauses clauseType,
+                                      const int course) {
+  unsigned index = (course == -1) ? 0 : course;
+  return mkLit(timetabler->data.predefinedConstraintVars[clauseType][index],
+               false);
 }
 
 /**
  * @brief      Adds a single predefined constraint to the solver.
  *
+ * The clauses are added as hard clauses, each implied by the high level
+ * variable of the constraint.
+ *
  * @param[in]  clauseType  The PredefinedClauses member denoting the constraint
  * type
  * @param[in]  clauses     The clauses to be added
@@ -177,24 +288,47 @@ std::vector<Clauses> ConstraintAdder::exactlyOneFieldValuePerCourse(
 void ConstraintAdder::addSingleConstraint(PredefinedClauses clauseType,
                                           const Clauses &clauses,
                                           const int course) {
-  if (course == -1) {
-    if (timetabler->data.predefinedClausesWeights[clauseType] != 0) {
-      Clauses hardConsequent =
-          CClause(timetabler->data.predefinedConstraintVars[clauseType][0]) >>
-          clauses;
-      timetabler->addClauses(hardConsequent, -1);
-    }
-    timetabler->addHighLevelConstraintClauses(clauseType, -1);
-  } else {
-    if (timetabler->data.predefinedClausesWeights[clauseType] != 0) {
-      Clauses hardConsequent =
-          CClause(
-              timetabler->data.predefinedConstraintVars[clauseType][course]) >>
-          clauses;
-      timetabler->addClauses(hardConsequent, -1);
-    }
-    timetabler->addHighLevelConstraintClauses(clauseType, course);
+  if (timetabler->data.predefinedClausesWeights[clauseType] != 0) {
+    FormulaClauseSink sink(timetabler, getConstraintLit(clauseType, course),
+                           -1);
+    sink.addClauses(clauses);
   }
+  timetabler->addHighLevelConstraintClauses(clauseType, course);
+}
+
+/**
+ * @brief      Adds a predefined constraint that has no corresponding course to
+ * the solver, writing its clauses to the formula as they are encoded.
+ *
+ * @param[in]  clauseType  The PredefinedClauses member denoting the constraint
+ * type
+ * @param[in]  encode      The member function which encodes the constraint
+ */
+void ConstraintAdder::addStreamedConstraint(
+    PredefinedClauses clauseType,
+    void (ConstraintAdder::*encode)(ClauseSink &)) {
+  if (timetabler->data.predefinedClausesWeights[clauseType] != 0) {
+    FormulaClauseSink sink(timetabler, getConstraintLit(clauseType, -1), -1);
+    (this->*encode)(sink);
+  }
+  timetabler->addHighLevelConstraintClauses(clauseType, -1);
+}
+
+/**
+ * @brief      Adds a predefined constraint that has a corresponding course for
+ * every course to the solver, encoding the courses in parallel.
+ *
+ * @param[in]  clauseType  The PredefinedClauses member denoting the constraint
+ * type
+ * @param[in]  encode      The function which encodes the constraint for a
+ * course
+ */
+void ConstraintAdder::addCourseConstraint(
+    PredefinedClauses clauseType, const std::function<Clauses(int)> &encode) {
+  timetabler->encodeInParallel(
+      timetabler->data.courses.size(), [&](unsigned course) {
+        addSingleConstraint(clauseType, encode(course), course);
+      });
 }
 
 /**
@@ -204,64 +338,36 @@ void ConstraintAdder::addSingleConstraint(PredefinedClauses clauseType,
 void ConstraintAdder::addConstraints() {
   std::vector<int> weights = timetabler->data.predefinedClausesWeights;
   // add the constraints to the formula
-  addSingleConstraint(PredefinedClauses::instructorSingleCourseAtATime,
-                      instructorSingleCourseAtATime(), -1);
-  addSingleConstraint(PredefinedClauses::classroomSingleCourseAtATime,
-                      classroomSingleCourseAtATime(), -1);
-  addSingleConstraint(PredefinedClauses::programSingleCoreCourseAtATime,
-                      programSingleCoreCourseAtATime(), -1);
-
-  auto clauses = minorInMinorTime();
-  for (unsigned i = 0; i < clauses.size(); i++) {
-    addSingleConstraint(PredefinedClauses::minorInMinorTime, clauses[i], i);
-  }
+  addStreamedConstraint(PredefinedClauses::instructorSingleCourseAtATime,
+                        &ConstraintAdder::instructorSingleCourseAtATime);
+  addStreamedConstraint(PredefinedClauses::classroomSingleCourseAtATime,
+                        &ConstraintAdder::classroomSingleCourseAtATime);
+  addStreamedConstraint(PredefinedClauses::programSingleCoreCourseAtATime,
+                        &ConstraintAdder::programSingleCoreCourseAtATime);
 
-  clauses = programAtMostOneOfCoreOrElective();
-  for (unsigned i = 0; i < clauses.size(); i++) {
-    addSingleConstraint(PredefinedClauses::programAtMostOneOfCoreOrElective,
-                        clauses[i], i);
-  }
-
-  clauses = exactlyOneFieldValuePerCourse(FieldType::slot);
-  for (unsigned i = 0; i < clauses.size(); i++) {
-    addSingleConstraint(PredefinedClauses::exactlyOneSlotPerCourse, clauses[i],
-                        i);
-  }
-
-  clauses = exactlyOneFieldValuePerCourse(FieldType::classroom);
-  for (unsigned i = 0; i < clauses.size(); i++) {
-    addSingleConstraint(PredefinedClauses::exactlyOneClassroomPerCourse,
-                        clauses[i], i);
-  }
-
-  clauses = exactlyOneFieldValuePerCourse(FieldType::instructor);
-  for (unsigned i = 0; i < clauses.size(); i++) {
-    addSingleConstraint(PredefinedClauses::exactlyOneInstructorPerCourse,
-                        clauses[i], i);
-  }
-
-  clauses = exactlyOneFieldValuePerCourse(FieldType::isMinor);
-  for (unsigned i = 0; i < clauses.size(); i++) {
-    addSingleConstraint(PredefinedClauses::exactlyOneIsMinorPerCourse,
-                        clauses[i], i);
-  }
-
-  clauses = exactlyOneFieldValuePerCourse(FieldType::segment);
-  for (unsigned i = 0; i < clauses.size(); i++) {
-    addSingleConstraint(PredefinedClauses::exactlyOneSegmentPerCourse,
-                        clauses[i], i);
-  }
-
-  clauses = coreInMorningTime();
-  for (unsigned i = 0; i < clauses.size(); i++) {
-    addSingleConstraint(PredefinedClauses::coreInMorningTime, clauses[i], i);
-  }
-
-  clauses = electiveInNonMorningTime();
-  for (unsigned i = 0; i < clauses.size(); i++) {
-    addSingleConstraint(PredefinedClauses::electiveInNonMorningTime, clauses[i],
-                        i);
+  addCourseConstraint(PredefinedClauses::minorInMinorTime,
+                      [this](int course) { return minorInMinorTime(course); });
+  addCourseConstraint(
+      PredefinedClauses::programAtMostOneOfCoreOrElective,
+      [this](int course) { return programAtMostOneOfCoreOrElective(course); });
+  const std::vector<std::pair<PredefinedClauses, FieldType>> exactlyOne = {
+      {PredefinedClauses::exactlyOneSlotPerCourse, FieldType::slot},
+      {PredefinedClauses::exactlyOneClassroomPerCourse, FieldType::classroom},
+      {PredefinedClauses::exactlyOneInstructorPerCourse,
+       FieldType::instructor},
+      {PredefinedClauses::exactlyOneIsMinorPerCourse, FieldType::isMinor},
+      {PredefinedClauses::exactlyOneSegmentPerCourse, FieldType::segment}};
+  for (auto &constraint : exactlyOne) {
+    FieldType fieldType = constraint.second;
+    addCourseConstraint(constraint.first, [this, fieldType](int course) {
+      return exactlyOneFieldValuePerCourse(fieldType, course);
+    });
   }
+  addCourseConstraint(PredefinedClauses::coreInMorningTime,
+                      [this](int course) { return coreInMorningTime(course); });
+  addCourseConstraint(
+      PredefinedClauses::electiveInNonMorningTime,
+      [this](int course) { return electiveInNonMorningTime(course); });
 }
 
 /*Clauses ConstraintAdder::softConstraints() {
@@ -273,18 +379,14 @@ void ConstraintAdder::addConstraints() {
  *
  * By default, this constraint is soft.
  *
+ * @param[in]  course  The course
+ *
  * @return     A Clauses object describing the constraint
  */
-std::vector<Clauses> ConstraintAdder::coreInMorningTime() {
-  std::vector<Course> courses = timetabler->data.courses;
-  std::vector<Clauses> result(courses.size());
-  for (unsigned i = 0; i < courses.size(); i++) {
-    result[i].clear();
-    Clauses coreCourse = encoder->isCoreCourse(i);
-    Clauses morningTime = encoder->courseInMorningTime(i);
-    result[i].addClauses(coreCourse >> morningTime);
-  }
-  return result;
+Clauses ConstraintAdder::coreInMorningTime(int course) {
+  Clauses coreCourse = encoder->isCoreCourse(course);
+  Clauses morningTime = encoder->courseInMorningTime(course);
+  return coreCourse >> morningTime;
 }
 
 /**
@@ -292,18 +394,14 @@ std::vector<Clauses> ConstraintAdder::coreInMorningTime() {
  *
  * By default, this constraint is soft.
  *
+ * @param[in]  course  The course
+ *
  * @return     A Clauses object describing the constraint
  */
-std::vector<Clauses> ConstraintAdder::electiveInNonMorningTime() {
-  std::vector<Course> courses = timetabler->data.courses;
-  std::vector<Clauses> result(courses.size());
-  for (unsigned i = 0; i < courses.size(); i++) {
-    result[i].clear();
-    Clauses coreCourse = encoder->isElectiveCourse(i);
-    Clauses morningTime = encoder->courseInMorningTime(i);
-    result[i].addClauses(coreCourse >> (~morningTime));
-  }
-  return result;
+Clauses ConstraintAdder::electiveInNonMorningTime(int course) {
+  Clauses coreCourse = encoder->isElectiveCourse(course);
+  Clauses morningTime = encoder->courseInMorningTime(course);
+  return coreCourse >> (~morningTime);
 }
 
 /**
@@ -313,14 +411,103 @@ std::vector<Clauses> ConstraintAdder::electiveInNonMorningTime() {
  *
  * By default, this constraint is hard.
  *
+ * @param[in]  course  The course
+ *
  * @return     A Clauses object describing the constraint
  */
-std::vector<Clauses> ConstraintAdder::programAtMostOneOfCoreOrElective() {
-  std::vector<Course> courses = timetabler->data.courses;
-  std::vector<Clauses> result(courses.size());
-  for (unsigned i = 0; i < courses.size(); i++) {
-    result[i].clear();
-    result[i].addClauses(encoder->programAtMostOneOfCoreOrElective(i));
+Clauses ConstraintAdder::programAtMostOneOfCoreOrElective(int course) {
+  return encoder->programAtMostOneOfCoreOrElective(course);
+}
+
+/**
+ * @brief      Imposes value precedence on a class of interchangeable values of
+ * a FieldType.
+ *
+ * For consecutive values v and w of the class, a Course may take w only if it
+ * or an earlier Course takes v. Any timetable can be turned into one that
+ * satisfies this by renaming the values of the class in the order in which
+ * they are first taken, so no cost is lost. A variable p(i, v) is added to
+ * denote that some Course up to the i-th takes v, with
+ * p(i, v) -> p(i - 1, v) OR x(i, v), and x(i, w) -> x(i, v) OR p(i - 1, v).
+ *
+ * @param[in]  fieldType   The field type of the values
+ * @param[in]  valueClass  The interchangeable values, in increasing order
+ * @param      sink        The ClauseSink to which the clauses are written
+ */
+void ConstraintAdder::valuePrecedence(FieldType fieldType,
+                                      const std::vector<unsigned> &valueClass,
+                                      ClauseSink &sink) {
+  Data &data = timetabler->data;
+  // the literal of p(i - 1, v) for each value of the class but the last,
+  // undefined while no Course can take v
+  std::vector<Lit> taken(valueClass.size() - 1, lit_Undef);
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    const std::vector<Var> &vars = data.fieldValueVars[i][fieldType];
+    for (unsigned j = 0; j + 1 < valueClass.size(); j++) {
+      Var current = vars[valueClass[j]];
+      Var next = vars[valueClass[j + 1]];
+      if (next == data.falseVar) {
+        continue;
+      }
+      std::vector<Lit> clause = {mkLit(next, true)};
+      if (current != data.falseVar) {
+        clause.push_back(mkLit(current));
+      }
+      if (taken[j] != lit_Undef) {
+        clause.push_back(taken[j]);
+      }
+      sink.addClauses(Clauses(CClause(clause)));
+    }
+    if (i + 1 == data.courses.size()) {
+      break;
+    }
+    for (unsigned j = 0; j + 1 < valueClass.size(); j++) {
+      Var current = vars[valueClass[j]];
+      if (current == data.falseVar) {
+        continue;
+      }
+      Lit updated = timetabler->newLiteral();
+      std::vector<Lit> clause = {~updated, mkLit(current)};
+      if (taken[j] != lit_Undef) {
+        clause.push_back(taken[j]);
+      }
+      sink.addClauses(Clauses(CClause(clause)));
+      taken[j] = updated;
+    }
+  }
+}
+
+/**
+ * @brief      Adds clauses that break the symmetry between interchangeable
+ * Classrooms and between interchangeable Slots, unless symmetry breaking is
+ * disabled.
+ *
+ * The clauses only remove timetables that are renamings of others. They are
+ * guarded by Data::symmetryBreakingVar, which a hard unit clause makes True,
+ * so that an incremental session can release them once it assumes a value of
+ * a single Classroom or Slot. This must be called after the custom
+ * constraints have been added, since values named in them are not
+ * interchangeable.
+ */
+void ConstraintAdder::addSymmetryBreakingConstraints() {
+  Data &data = timetabler->data;
+  if (!data.symmetryBreaking) {
+    return;
+  }
+  Lit guard = timetabler->newLiteral();
+  data.symmetryBreakingVar = var(guard);
+  timetabler->addToFormula(guard, -1);
+  FormulaClauseSink sink(timetabler, guard, -1);
+  for (FieldType fieldType : {FieldType::classroom, FieldType::slot}) {
+    std::vector<std::vector<unsigned>> valueClasses =
+        data.getInterchangeableValues(fieldType);
+    unsigned valueCount = 0;
+    for (unsigned i = 0; i < valueClasses.size(); i++) {
+      valuePrecedence(fieldType, valueClasses[i], sink);
+      valueCount += valueClasses[i].size();
+    }
+    LOG(INFO) << "Symmetry breaking: " << valueCount << " "
+              << Utils::getFieldTypeName(fieldType) << " values in "
+              << valueClasses.size() << " classes";
   }
-  return result;
 }
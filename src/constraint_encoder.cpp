@@ -1,13 +1,17 @@
 #include "constraint_encoder.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "cclause.h"
 #include "clauses.h"
 #include "core/SolverTypes.h"
 #include "global.h"
 #include "timetabler.h"
+#include "utils.h"
 
 using namespace NSPACE;
 
@@ -19,6 +23,35 @@ using namespace NSPACE;
 ConstraintEncoder::ConstraintEncoder(Timetabler *timetabler) {
   this->timetabler = timetabler;
   this->vars = timetabler->data.fieldValueVars;
+  slotTimeUnitVars.resize(vars.size());
+  segmentTimeUnitVars.resize(vars.size());
+  atMostOneVarCount = 0;
+  atMostOneClauseCount = 0;
+  atMostOnePairCount = 0;
+  cacheHitCount = 0;
+  cacheMissCount = 0;
+}
+
+/**
+ * @brief      Gets the key of a subformula in the cache of defining literals.
+ *
+ * @param[in]  formula    The subformula
+ * @param[in]  course1    The course 1
+ * @param[in]  course2    The course 2
+ * @param[in]  fieldType  The field type
+ *
+ * @return     The key
+ */
+unsigned long long ConstraintEncoder::getCacheKey(CachedFormula formula,
+                                                  int course1, int course2,
+                                                  FieldType fieldType) {
+  unsigned long long courseCount = vars.size();
+  return ((static_cast<unsigned long long>(formula) * Global::FIELD_COUNT +
+           fieldType) *
+              courseCount +
+          course1) *
+             courseCount +
+         course2;
 }
 
 /**
@@ -29,6 +62,12 @@ ConstraintEncoder::ConstraintEncoder(Timetabler *timetabler) {
  * This is helpful for constructing constraints such as those enforcing that
  * two courses have the same Slot.
  *
+ * The condition is represented by a literal x, which is defined as
+ * x <-> ((a1 AND b1) OR (a2 AND b2) OR ...) for the field values ai and bi of
+ * the two courses, so that it can be used with either polarity. The literal is
+ * cached, so the condition is encoded only once for a pair of courses and a
+ * FieldType, and later calls return the same literal.
+ *
  * @param[in]  course1    The course 1
  * @param[in]  course2    The course 2
  * @param[in]  fieldType  The field type
@@ -37,18 +76,41 @@ ConstraintEncoder::ConstraintEncoder(Timetabler *timetabler) {
  */
 Clauses ConstraintEncoder::hasSameFieldTypeAndValue(int course1, int course2,
                                                     FieldType fieldType) {
-  Clauses result;
+  if (vars[course1][fieldType].size() == 0) {
+    return Clauses();
+  }
+  // the condition is symmetric in the courses
+  if (course1 > course2) {
+    std::swap(course1, course2);
+  }
+  unsigned long long key = getCacheKey(CachedFormula::sameFieldTypeAndValue,
+                                       course1, course2, fieldType);
+  auto cached = definitionCache.find(key);
+  if (cached != definitionCache.end()) {
+    cacheHitCount++;
+    return Clauses(cached->second);
+  }
+  cacheMissCount++;
+  Lit same = timetabler->newLiteral();
+  std::vector<CClause> definition;
+  CClause sameImplies(~same);
   for (unsigned i = 0; i < vars[course1][fieldType].size(); i++) {
-    CClause field1, field2;
-    field1.createLitAndAdd(vars[course1][fieldType][i]);
-    field2.createLitAndAdd(vars[course2][fieldType][i]);
-    Clauses conjunction(field1 & field2);
-    if (i == 0)
-      result = conjunction;
-    else
-      result = result | conjunction;
+    // both is True if and only if both courses have the ith value
+    Lit both = timetabler->newLiteral();
+    Lit field1 = mkLit(vars[course1][fieldType][i], false);
+    Lit field2 = mkLit(vars[course2][fieldType][i], false);
+    definition.push_back(CClause(~both) | CClause(field1));
+    definition.push_back(CClause(~both) | CClause(field2));
+    CClause bothImplied(both);
+    bothImplied.addLits(~field1, ~field2);
+    definition.push_back(bothImplied);
+    sameImplies.addLits(both);
+    definition.push_back(CClause(same) | CClause(~both));
   }
-  return result;
+  definition.push_back(sameImplies);
+  timetabler->addClauses(definition, -1);
+  definitionCache[key] = same;
+  return Clauses(same);
 }
 
 /**
@@ -70,14 +132,38 @@ Clauses ConstraintEncoder::hasSameFieldTypeNotSameValue(int course1,
                                                         FieldType fieldType) {
   Clauses result;
   for (unsigned i = 0; i < vars[course1][fieldType].size(); i++) {
-    CClause resultClause;
-    resultClause.addLits(~mkLit(vars[course1][fieldType][i], false));
-    resultClause.addLits(~mkLit(vars[course2][fieldType][i], false));
-    result.addClauses(resultClause);
+    addNotBoth(vars[course1][fieldType][i], vars[course2][fieldType][i],
+               result);
   }
   return result;
 }
 
+/**
+ * @brief      Adds a clause that represents that at least one of two variables
+ * is False.
+ *
+ * Variables fixed to True are left out of the clause, and no clause is added
+ * if either variable is fixed to False, since it is then satisfied.
+ *
+ * @param[in]  var1    The variable 1
+ * @param[in]  var2    The variable 2
+ * @param      result  The Clauses to which the clause is added
+ */
+void ConstraintEncoder::addNotBoth(Var var1, Var var2, Clauses &result) {
+  if (var1 == timetabler->data.falseVar || var2 == timetabler->data.falseVar) {
+    return;
+  }
+  Lit resultClause[2];
+  unsigned length = 0;
+  if (var1 != timetabler->data.trueVar) {
+    resultClause[length++] = ~mkLit(var1, false);
+  }
+  if (var2 != timetabler->data.trueVar) {
+    resultClause[length++] = ~mkLit(var2, false);
+  }
+  result.addClauses(ClauseSpan(resultClause, length));
+}
+
 /**
  * @brief      Gives Clauses that represent that a pair of courses are
  *             core for a given Program.
@@ -120,10 +206,8 @@ Clauses ConstraintEncoder::hasNoCommonCoreProgram(int course1, int course2) {
   Clauses result;
   for (unsigned i = 0; i < vars[course1][FieldType::program].size(); i++) {
     if (timetabler->data.programs[i].isCoreProgram()) {
-      CClause resultClause;
-      resultClause.addLits(~mkLit(vars[course1][FieldType::program][i], false));
-      resultClause.addLits(~mkLit(vars[course2][FieldType::program][i], false));
-      result.addClauses(resultClause);
+      addNotBoth(vars[course1][FieldType::program][i],
+                 vars[course2][FieldType::program][i], result);
     }
   }
   return result;
@@ -167,15 +251,13 @@ Clauses ConstraintEncoder::notIntersectingTimeField(int course1, int course2,
   assert(course1 != course2);
   Clauses result;
   for (unsigned i = 0; i < vars[course1][fieldType].size(); i++) {
+    if (vars[course1][fieldType][i] == timetabler->data.falseVar) {
+      continue;
+    }
     Clauses hasFieldValue1(vars[course1][fieldType][i]);
     Clauses notIntersecting1;
-    for (unsigned j = 0; j < vars[course1][fieldType].size(); j++) {
-      if ((fieldType == FieldType::segment &&
-           timetabler->data.segments[i].isIntersecting(
-               timetabler->data.segments[j])) ||
-          (fieldType == FieldType::slot &&
-           timetabler->data.slots[i].isIntersecting(
-               timetabler->data.slots[j]))) {
+    for (unsigned j : timetabler->data.getIntersectingValues(fieldType, i)) {
+      if (vars[course2][fieldType][j] != timetabler->data.falseVar) {
         notIntersecting1.addClauses(~Clauses(vars[course2][fieldType][j]));
       }
     }
@@ -184,6 +266,198 @@ Clauses ConstraintEncoder::notIntersectingTimeField(int course1, int course2,
   return result;
 }
 
+/**
+ * @brief      Creates the variables that represent the atomic time units in
+ * which a Course is held, if they have not been created already.
+ *
+ * A variable for an atomic slot time unit is implied by every Slot variable of
+ * the Course whose Slot covers the unit, and similarly for segment units. The
+ * defining clauses are added to the solver as hard clauses, since the
+ * variables are shared by all the constraints that use them. Only these
+ * implications are added, which is sufficient because the variables only
+ * occur negated in the constraints built on top of them.
+ *
+ * @param[in]  course  The course
+ */
+void ConstraintEncoder::addTimeUnitVars(int course) {
+  Data &data = timetabler->data;
+  if (slotTimeUnitVars[course].size() == data.slotTimeUnitCount &&
+      segmentTimeUnitVars[course].size() == data.segmentTimeUnitCount) {
+    return;
+  }
+  slotTimeUnitVars[course].clear();
+  for (unsigned i = 0; i < data.slotTimeUnitCount; i++) {
+    slotTimeUnitVars[course].push_back(timetabler->newVar());
+  }
+  for (unsigned i = 0; i < vars[course][FieldType::slot].size(); i++) {
+    if (vars[course][FieldType::slot][i] == data.falseVar) {
+      continue;
+    }
+    for (unsigned unit : data.slotTimeUnits[i]) {
+      CClause definition;
+      definition.addLits(~mkLit(vars[course][FieldType::slot][i], false),
+                         mkLit(slotTimeUnitVars[course][unit], false));
+      timetabler->addClauses(Clauses(definition), -1);
+    }
+  }
+  segmentTimeUnitVars[course].clear();
+  for (unsigned i = 0; i < data.segmentTimeUnitCount; i++) {
+    segmentTimeUnitVars[course].push_back(timetabler->newVar());
+  }
+  for (unsigned i = 0; i < vars[course][FieldType::segment].size(); i++) {
+    if (vars[course][FieldType::segment][i] == data.falseVar) {
+      continue;
+    }
+    for (unsigned unit : data.segmentTimeUnits[i]) {
+      CClause definition;
+      definition.addLits(~mkLit(vars[course][FieldType::segment][i], false),
+                         mkLit(segmentTimeUnitVars[course][unit], false));
+      timetabler->addClauses(Clauses(definition), -1);
+    }
+  }
+}
+
+/**
+ * @brief      Gives Clauses that represent that at most one Course with a
+ * given field value is held in each atomic time unit.
+ *
+ * An atomic time unit is a pair of a segment unit and an atomic slot time
+ * unit. For every such unit, a sequential counter over the courses holding
+ * the field value in that unit is used, so the number of clauses is linear in
+ * the number of courses. Together, these clauses are equivalent to requiring
+ * notIntersectingTime for every pair of courses that have the given field
+ * value. Courses for which the field value is fixed to False are left out.
+ *
+ * @param[in]  fieldType  The field type
+ * @param[in]  value      The index of the field value of the given FieldType
+ *
+ * @return     A Clauses object representing the condition
+ */
+Clauses ConstraintEncoder::fieldValueSingleCourseAtATime(FieldType fieldType,
+                                                         int value) {
+  Data &data = timetabler->data;
+  Clauses result;
+  std::vector<unsigned> courses;
+  for (unsigned course = 0; course < vars.size(); course++) {
+    addTimeUnitVars(course);
+    if (vars[course][fieldType][value] != data.falseVar) {
+      courses.push_back(course);
+    }
+  }
+  for (unsigned segmentUnit = 0; segmentUnit < data.segmentTimeUnitCount;
+       segmentUnit++) {
+    for (unsigned slotUnit = 0; slotUnit < data.slotTimeUnitCount;
+         slotUnit++) {
+      // counter is True if an earlier course is held in this time unit
+      Lit previousCounter = lit_Undef;
+      for (unsigned i = 0; i < courses.size(); i++) {
+        unsigned course = courses[i];
+        CClause notInTimeUnit;
+        notInTimeUnit.addLits(
+            ~mkLit(vars[course][fieldType][value], false),
+            ~mkLit(segmentTimeUnitVars[course][segmentUnit], false),
+            ~mkLit(slotTimeUnitVars[course][slotUnit], false));
+        if (previousCounter != lit_Undef) {
+          CClause noEarlierCourse = notInTimeUnit;
+          noEarlierCourse.addLits(~previousCounter);
+          result.addClauses(noEarlierCourse);
+        }
+        if (i + 1 < courses.size()) {
+          Lit counter = mkLit(timetabler->newVar(), false);
+          CClause countCourse = notInTimeUnit;
+          countCourse.addLits(counter);
+          result.addClauses(countCourse);
+          if (previousCounter != lit_Undef) {
+            CClause countEarlierCourse;
+            countEarlierCourse.addLits(~previousCounter, counter);
+            result.addClauses(countEarlierCourse);
+          }
+          previousCounter = counter;
+        }
+      }
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief      Gives Clauses that represent that, in an atomic time unit, the
+ * number of Courses held among the first few of a list of Courses is within a
+ * capacity.
+ *
+ * A sequential counter over the Courses is used, whose register at a position
+ * counts the Courses held up to that position, up to the largest capacity
+ * that has to be checked. A Course held at a position whose capacity is
+ * already used up by the earlier Courses is forbidden. The counter stops at
+ * the last position whose capacity can be exceeded. A Course whose capacity
+ * is 0 is not counted, since it has to be ruled out by other constraints.
+ *
+ * @param[in]  segmentUnit  The segment unit
+ * @param[in]  slotUnit     The atomic slot time unit
+ * @param[in]  courses      The courses
+ * @param[in]  capacities   The capacity at the position of each course, in
+ *                          non-decreasing order
+ *
+ * @return     A Clauses object representing the condition
+ */
+Clauses ConstraintEncoder::coursesWithinCapacity(
+    unsigned segmentUnit, unsigned slotUnit, const std::vector<int> &courses,
+    const std::vector<unsigned> &capacities) {
+  Clauses result;
+  std::vector<int> counted;
+  std::vector<unsigned> limits;
+  for (unsigned i = 0; i < courses.size(); i++) {
+    if (capacities[i] > 0) {
+      addTimeUnitVars(courses[i]);
+      counted.push_back(courses[i]);
+      limits.push_back(capacities[i]);
+    }
+  }
+  unsigned width = 0;
+  unsigned last = 0;
+  for (unsigned i = 0; i < counted.size(); i++) {
+    if (i >= limits[i]) {
+      width = std::max(width, limits[i]);
+      last = i;
+    }
+  }
+  if (width == 0) {
+    return result;
+  }
+  // counters[i][j] is True if at least j + 1 of the first i + 1 courses are
+  // held in this time unit
+  std::vector<std::vector<Lit>> counters(last);
+  for (unsigned i = 0; i <= last; i++) {
+    CClause notHeld;
+    notHeld.addLits(
+        ~mkLit(segmentTimeUnitVars[counted[i]][segmentUnit], false),
+        ~mkLit(slotTimeUnitVars[counted[i]][slotUnit], false));
+    if (i >= limits[i]) {
+      CClause withinCapacity = notHeld;
+      withinCapacity.addLits(~counters[i - 1][limits[i] - 1]);
+      result.addClauses(withinCapacity);
+    }
+    if (i == last) {
+      break;
+    }
+    for (unsigned j = 0; j < std::min(width, i + 1); j++) {
+      counters[i].push_back(mkLit(timetabler->newVar(), false));
+      CClause countCourse = notHeld;
+      if (j > 0) {
+        countCourse.addLits(~counters[i - 1][j - 1]);
+      }
+      countCourse.addLits(counters[i][j]);
+      result.addClauses(countCourse);
+      if (j < i) {
+        CClause countEarlierCourses;
+        countEarlierCourses.addLits(~counters[i - 1][j], counters[i][j]);
+        result.addClauses(countEarlierCourses);
+      }
+    }
+  }
+  return result;
+}
+
 /**
  * @brief      Gives Clauses that represent that a Course can have exactly
  *             one field value of a given FieldType to be True.
@@ -227,12 +501,14 @@ Clauses ConstraintEncoder::hasAtLeastOneFieldValueTrue(int course,
  * @brief      Gives Clauses that represent that a Course can have
  *             at most one field value of a given FieldType to be True.
  *
- * The binomial encoding has been used to represent this constraint. A more
- * efficient encoding, with auxiliary variables, has not been used because
- * such an encoding would only be equisatisfiable. However, when using these
- * clauses as an antecedent of an implication, we need that if the antecedent
- * of the encoded clauses is False, the original set of clauses would also
- * have been False, a property that equisatifiability does not guarantee.
+ * The encoding used is the one set for the FieldType in Data. Except for the
+ * pairwise encoding, the encodings use auxiliary variables, and so the
+ * clauses are only equisatisfiable with the constraint. This is sufficient
+ * as long as the clauses are only used as the consequent of an implication,
+ * as in the predefined constraints, since the auxiliary variables can then
+ * always be chosen to satisfy the clauses when the constraint holds. They
+ * must not be negated, since the negation of equisatisfiable clauses need
+ * not represent the negation of the constraint.
  *
  * @param[in]  course     The course
  * @param[in]  fieldType  The field type
@@ -241,14 +517,190 @@ Clauses ConstraintEncoder::hasAtLeastOneFieldValueTrue(int course,
  */
 Clauses ConstraintEncoder::hasAtMostOneFieldValueTrue(int course,
                                                       FieldType fieldType) {
-  std::vector<Var> varsToUse = getAllowedVars(course, fieldType);
-  Clauses result;
+  std::vector<Lit> lits;
   for (unsigned i = 0; i < vars[course][fieldType].size(); i++) {
-    for (unsigned j = i + 1; j < vars[course][fieldType].size(); j++) {
-      Clauses first(vars[course][fieldType][i]);
-      Clauses second(vars[course][fieldType][j]);
-      Clauses negSecond = ~second;
-      result.addClauses(~first | negSecond);
+    if (vars[course][fieldType][i] != timetabler->data.falseVar) {
+      lits.push_back(mkLit(vars[course][fieldType][i], false));
+    }
+  }
+  int varCountBefore = timetabler->getVarCount();
+  Clauses result;
+  switch (getAtMostOneEncoding(fieldType, lits.size())) {
+    case AtMostOneEncoding::sequential:
+      result = atMostOneSequential(lits);
+      break;
+    case AtMostOneEncoding::commander:
+      result = atMostOneCommander(lits);
+      break;
+    case AtMostOneEncoding::bimander:
+      result = atMostOneBimander(lits);
+      break;
+    default:
+      result = atMostOnePairwise(lits);
+  }
+  atMostOneVarCount += timetabler->getVarCount() - varCountBefore;
+  atMostOneClauseCount += result.size();
+  atMostOnePairCount += lits.size() * (lits.size() - 1) / 2;
+  return result;
+}
+
+/**
+ * @brief      Gets the at most one encoding to be used for a FieldType.
+ *
+ * If the encoding for the FieldType is automatic, the pairwise encoding is
+ * used for a small number of field values, since it needs no auxiliary
+ * variables. The sequential encoding is used for a moderate number, since its
+ * number of clauses is linear. For a large number, the bimander encoding is
+ * used, since its number of auxiliary variables is logarithmic.
+ *
+ * @param[in]  fieldType   The field type
+ * @param[in]  valueCount  The number of field values
+ *
+ * @return     The at most one encoding
+ */
+AtMostOneEncoding ConstraintEncoder::getAtMostOneEncoding(FieldType fieldType,
+                                                          unsigned valueCount) {
+  AtMostOneEncoding encoding =
+      timetabler->data.atMostOneEncodings[fieldType];
+  if (encoding != AtMostOneEncoding::automatic) {
+    return encoding;
+  }
+  if (valueCount <= Global::PAIRWISE_AT_MOST_ONE_LIMIT) {
+    return AtMostOneEncoding::pairwise;
+  }
+  if (valueCount <= Global::SEQUENTIAL_AT_MOST_ONE_LIMIT) {
+    return AtMostOneEncoding::sequential;
+  }
+  return AtMostOneEncoding::bimander;
+}
+
+/**
+ * @brief      Gives Clauses that represent that at most one of the given
+ * literals is True, using a binary clause for every pair of literals.
+ *
+ * @param[in]  lits  The literals
+ *
+ * @return     A Clauses object representing the condition
+ */
+Clauses ConstraintEncoder::atMostOnePairwise(const std::vector<Lit> &lits) {
+  Clauses result;
+  for (unsigned i = 0; i < lits.size(); i++) {
+    for (unsigned j = i + 1; j < lits.size(); j++) {
+      CClause notBoth;
+      notBoth.addLits(~lits[i], ~lits[j]);
+      result.addClauses(notBoth);
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief      Gives Clauses that represent that at most one of the given
+ * literals is True, using a sequential counter.
+ *
+ * An auxiliary variable s_i is True if one of the first i literals is True.
+ * This uses n-1 auxiliary variables and 3n-4 clauses for n literals.
+ *
+ * @param[in]  lits  The literals
+ *
+ * @return     A Clauses object representing the condition
+ */
+Clauses ConstraintEncoder::atMostOneSequential(const std::vector<Lit> &lits) {
+  Clauses result;
+  Lit previousCounter = lit_Undef;
+  for (unsigned i = 0; i < lits.size(); i++) {
+    if (previousCounter != lit_Undef) {
+      CClause noEarlierLit;
+      noEarlierLit.addLits(~lits[i], ~previousCounter);
+      result.addClauses(noEarlierLit);
+    }
+    if (i + 1 < lits.size()) {
+      Lit counter = timetabler->newLiteral();
+      CClause countLit;
+      countLit.addLits(~lits[i], counter);
+      result.addClauses(countLit);
+      if (previousCounter != lit_Undef) {
+        CClause countEarlierLit;
+        countEarlierLit.addLits(~previousCounter, counter);
+        result.addClauses(countEarlierLit);
+      }
+      previousCounter = counter;
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief      Gives Clauses that represent that at most one of the given
+ * literals is True, using the commander encoding.
+ *
+ * The literals are split into groups of three. Within a group, at most one
+ * literal is True, and each literal implies the commander variable of the
+ * group. At most one commander variable is then True, which is encoded
+ * recursively until few enough commander variables remain to use the
+ * pairwise encoding.
+ *
+ * @param[in]  lits  The literals
+ *
+ * @return     A Clauses object representing the condition
+ */
+Clauses ConstraintEncoder::atMostOneCommander(const std::vector<Lit> &lits) {
+  if (lits.size() <= Global::PAIRWISE_AT_MOST_ONE_LIMIT) {
+    return atMostOnePairwise(lits);
+  }
+  const unsigned groupSize = 3;
+  Clauses result;
+  std::vector<Lit> commanders;
+  for (unsigned i = 0; i < lits.size(); i += groupSize) {
+    std::vector<Lit> group(lits.begin() + i,
+                           lits.begin() + std::min(i + groupSize,
+                                                   (unsigned)lits.size()));
+    Lit commander = timetabler->newLiteral();
+    result.addClauses(atMostOnePairwise(group));
+    for (Lit lit : group) {
+      CClause commanderIfLit;
+      commanderIfLit.addLits(~lit, commander);
+      result.addClauses(commanderIfLit);
+    }
+    commanders.push_back(commander);
+  }
+  result.addClauses(atMostOneCommander(commanders));
+  return result;
+}
+
+/**
+ * @brief      Gives Clauses that represent that at most one of the given
+ * literals is True, using the bimander encoding.
+ *
+ * The literals are split into pairs. Within a pair, at most one literal is
+ * True, and each literal implies the binary representation of the index of
+ * its pair, given by auxiliary variables. Since there is only one such
+ * representation, all True literals must belong to the same pair. This uses
+ * about log(n/2) auxiliary variables and n log(n/2) clauses for n literals.
+ *
+ * @param[in]  lits  The literals
+ *
+ * @return     A Clauses object representing the condition
+ */
+Clauses ConstraintEncoder::atMostOneBimander(const std::vector<Lit> &lits) {
+  const unsigned groupSize = 2;
+  unsigned groupCount = (lits.size() + groupSize - 1) / groupSize;
+  std::vector<Lit> bits;
+  while ((1u << bits.size()) < groupCount) {
+    bits.push_back(timetabler->newLiteral());
+  }
+  Clauses result;
+  for (unsigned i = 0; i < groupCount; i++) {
+    std::vector<Lit> group(
+        lits.begin() + i * groupSize,
+        lits.begin() + std::min((i + 1) * groupSize, (unsigned)lits.size()));
+    result.addClauses(atMostOnePairwise(group));
+    for (Lit lit : group) {
+      for (unsigned j = 0; j < bits.size(); j++) {
+        CClause bitIfLit;
+        bitIfLit.addLits(~lit, ((i >> j) & 1) ? bits[j] : ~bits[j]);
+        result.addClauses(bitIfLit);
+      }
     }
   }
   return result;
@@ -260,8 +712,9 @@ Clauses ConstraintEncoder::hasAtMostOneFieldValueTrue(int course,
  *
  * This is useful for the case of Classroom, where variables which represent
  * classrooms with size smaller than the class size of a Course are not
- * considered for that Course. For other FieldType values, all variables
- * are returned.
+ * considered for that Course. Variables of field values fixed to False are
+ * never returned, and for other FieldType values, all other variables are
+ * returned.
  *
  * @param[in]  course     The course
  * @param[in]  fieldType  The field type
@@ -272,14 +725,14 @@ std::vector<Var> ConstraintEncoder::getAllowedVars(int course,
                                                    FieldType fieldType) {
   std::vector<Var> varsToUse;
   varsToUse.clear();
-  if (fieldType != FieldType::classroom) {
-    varsToUse = vars[course][fieldType];
-  } else {
-    for (unsigned i = 0; i < vars[course][fieldType].size(); i++) {
-      if (timetabler->data.courses[course].getClassSize() <=
-          timetabler->data.classrooms[i].getSize()) {
-        varsToUse.push_back(vars[course][fieldType][i]);
-      }
+  for (unsigned i = 0; i < vars[course][fieldType].size(); i++) {
+    if (vars[course][fieldType][i] == timetabler->data.falseVar) {
+      continue;
+    }
+    if (fieldType != FieldType::classroom ||
+        timetabler->data.courses[course].getClassSize() <=
+            timetabler->data.classrooms[i].getSize()) {
+      varsToUse.push_back(vars[course][fieldType][i]);
     }
   }
   return varsToUse;
@@ -416,3 +869,29 @@ Clauses ConstraintEncoder::hasFieldTypeListedValues(
   Clauses result(resultClause);
   return result;
 }
+
+/**
+ * @brief      Displays the number of variables and clauses used by the
+ * encodings.
+ *
+ * The at most one encodings are compared with encoding every pair of field
+ * values as a disjunction of Clauses, which takes four auxiliary variables
+ * and nine clauses per pair. The reuse of cached subformulas is also shown.
+ */
+void ConstraintEncoder::displayEncodingStatistics() {
+  LOG(INFO) << "At most one constraints: " << atMostOneVarCount
+            << " auxiliary variables and " << atMostOneClauseCount
+            << " clauses, instead of " << 4 * atMostOnePairCount
+            << " auxiliary variables and " << 9 * atMostOnePairCount
+            << " clauses";
+  LOG(INFO) << "Cached subformulas: " << cacheMissCount << " encoded, "
+            << cacheHitCount << " reused";
+}
+
+/**
+ * @brief      Gets the number of times a cached subformula was reused instead
+ * of being encoded again.
+ *
+ * @return     The number of cache hits
+ */
+unsigned ConstraintEncoder::getCacheHitCount() { return cacheHitCount; }
@@ -0,0 +1,218 @@
+#include "csv_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief      Constructs the CsvReader object, maps the file and reads its
+ * header.
+ *
+ * @param[in]  file       The CSV file
+ * @param[in]  separator  The separator between the fields of a row
+ */
+CsvReader::CsvReader(std::string file, char separator)
+    : file(file),
+      begin(NULL),
+      cursor(NULL),
+      end(NULL),
+      separator(separator),
+      lineNumber(0),
+      nextLineNumber(1) {
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    error = "Could not open CSV file " + file;
+    return;
+  }
+  struct stat status;
+  if (fstat(fd, &status) < 0) {
+    close(fd);
+    error = "Could not read CSV file " + file;
+    return;
+  }
+  size_t size = static_cast<size_t>(status.st_size);
+  if (size > 0) {
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      close(fd);
+      error = "Could not map CSV file " + file;
+      return;
+    }
+    begin = static_cast<const char *>(mapping);
+    cursor = begin;
+    end = begin + size;
+  }
+  close(fd);
+  if (split()) {
+    for (unsigned i = 0; i < fields.size(); i++) {
+      header.push_back(getField(i));
+    }
+  }
+}
+
+/**
+ * @brief      Destroys the CsvReader object, and unmaps the file.
+ */
+CsvReader::~CsvReader() {
+  if (begin != NULL) {
+    munmap(const_cast<char *>(begin), end - begin);
+  }
+}
+
+/**
+ * @brief      Splits the next row of the file into its fields.
+ *
+ * @return     True, if there was a row, and false at the end of the file or
+ * after an error
+ */
+bool CsvReader::split() {
+  fields.clear();
+  while (cursor < end && (*cursor == '\n' || *cursor == '\r')) {
+    if (*cursor == '\n') {
+      nextLineNumber++;
+    }
+    cursor++;
+  }
+  if (cursor >= end) {
+    return false;
+  }
+  lineNumber = nextLineNumber;
+  const char *fieldStart = cursor;
+  bool quoted = false;
+  while (true) {
+    // the end of the file ends the last row as a line break would
+    char c = (cursor < end) ? *cursor : '\n';
+    if (quoted) {
+      if (cursor == end) {
+        error = "Unterminated quoted field on line " +
+                std::to_string(lineNumber) + " of " + file;
+        fields.clear();
+        return false;
+      }
+      if (c == '"') {
+        quoted = false;
+      } else if (c == '\n') {
+        nextLineNumber++;
+      }
+      cursor++;
+    } else if (c == '"') {
+      quoted = true;
+      cursor++;
+    } else if (c == separator || c == '\n') {
+      const char *fieldEnd = cursor;
+      if (c == '\n' && fieldEnd > fieldStart && fieldEnd[-1] == '\r') {
+        fieldEnd--;
+      }
+      fields.push_back(std::make_pair(fieldStart, fieldEnd));
+      if (cursor < end) {
+        cursor++;
+      }
+      if (c == '\n') {
+        nextLineNumber++;
+        return true;
+      }
+      fieldStart = cursor;
+    } else {
+      cursor++;
+    }
+  }
+}
+
+/**
+ * @brief      Gets the index of a column from its name in the header.
+ *
+ * @param[in]  name  The name of the column
+ *
+ * @return     The index of the column, or -1 if no column has the name
+ */
+int CsvReader::getColumn(const std::string &name) {
+  for (unsigned i = 0; i < header.size(); i++) {
+    if (header[i] == name) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief      Reads the next row of the file.
+ *
+ * @return     True, if there was a row, and false at the end of the file or
+ * after an error
+ */
+bool CsvReader::readRow() { return split(); }
+
+/**
+ * @brief      Gets a field of the current row, without its enclosing double
+ * quotes.
+ *
+ * @param[in]  column  The index of the column
+ *
+ * @return     The field, or an empty string if the column is -1 or the row
+ * has no such column
+ */
+std::string CsvReader::getField(int column) {
+  if (column < 0 || static_cast<unsigned>(column) >= fields.size()) {
+    return "";
+  }
+  const char *start = fields[column].first;
+  const char *stop = fields[column].second;
+  if (std::memchr(start, '"', stop - start) == NULL) {
+    return std::string(start, stop);
+  }
+  std::string field;
+  bool quoted = false;
+  for (const char *p = start; p < stop; p++) {
+    if (*p != '"') {
+      field.push_back(*p);
+    } else if (quoted && p + 1 < stop && p[1] == '"') {
+      field.push_back('"');
+      p++;
+    } else {
+      quoted = !quoted;
+    }
+  }
+  return field;
+}
+
+/**
+ * @brief      Checks if a field of the current row is equal to a value,
+ * without copying the field.
+ *
+ * @param[in]  column  The index of the column
+ * @param[in]  value   The value
+ *
+ * @return     True, if the field is equal to the value
+ */
+bool CsvReader::isField(int column, const char *value) {
+  if (column < 0 || static_cast<unsigned>(column) >= fields.size()) {
+    return value[0] == '\0';
+  }
+  const char *start = fields[column].first;
+  size_t length = fields[column].second - start;
+  if (std::memchr(start, '"', length) != NULL) {
+    return getField(column) == value;
+  }
+  return std::strlen(value) == length &&
+         std::memcmp(start, value, length) == 0;
+}
+
+/**
+ * @brief      Gets the line of the file on which the current row starts.
+ *
+ * @return     The line number, starting from 1
+ */
+unsigned CsvReader::getLineNumber() { return lineNumber; }
+
+/**
+ * @brief      Gets the error met while reading the file, which should be
+ * checked after the reader is constructed and after the last row.
+ *
+ * @return     The error, or an empty string if there was none
+ */
+std::string CsvReader::getError() { return error; }
@@ -6,6 +6,7 @@
 #include <string>
 #include <tao/pegtl.hpp>
 #include <vector>
+#include "clause_sink.h"
 #include "clauses.h"
 #include "global.h"
 #include "utils.h"
@@ -288,91 +289,51 @@ struct action<value> {
   template <typename Input>
   static void apply(const Input &in, Object &obj) {
     std::string val = in.string();
-    bool found = false;
+    Data &data = obj.timetabler->data;
     if (obj.fieldType == FieldValuesType::INSTRUCTOR) {
-      for (unsigned i = 0; i < obj.timetabler->data.instructors.size(); i++) {
-        if (obj.timetabler->data.instructors[i].getName() == val) {
-          found = true;
-          obj.instructorValues.push_back(i);
-          break;
-        }
-      }
-      if (!found) {
+      int index = data.getFieldValueIndex(FieldType::instructor, val);
+      if (index == -1) {
         LOG(ERROR) << "Instructor " << val << " does not exist.";
       }
-      found = false;
+      obj.instructorValues.push_back(index);
     } else if (obj.fieldType == FieldValuesType::COURSE) {
-      for (unsigned i = 0; i < obj.timetabler->data.courses.size(); i++) {
-        if (obj.timetabler->data.courses[i].getName() == val) {
-          found = true;
-          obj.courseValues.push_back(i);
-          break;
-        }
-      }
-      if (!found) {
+      int index = data.getCourseIndex(val);
+      if (index == -1) {
         LOG(ERROR) << "Course " << val << " does not exist.";
       }
-      found = false;
+      obj.courseValues.push_back(index);
     } else if (obj.fieldType == FieldValuesType::SEGMENT) {
-      for (unsigned i = 0; i < obj.timetabler->data.segments.size(); i++) {
-        if (obj.timetabler->data.segments[i].getName() == val) {
-          found = true;
-          obj.segmentValues.push_back(i);
-          break;
-        }
-      }
-      if (!found) {
+      int index = data.getFieldValueIndex(FieldType::segment, val);
+      if (index == -1) {
         LOG(ERROR) << "Segment " << val << " does not exist.";
       }
-      found = false;
+      obj.segmentValues.push_back(index);
     } else if (obj.fieldType == FieldValuesType::PROGRAM) {
-      for (unsigned i = 0; i < obj.timetabler->data.programs.size(); i++) {
-        if (obj.timetabler->data.programs[i].getNameWithType() == val) {
-          found = true;
-          obj.programValues.push_back(i);
-          break;
-        }
-      }
-      if (!found) {
+      int index = data.getFieldValueIndex(FieldType::program, val);
+      if (index == -1) {
         LOG(ERROR) << "Program " << val << " does not exist.";
       }
-      found = false;
+      obj.programValues.push_back(index);
     } else if (obj.fieldType == FieldValuesType::ISMINOR) {
-      for (unsigned i = 0; i < obj.timetabler->data.isMinors.size(); i++) {
-        if (obj.timetabler->data.isMinors[i].getName() == val) {
-          found = true;
-          obj.isMinorValues.push_back(i);
-          break;
-        }
-      }
-      if (!found) {
+      int index = data.getFieldValueIndex(FieldType::isMinor, val);
+      if (index == -1) {
         LOG(ERROR) << "IsMinor " << val << " does not exist.";
       }
-      found = false;
+      obj.isMinorValues.push_back(index);
     } else if (obj.fieldType == FieldValuesType::CLASSROOM) {
-      for (unsigned i = 0; i < obj.timetabler->data.classrooms.size(); i++) {
-        if (obj.timetabler->data.classrooms[i].getName() == val) {
-          found = true;
-          obj.classValues.push_back(i);
-          break;
-        }
-      }
-      if (!found) {
+      int index = data.getFieldValueIndex(FieldType::classroom, val);
+      if (index == -1) {
         LOG(ERROR) << "Classroom " << val << " does not exist.";
       }
-      found = false;
+      obj.classValues.push_back(index);
+      data.customFieldValues[FieldType::classroom].insert(index);
     } else if (obj.fieldType == FieldValuesType::SLOT) {
-      for (unsigned i = 0; i < obj.timetabler->data.slots.size(); i++) {
-        if (obj.timetabler->data.slots[i].getName() == val) {
-          found = true;
-          obj.slotValues.push_back(i);
-          break;
-        }
-      }
-      if (!found) {
+      int index = data.getFieldValueIndex(FieldType::slot, val);
+      if (index == -1) {
         LOG(ERROR) << "Slot " << val << " does not exist.";
       }
-      found = false;
+      obj.slotValues.push_back(index);
+      data.customFieldValues[FieldType::slot].insert(index);
     }
   }
 };
@@ -571,10 +532,10 @@ struct action<constraint_unbundle> {
           obj.timetabler->newVar());
       int index = obj.timetabler->data.customConstraintVars.size() - 1;
       if (obj.integer != 0) {
-        Clauses hardConsequent =
-            CClause(obj.timetabler->data.customConstraintVars[index]) >>
-            obj.constraint;
-        obj.timetabler->addClauses(hardConsequent, -1);
+        FormulaClauseSink sink(
+            obj.timetabler,
+            mkLit(obj.timetabler->data.customConstraintVars[index], false), -1);
+        sink.addClauses(obj.constraint);
       }
       obj.timetabler->data.customMap[index] = course;
       obj.timetabler->addHighLevelCustomConstraintClauses(index, obj.integer);
@@ -606,7 +567,6 @@ template <>
 struct action<constraint_bundle> {
   template <typename Input>
   static void apply(const Input &in, Object &obj) {
-    Clauses clauses;
     if (obj.courseExcept) {
       std::vector<int> courseVals;
       for (unsigned i = 0; i < obj.timetabler->data.courses.size(); i++) {
@@ -617,6 +577,13 @@ struct action<constraint_bundle> {
       }
       obj.courseValues = courseVals;
     }
+    obj.timetabler->data.customConstraintVars.push_back(
+        obj.timetabler->newVar());
+    int index = obj.timetabler->data.customConstraintVars.size() - 1;
+    // the clauses for each course are added as soon as they are encoded
+    FormulaClauseSink sink(
+        obj.timetabler,
+        mkLit(obj.timetabler->data.customConstraintVars[index], false), -1);
     for (unsigned i = 0; i < obj.courseValues.size(); i++) {
       int course = obj.courseValues[i];
       Clauses ante, cons, clause;
@@ -626,19 +593,9 @@ struct action<constraint_bundle> {
         cons = ~cons;
       }
       clause = ante >> cons;
-      clauses = clauses & clause;
-    }
-
-    obj.constraint = clauses;
-
-    obj.timetabler->data.customConstraintVars.push_back(
-        obj.timetabler->newVar());
-    int index = obj.timetabler->data.customConstraintVars.size() - 1;
-    if (obj.integer != 0) {
-      Clauses hardConsequent =
-          CClause(obj.timetabler->data.customConstraintVars[index]) >>
-          obj.constraint;
-      obj.timetabler->addClauses(hardConsequent, -1);
+      if (obj.integer != 0) {
+        sink.addClauses(clause);
+      }
     }
     obj.timetabler->addHighLevelCustomConstraintClauses(index, obj.integer);
 
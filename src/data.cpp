@@ -1,6 +1,12 @@
 #include "data.h"
 
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <utility>
+#include <vector>
 #include "global.h"
+#include "utils.h"
 
 /**
  * @brief      Constructs the Data object.
@@ -17,4 +23,415 @@ Data::Data() {
   existingAssignmentWeights[FieldType::instructor] = -1;
   predefinedClausesWeights[PredefinedClauses::coreInMorningTime] = 1;
   predefinedClausesWeights[PredefinedClauses::electiveInNonMorningTime] = 1;
-}
\ No newline at end of file
+  clashEncoding = ClashEncoding::pairwise;
+  atMostOneEncodings.resize(Global::FIELD_COUNT,
+                            AtMostOneEncoding::automatic);
+  disjunctionEncoding = DisjunctionEncoding::polarity;
+  presolve = true;
+  symmetryBreaking = true;
+  twoStage = false;
+  customFieldValues.resize(Global::FIELD_COUNT);
+  fieldValueIndices.resize(Global::FIELD_COUNT);
+  trueVar = var_Undef;
+  falseVar = var_Undef;
+  symmetryBreakingVar = var_Undef;
+  slotTimeUnitCount = 0;
+  segmentTimeUnitCount = 0;
+}
+
+/**
+ * @brief      Splits the Slots and Segments into atomic time units.
+ *
+ * The start and end of every SlotElement are collected as boundaries, and
+ * every interval between two consecutive boundaries that is covered by some
+ * Slot becomes an atomic slot time unit. Every segment ID becomes a segment
+ * unit. A time at which a course is held is then a pair of a segment unit and
+ * an atomic slot time unit. This must be called after the Slots and Segments
+ * have been parsed.
+ */
+void Data::computeTimeUnits() {
+  std::vector<unsigned> boundaries;
+  for (Slot &slot : slots) {
+    for (SlotElement &slotElement : slot.getSlotElements()) {
+      boundaries.push_back(slotElement.getStartMinuteOfWeek());
+      boundaries.push_back(slotElement.getEndMinuteOfWeek());
+    }
+  }
+  std::sort(boundaries.begin(), boundaries.end());
+  boundaries.erase(std::unique(boundaries.begin(), boundaries.end()),
+                   boundaries.end());
+  slotTimeUnits.assign(slots.size(), std::vector<unsigned>());
+  slotTimeUnitCount = 0;
+  for (unsigned i = 0; i + 1 < boundaries.size(); i++) {
+    bool covered = false;
+    for (unsigned j = 0; j < slots.size(); j++) {
+      for (SlotElement &slotElement : slots[j].getSlotElements()) {
+        if (slotElement.getStartMinuteOfWeek() <= boundaries[i] &&
+            boundaries[i + 1] <= slotElement.getEndMinuteOfWeek()) {
+          slotTimeUnits[j].push_back(slotTimeUnitCount);
+          covered = true;
+          break;
+        }
+      }
+    }
+    if (covered) {
+      slotTimeUnitCount++;
+    }
+  }
+
+  segmentTimeUnits.assign(segments.size(), std::vector<unsigned>());
+  segmentTimeUnitCount = 0;
+  if (segments.empty()) {
+    return;
+  }
+  int firstSegment = segments[0].getStartSegment();
+  int lastSegment = segments[0].getEndSegment();
+  for (Segment &segment : segments) {
+    firstSegment = std::min(firstSegment, segment.getStartSegment());
+    lastSegment = std::max(lastSegment, segment.getEndSegment());
+  }
+  segmentTimeUnitCount = lastSegment - firstSegment + 1;
+  for (unsigned i = 0; i < segments.size(); i++) {
+    for (int j = segments[i].getStartSegment();
+         j <= segments[i].getEndSegment(); j++) {
+      segmentTimeUnits[i].push_back(j - firstSegment);
+    }
+  }
+}
+
+/**
+ * @brief      Computes which pairs of Slots and which pairs of Segments
+ * intersect.
+ *
+ * This is done once, so that intersection queries while encoding constraints
+ * and verifying the input do not compare the SlotElements again. This must be
+ * called after the Slots and Segments have been parsed.
+ */
+void Data::computeIntersections() {
+  slotIntersections.assign(slots.size(), std::vector<bool>(slots.size()));
+  intersectingSlots.assign(slots.size(), std::vector<unsigned>());
+  for (unsigned i = 0; i < slots.size(); i++) {
+    for (unsigned j = 0; j < slots.size(); j++) {
+      if (slots[i].isIntersecting(slots[j])) {
+        slotIntersections[i][j] = true;
+        intersectingSlots[i].push_back(j);
+      }
+    }
+  }
+  segmentIntersections.assign(segments.size(),
+                              std::vector<bool>(segments.size()));
+  intersectingSegments.assign(segments.size(), std::vector<unsigned>());
+  for (unsigned i = 0; i < segments.size(); i++) {
+    for (unsigned j = 0; j < segments.size(); j++) {
+      if (segments[i].isIntersecting(segments[j])) {
+        segmentIntersections[i][j] = true;
+        intersectingSegments[i].push_back(j);
+      }
+    }
+  }
+}
+
+/**
+ * @brief      Indexes the field values of every FieldType by their names.
+ *
+ * Programs are indexed by their names with their CourseType, as given by
+ * Program::getNameWithType(). Two field values of a FieldType with the same
+ * name are an error. This must be called after the fields have been parsed.
+ */
+void Data::indexFieldValues() {
+  fieldValueIndices.assign(Global::FIELD_COUNT,
+                           std::unordered_map<std::string, unsigned>());
+  for (int j = 0; j < Global::FIELD_COUNT; j++) {
+    FieldType fieldType = static_cast<FieldType>(j);
+    unsigned valueCount = Utils::getFieldValueCount(fieldType, *this);
+    fieldValueIndices[j].reserve(valueCount);
+    for (unsigned k = 0; k < valueCount; k++) {
+      std::string name = (fieldType == FieldType::program)
+                             ? programs[k].getNameWithType()
+                             : Utils::getFieldName(fieldType, k, *this);
+      if (!fieldValueIndices[j].insert(std::make_pair(name, k)).second) {
+        LOG(ERROR) << "Duplicate " << Utils::getFieldTypeName(fieldType)
+                   << " name " << name;
+      }
+    }
+  }
+}
+
+/**
+ * @brief      Indexes a Course by its name.
+ *
+ * A Course with the same name as an earlier Course is an error. This must be
+ * called as each Course is added.
+ *
+ * @param[in]  course  The index of the Course
+ */
+void Data::indexCourse(unsigned course) {
+  std::string name = courses[course].getName();
+  if (!courseIndices.insert(std::make_pair(name, course)).second) {
+    LOG(ERROR) << "Duplicate Course name " << name;
+  }
+}
+
+/**
+ * @brief      Gets the index of a field value from its name.
+ *
+ * @param[in]  fieldType  The FieldType of the field value
+ * @param[in]  name       The name of the field value
+ *
+ * @return     The index of the field value, or -1 if no field value has the
+ * name
+ */
+int Data::getFieldValueIndex(FieldType fieldType, const std::string &name) {
+  auto it = fieldValueIndices[fieldType].find(name);
+  return (it == fieldValueIndices[fieldType].end()) ? -1 : it->second;
+}
+
+/**
+ * @brief      Gets the index of a Course from its name.
+ *
+ * @param[in]  name  The name of the Course
+ *
+ * @return     The index of the Course, or -1 if no Course has the name
+ */
+int Data::getCourseIndex(const std::string &name) {
+  auto it = courseIndices.find(name);
+  return (it == courseIndices.end()) ? -1 : it->second;
+}
+
+/**
+ * @brief      Finds the field values of every Course that are fixed by hard
+ * unit facts.
+ *
+ * Only facts that hold in every model are used. A field value is fixed to its
+ * existing assignment if the existing assignments of its FieldType are hard,
+ * since such assignments are added as hard unit clauses. A Classroom that is
+ * smaller than the class size of a Course is fixed to False only if the
+ * constraint of exactly one Classroom per Course and the high level variable
+ * that guards it are both hard. Otherwise the constraint may be violated when
+ * that is cheaper, and such a Classroom may then be assigned to the Course. If
+ * presolve is disabled, no field values are fixed. This must be called after
+ * the input has been parsed.
+ *
+ * @return     The number of fixed field values
+ */
+unsigned Data::computeFixedFieldValues() {
+  unsigned fixedCount = 0;
+  fixedFieldValues.assign(courses.size(),
+                          std::vector<std::vector<lbool>>(Global::FIELD_COUNT));
+  for (unsigned i = 0; i < courses.size(); i++) {
+    for (unsigned j = 0; j < Global::FIELD_COUNT; j++) {
+      FieldType fieldType = static_cast<FieldType>(j);
+      unsigned valueCount = Utils::getFieldValueCount(fieldType, *this);
+      std::vector<lbool> &fixed = fixedFieldValues[i][j];
+      fixed.assign(valueCount, l_Undef);
+      if (!presolve) {
+        continue;
+      }
+      if (existingAssignmentWeights[j] < 0 &&
+          i < existingAssignmentVars.size()) {
+        const std::vector<lbool> &existing = existingAssignmentVars[i][j];
+        for (unsigned k = 0; k < valueCount && k < existing.size(); k++) {
+          fixed[k] = existing[k];
+        }
+      }
+      if (fieldType == FieldType::classroom &&
+          predefinedClausesWeights
+                  [PredefinedClauses::exactlyOneClassroomPerCourse] < 0 &&
+          highLevelVarWeights[FieldType::classroom] < 0) {
+        for (unsigned k = 0; k < valueCount; k++) {
+          if (fixed[k] == l_Undef &&
+              courses[i].getClassSize() > classrooms[k].getSize()) {
+            fixed[k] = l_False;
+          }
+        }
+      }
+      for (unsigned k = 0; k < valueCount; k++) {
+        if (fixed[k] != l_Undef) {
+          fixedCount++;
+        }
+      }
+    }
+  }
+  return fixedCount;
+}
+
+/**
+ * @brief      Checks if two values of a time field intersect.
+ *
+ * @param[in]  fieldType  The field type, which is either FieldType::slot or
+ *                        FieldType::segment
+ * @param[in]  value1     The index of the first field value
+ * @param[in]  value2     The index of the second field value
+ *
+ * @return     True if the field values intersect, False otherwise.
+ */
+bool Data::isIntersecting(FieldType fieldType, unsigned value1,
+                          unsigned value2) {
+  assert(fieldType == FieldType::segment || fieldType == FieldType::slot);
+  if (fieldType == FieldType::slot) {
+    return slotIntersections[value1][value2];
+  }
+  return segmentIntersections[value1][value2];
+}
+
+/**
+ * @brief      Gets the values of a time field that intersect a given value.
+ *
+ * @param[in]  fieldType  The field type, which is either FieldType::slot or
+ *                        FieldType::segment
+ * @param[in]  value      The index of the field value
+ *
+ * @return     The indices of the field values that intersect the given value,
+ * in increasing order, including the value itself.
+ */
+const std::vector<unsigned> &Data::getIntersectingValues(FieldType fieldType,
+                                                         unsigned value) {
+  assert(fieldType == FieldType::segment || fieldType == FieldType::slot);
+  if (fieldType == FieldType::slot) {
+    return intersectingSlots[value];
+  }
+  return intersectingSegments[value];
+}
+
+/**
+ * @brief      Finds the classes of interchangeable values of a FieldType.
+ *
+ * Two Classrooms are interchangeable if they have the same size, and two Slots
+ * are interchangeable if they have the same SlotElements and the same kind.
+ * Swapping two such values in a timetable gives a timetable that satisfies
+ * the same constraints at the same cost, unless one of them is named in a
+ * custom constraint, or is assigned or hinted for a Course in the input, so
+ * such values are left out. This must be called after the custom constraints
+ * have been parsed.
+ *
+ * @param[in]  fieldType  The field type, which is either FieldType::classroom
+ *                        or FieldType::slot
+ *
+ * @return     The classes with at least two values, each in increasing order
+ */
+std::vector<std::vector<unsigned>> Data::getInterchangeableValues(
+    FieldType fieldType) {
+  assert(fieldType == FieldType::classroom || fieldType == FieldType::slot);
+  unsigned valueCount = Utils::getFieldValueCount(fieldType, *this);
+  std::map<std::vector<unsigned>, std::vector<unsigned>> classes;
+  for (unsigned k = 0; k < valueCount; k++) {
+    if (customFieldValues[fieldType].count(k) > 0) {
+      continue;
+    }
+    bool assigned = false;
+    for (unsigned i = 0; i < courses.size() && !assigned; i++) {
+      if (i < existingAssignmentVars.size() &&
+          existingAssignmentVars[i][fieldType][k] == l_True) {
+        assigned = true;
+      }
+      if (i < hintValues.size() && k < hintValues[i][fieldType].size() &&
+          hintValues[i][fieldType][k] == l_True) {
+        assigned = true;
+      }
+    }
+    if (assigned) {
+      continue;
+    }
+    // values with the same key are interchangeable
+    std::vector<unsigned> key;
+    if (fieldType == FieldType::classroom) {
+      key.push_back(classrooms[k].getSize());
+    } else {
+      key.push_back(slots[k].isMinorSlot());
+      std::vector<std::pair<unsigned, unsigned>> times;
+      for (SlotElement &slotElement : slots[k].getSlotElements()) {
+        times.push_back(std::make_pair(slotElement.getStartMinuteOfWeek(),
+                                       slotElement.getEndMinuteOfWeek()));
+      }
+      std::sort(times.begin(), times.end());
+      times.erase(std::unique(times.begin(), times.end()), times.end());
+      for (auto &time : times) {
+        key.push_back(time.first);
+        key.push_back(time.second);
+      }
+    }
+    classes[key].push_back(k);
+  }
+  std::vector<std::vector<unsigned>> result;
+  for (auto &valueClass : classes) {
+    if (valueClass.second.size() > 1) {
+      result.push_back(valueClass.second);
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief      Renames the interchangeable values of a FieldType in a timetable
+ * in the order in which they are first used, so that the timetable is kept by
+ * the symmetry breaking clauses.
+ *
+ * @param[in]  fieldType  The field type, which is either FieldType::classroom
+ *                        or FieldType::slot
+ * @param      values     The value of each Course, -1 if it has none
+ */
+void Data::orderInterchangeableValues(FieldType fieldType,
+                                      std::vector<int> &values) {
+  for (const std::vector<unsigned> &valueClass :
+       getInterchangeableValues(fieldType)) {
+    std::vector<int> renamed(Utils::getFieldValueCount(fieldType, *this), -1);
+    unsigned next = 0;
+    for (unsigned i = 0; i < values.size(); i++) {
+      for (unsigned value : valueClass) {
+        if (values[i] == static_cast<int>(value) && renamed[value] == -1) {
+          renamed[value] = valueClass[next++];
+        }
+      }
+    }
+    for (unsigned i = 0; i < values.size(); i++) {
+      if (values[i] != -1 && renamed[values[i]] != -1) {
+        values[i] = renamed[values[i]];
+      }
+    }
+  }
+}
+
+/**
+ * @brief      Gets the time units of a time field that are needed to count
+ * the Courses held at each time.
+ *
+ * A unit is left out if the field values covering it are a subset of the
+ * field values covering another unit, since every Course held in it is then
+ * held in the other unit as well. Of units covered by the same field values,
+ * only the first is kept.
+ *
+ * @param[in]  fieldType  The field type, which is either FieldType::slot or
+ *                        FieldType::segment
+ *
+ * @return     The indices of the units, in increasing order
+ */
+std::vector<unsigned> Data::getMaximalTimeUnits(FieldType fieldType) {
+  assert(fieldType == FieldType::segment || fieldType == FieldType::slot);
+  const std::vector<std::vector<unsigned>> &valueUnits =
+      (fieldType == FieldType::slot) ? slotTimeUnits : segmentTimeUnits;
+  unsigned unitCount = (fieldType == FieldType::slot) ? slotTimeUnitCount
+                                                      : segmentTimeUnitCount;
+  std::vector<std::vector<unsigned>> coveringValues(unitCount);
+  for (unsigned i = 0; i < valueUnits.size(); i++) {
+    for (unsigned unit : valueUnits[i]) {
+      coveringValues[unit].push_back(i);
+    }
+  }
+  std::vector<unsigned> units;
+  for (unsigned i = 0; i < unitCount; i++) {
+    bool dominated = false;
+    for (unsigned j = 0; j < unitCount && !dominated; j++) {
+      if (i == j || !std::includes(coveringValues[j].begin(),
+                                   coveringValues[j].end(),
+                                   coveringValues[i].begin(),
+                                   coveringValues[i].end())) {
+        continue;
+      }
+      dominated = coveringValues[i].size() < coveringValues[j].size() || j < i;
+    }
+    if (!dominated) {
+      units.push_back(i);
+    }
+  }
+  return units;
+}
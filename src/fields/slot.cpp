@@ -1,5 +1,6 @@
 #include "fields/slot.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -9,12 +10,11 @@
 /**
  * @brief      Constructs the Time object.
  *
- * @param[in]  hours    The hours
+ * @param[in]  hours    The hours in the 24 hour format
  * @param[in]  minutes  The minutes
  */
 Time::Time(unsigned hours, unsigned minutes) {
-  this->hours = hours;
-  this->minutes = minutes;
+  this->minutesOfDay = hours * Global::MINUTES_PER_HOUR + minutes;
 }
 
 /**
@@ -24,8 +24,10 @@ Time::Time(unsigned hours, unsigned minutes) {
  *                   A valid input would be "12:30".
  */
 Time::Time(std::string time) {
-  this->hours = std::stoul(time.substr(0, 2));
-  this->minutes = std::stoul(time.substr(3, 5));
+  size_t separator = time.find(':');
+  unsigned hours = std::stoul(time.substr(0, separator));
+  unsigned minutes = std::stoul(time.substr(separator + 1));
+  this->minutesOfDay = hours * Global::MINUTES_PER_HOUR + minutes;
 }
 
 /**
@@ -36,8 +38,7 @@ Time::Time(std::string time) {
  * @return     this Time object
  */
 Time &Time::operator=(const Time &other) {
-  this->hours = other.hours;
-  this->minutes = other.minutes;
+  this->minutesOfDay = other.minutesOfDay;
   return *this;
 }
 
@@ -49,8 +50,8 @@ Time &Time::operator=(const Time &other) {
  *
  * @return     True if identical, False otherwise
  */
-bool Time::operator==(const Time &other) {
-  return (this->hours == other.hours) && (this->minutes == other.minutes);
+bool Time::operator==(const Time &other) const {
+  return this->minutesOfDay == other.minutesOfDay;
 }
 
 /**
@@ -61,12 +62,8 @@ bool Time::operator==(const Time &other) {
  * @return     True if the Time of this object is strictly before the other
  * object, and False otherwise
  */
-bool Time::operator<(const Time &other) {
-  if (this->hours == other.hours) {
-    return this->minutes < other.minutes;
-  } else {
-    return this->hours < other.hours;
-  }
+bool Time::operator<(const Time &other) const {
+  return this->minutesOfDay < other.minutesOfDay;
 }
 
 /**
@@ -77,8 +74,8 @@ bool Time::operator<(const Time &other) {
  * @return     True if this is before or identical to the other object, False
  *             otherwise
  */
-bool Time::operator<=(const Time &other) {
-  return (*this < other) || (*this == other);
+bool Time::operator<=(const Time &other) const {
+  return this->minutesOfDay <= other.minutesOfDay;
 }
 
 /**
@@ -89,7 +86,9 @@ bool Time::operator<=(const Time &other) {
  * @return     True if this is after or identical to the other object, False
  *             otherwise
  */
-bool Time::operator>=(const Time &other) { return !(*this < other); }
+bool Time::operator>=(const Time &other) const {
+  return this->minutesOfDay >= other.minutesOfDay;
+}
 
 /**
  * @brief      Checks if a Time is strictly after another.
@@ -99,7 +98,9 @@ bool Time::operator>=(const Time &other) { return !(*this < other); }
  * @return     True if the Time of this object is strictly after the other
  * object, and False otherwise
  */
-bool Time::operator>(const Time &other) { return !(*this <= other); }
+bool Time::operator>(const Time &other) const {
+  return this->minutesOfDay > other.minutesOfDay;
+}
 
 /**
  * @brief      Gets the time as a string.
@@ -108,10 +109,20 @@ bool Time::operator>(const Time &other) { return !(*this <= other); }
  *
  * @return     The time string.
  */
-std::string Time::getTimeString() {
-  return std::to_string(hours) + ":" + std::to_string(minutes);
+std::string Time::getTimeString() const {
+  return std::to_string(minutesOfDay / Global::MINUTES_PER_HOUR) + ":" +
+         std::to_string(minutesOfDay % Global::MINUTES_PER_HOUR);
 }
 
+/**
+ * @brief      Gets the number of minutes elapsed since midnight.
+ *
+ *             For example, 10 hours and 30 minutes gives 630.
+ *
+ * @return     The minutes since midnight
+ */
+unsigned Time::getMinutesOfDay() const { return minutesOfDay; }
+
 /**
  * @brief      Determines if the Time is a morning time.
  *
@@ -120,11 +131,8 @@ std::string Time::getTimeString() {
  *
  * @return     True if morning time, False otherwise.
  */
-bool Time::isMorningTime() {
-  if (hours >= 0 && hours < 13) {
-    return true;
-  }
-  return false;
+bool Time::isMorningTime() const {
+  return minutesOfDay < Global::MORNING_END_MINUTE;
 }
 
 /**
@@ -134,31 +142,24 @@ bool Time::isMorningTime() {
  * @param      endTime    The end time
  * @param[in]  day        The day
  */
-SlotElement::SlotElement(Time &startTime, Time &endTime, Day day)
-    : startTime(startTime), endTime(endTime) {
-  this->day = day;
+SlotElement::SlotElement(Time &startTime, Time &endTime, Day day) {
+  unsigned dayStart = static_cast<unsigned>(day) * Global::MINUTES_PER_DAY;
+  this->startMinute = dayStart + startTime.getMinutesOfDay();
+  this->endMinute = dayStart + endTime.getMinutesOfDay();
 }
 
 /**
  * @brief      Determines if two slot elements are intersecting.
  *
- * Two slot elements are said to be intersecting if the Day is
- * identical and there is an intersection in the start and end Times.
+ * Two slot elements are said to be intersecting if their intervals of minutes
+ * of the week intersect, which implies that the Day is identical.
  *
  * @param      other  The SlotElement with which the comparison is being made
  *
  * @return     True if intersecting, False otherwise.
  */
-bool SlotElement::isIntersecting(SlotElement &other) {
-  if (this->day != other.day) {
-    return false;
-  }
-  if (this->startTime < other.startTime) {
-    return !(this->endTime <= other.startTime);
-  } else if (this->startTime > other.startTime) {
-    return !(this->startTime >= other.endTime);
-  }
-  return true;
+bool SlotElement::isIntersecting(const SlotElement &other) const {
+  return startMinute < other.endMinute && other.startMinute < endMinute;
 }
 
 /**
@@ -168,7 +169,25 @@ bool SlotElement::isIntersecting(SlotElement &other) {
  *
  * @return     True if morning slot element, False otherwise.
  */
-bool SlotElement::isMorningSlotElement() { return startTime.isMorningTime(); }
+bool SlotElement::isMorningSlotElement() const {
+  return startMinute % Global::MINUTES_PER_DAY < Global::MORNING_END_MINUTE;
+}
+
+/**
+ * @brief      Gets the start of the SlotElement as the number of minutes
+ * elapsed since the start of the week (Monday, 00:00).
+ *
+ * @return     The start minute of the week
+ */
+unsigned SlotElement::getStartMinuteOfWeek() const { return startMinute; }
+
+/**
+ * @brief      Gets the end of the SlotElement as the number of minutes
+ * elapsed since the start of the week (Monday, 00:00).
+ *
+ * @return     The end minute of the week
+ */
+unsigned SlotElement::getEndMinuteOfWeek() const { return endMinute; }
 
 /**
  * @brief      Constructs the Slot object.
@@ -182,6 +201,7 @@ Slot::Slot(std::string name, IsMinor isMinor,
     : isMinor(isMinor) {
   this->name = name;
   this->slotElements = slotElements;
+  updateSlotElements();
 }
 
 /**
@@ -198,23 +218,50 @@ bool Slot::operator==(const Slot &other) { return (this->name == other.name); }
  * @brief      Determines if two Slots are intersecting.
  *
  * Two Slots are said to be intersecting if there exists a pair of SlotElements,
- * one from each Slot, such that the SlotElements are intersecting.
+ * one from each Slot, such that the SlotElements are intersecting. Since the
+ * SlotElements of both Slots are sorted by their start, this is checked by a
+ * single merge of the two lists: the SlotElement which ends first cannot
+ * intersect any later SlotElement of the other Slot.
  *
  * @param      other  The Slot with which the comparison is being made
  *
  * @return     True if intersecting, False otherwise.
  */
-bool Slot::isIntersecting(Slot &other) {
-  for (unsigned i = 0; i < slotElements.size(); i++) {
-    for (unsigned j = 0; j < other.slotElements.size(); j++) {
-      if (slotElements[i].isIntersecting(other.slotElements[j])) {
-        return true;
-      }
+bool Slot::isIntersecting(const Slot &other) const {
+  unsigned i = 0, j = 0;
+  while (i < slotElements.size() && j < other.slotElements.size()) {
+    const SlotElement &element = slotElements[i];
+    const SlotElement &otherElement = other.slotElements[j];
+    if (element.getEndMinuteOfWeek() <= otherElement.getStartMinuteOfWeek()) {
+      i++;
+    } else if (otherElement.getEndMinuteOfWeek() <=
+               element.getStartMinuteOfWeek()) {
+      j++;
+    } else {
+      return true;
     }
   }
   return false;
 }
 
+/**
+ * @brief      Sorts the slot elements by their start, as required by
+ * isIntersecting, and determines if the Slot is a morning Slot.
+ */
+void Slot::updateSlotElements() {
+  std::sort(slotElements.begin(), slotElements.end(),
+            [](const SlotElement &first, const SlotElement &second) {
+              return first.getStartMinuteOfWeek() <
+                     second.getStartMinuteOfWeek();
+            });
+  isMorning = true;
+  for (unsigned i = 0; i < slotElements.size(); i++) {
+    if (!slotElements[i].isMorningSlotElement()) {
+      isMorning = false;
+    }
+  }
+}
+
 /**
  * @brief      Adds a slot element to the Slot.
  *
@@ -222,8 +269,16 @@ bool Slot::isIntersecting(Slot &other) {
  */
 void Slot::addSlotElements(SlotElement slotElement) {
   slotElements.push_back(slotElement);
+  updateSlotElements();
 }
 
+/**
+ * @brief      Gets the slot elements that define the Slot.
+ *
+ * @return     The slot elements
+ */
+std::vector<SlotElement> Slot::getSlotElements() { return slotElements; }
+
 /**
  * @brief      Gets the type under the FieldType enum.
  *
@@ -262,11 +317,4 @@ std::string Slot::getName() { return name; }
  *
  * @return     True if morning slot, False otherwise.
  */
-bool Slot::isMorningSlot() {
-  for (unsigned i = 0; i < slotElements.size(); i++) {
-    if (!slotElements[i].isMorningSlotElement()) {
-      return false;
-    }
-  }
-  return true;
-}
\ No newline at end of file
+bool Slot::isMorningSlot() const { return isMorning; }
@@ -0,0 +1,279 @@
+#include "greedy_scheduler.h"
+
+#include <vector>
+#include "global.h"
+
+using namespace NSPACE;
+
+/**
+ * @brief      Constructs the GreedyScheduler object.
+ *
+ * @param      data  The data of the problem, with the input parsed
+ */
+GreedyScheduler::GreedyScheduler(Data &data) : data(data) {}
+
+/**
+ * @brief      Builds the conflict graph of the Courses.
+ *
+ * Two Courses are adjacent if their Segments intersect, and they have a common
+ * Instructor or a common core Program, so that they cannot be held at an
+ * intersecting time.
+ */
+void GreedyScheduler::buildConflictGraph() {
+  unsigned courseCount = data.courses.size();
+  std::vector<std::vector<int>> corePrograms(courseCount);
+  for (unsigned i = 0; i < courseCount; i++) {
+    for (int program : data.courses[i].getPrograms()) {
+      if (data.programs[program].isCoreProgram()) {
+        corePrograms[i].push_back(program);
+      }
+    }
+  }
+  neighbours.assign(courseCount, std::vector<unsigned>());
+  for (unsigned i = 0; i < courseCount; i++) {
+    for (unsigned j = i + 1; j < courseCount; j++) {
+      if (!data.isIntersecting(FieldType::segment,
+                               data.courses[i].getSegment(),
+                               data.courses[j].getSegment())) {
+        continue;
+      }
+      bool adjacent =
+          data.courses[i].getInstructor() == data.courses[j].getInstructor();
+      for (unsigned k = 0; k < corePrograms[i].size() && !adjacent; k++) {
+        for (unsigned l = 0; l < corePrograms[j].size() && !adjacent; l++) {
+          adjacent = corePrograms[i][k] == corePrograms[j][l];
+        }
+      }
+      if (adjacent) {
+        neighbours[i].push_back(j);
+        neighbours[j].push_back(i);
+      }
+    }
+  }
+}
+
+/**
+ * @brief      Checks if a Slot is allowed for a Course, which is the case if
+ * the Slot is minor exactly when the Course is minor.
+ *
+ * @param[in]  course  The course
+ * @param[in]  slot    The slot
+ *
+ * @return     True if the Slot is allowed, False otherwise
+ */
+bool GreedyScheduler::isAllowedSlot(unsigned course, unsigned slot) {
+  bool minorCourse =
+      data.courses[course].getIsMinor() == MinorType::isMinorCourse;
+  return minorCourse == data.slots[slot].isMinorSlot();
+}
+
+/**
+ * @brief      Gets the number of soft constraints on the time of a Course
+ * that are violated if it is held in a Slot.
+ *
+ * A core Course should be held in a morning Slot, and an elective Course
+ * should not.
+ *
+ * @param[in]  course  The course
+ * @param[in]  slot    The slot
+ *
+ * @return     The number of violated constraints
+ */
+unsigned GreedyScheduler::getSlotPenalty(unsigned course, unsigned slot) {
+  bool core = false;
+  bool elective = false;
+  for (int program : data.courses[course].getPrograms()) {
+    if (data.programs[program].isCoreProgram()) {
+      core = true;
+    } else {
+      elective = true;
+    }
+  }
+  bool morning = data.slots[slot].isMorningSlot();
+  return (core && !morning) + (elective && morning);
+}
+
+/**
+ * @brief      Finds a Classroom for a Course held in a Slot.
+ *
+ * The Classroom must be large enough for the Course and not be used by
+ * another Course at an intersecting time. Among these, the smallest Classroom
+ * is chosen. If the Classroom of the Course is given in the input, only that
+ * Classroom is considered.
+ *
+ * @param[in]  course  The course
+ * @param[in]  slot    The slot
+ *
+ * @return     The index of the Classroom, -1 if there is none
+ */
+int GreedyScheduler::findClassroom(unsigned course, unsigned slot) {
+  std::vector<bool> used(data.classrooms.size(), false);
+  int segment = data.courses[course].getSegment();
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    if (i != course && classrooms[i] != -1 &&
+        data.isIntersecting(FieldType::slot, slots[i], slot) &&
+        data.isIntersecting(FieldType::segment, data.courses[i].getSegment(),
+                            segment)) {
+      used[classrooms[i]] = true;
+    }
+  }
+  int given = data.courses[course].getClassroom();
+  if (given != -1) {
+    return used[given] ? -1 : given;
+  }
+  int best = -1;
+  for (unsigned i = 0; i < data.classrooms.size(); i++) {
+    if (used[i] ||
+        data.classrooms[i].getSize() < data.courses[course].getClassSize()) {
+      continue;
+    }
+    if (best == -1 ||
+        data.classrooms[i].getSize() < data.classrooms[best].getSize()) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief      Gives a Slot and a Classroom to a Course, and rules out the
+ * intersecting Slots for its neighbours.
+ *
+ * @param[in]  course      The course
+ * @param[in]  slot        The slot
+ * @param[in]  classroom   The classroom, -1 if there is none
+ * @param      blocked     Whether each Slot is ruled out for each Course
+ * @param      saturation  The number of Slots ruled out for each Course
+ */
+void GreedyScheduler::assign(unsigned course, unsigned slot, int classroom,
+                             std::vector<std::vector<bool>> &blocked,
+                             std::vector<unsigned> &saturation) {
+  slots[course] = slot;
+  classrooms[course] = classroom;
+  for (unsigned neighbour : neighbours[course]) {
+    for (unsigned other : data.getIntersectingValues(FieldType::slot, slot)) {
+      if (!blocked[neighbour][other]) {
+        blocked[neighbour][other] = true;
+        saturation[neighbour]++;
+      }
+    }
+  }
+}
+
+/**
+ * @brief      Schedules the Courses greedily.
+ *
+ * The Courses with a Slot given in the input are scheduled first. Then the
+ * Course with the most Slots ruled out by its neighbours is scheduled next,
+ * with ties broken by the number of neighbours, and it is given the allowed
+ * Slot with a free Classroom that violates the fewest soft constraints. A
+ * Course for which there is no such Slot is left unscheduled.
+ *
+ * @return     The number of Courses given both a Slot and a Classroom
+ */
+unsigned GreedyScheduler::schedule() {
+  unsigned courseCount = data.courses.size();
+  unsigned slotCount = data.slots.size();
+  buildConflictGraph();
+  slots.assign(courseCount, -1);
+  classrooms.assign(courseCount, -1);
+  std::vector<std::vector<bool>> blocked(courseCount,
+                                         std::vector<bool>(slotCount, false));
+  std::vector<unsigned> saturation(courseCount, 0);
+  std::vector<bool> done(courseCount, false);
+  unsigned scheduled = 0;
+  for (unsigned i = 0; i < courseCount; i++) {
+    int slot = data.courses[i].getSlot();
+    if (slot != -1) {
+      done[i] = true;
+      int classroom = findClassroom(i, slot);
+      assign(i, slot, classroom, blocked, saturation);
+      scheduled += (classroom != -1);
+    }
+  }
+  while (true) {
+    int next = -1;
+    for (unsigned i = 0; i < courseCount; i++) {
+      if (done[i]) {
+        continue;
+      }
+      if (next == -1 || saturation[i] > saturation[next] ||
+          (saturation[i] == saturation[next] &&
+           neighbours[i].size() > neighbours[next].size())) {
+        next = i;
+      }
+    }
+    if (next == -1) {
+      break;
+    }
+    done[next] = true;
+    int bestSlot = -1;
+    int bestClassroom = -1;
+    unsigned bestPenalty = 0;
+    for (unsigned j = 0; j < slotCount; j++) {
+      if (blocked[next][j] || !isAllowedSlot(next, j)) {
+        continue;
+      }
+      unsigned penalty = getSlotPenalty(next, j);
+      if (bestSlot != -1 && penalty >= bestPenalty) {
+        continue;
+      }
+      int classroom = findClassroom(next, j);
+      if (classroom != -1) {
+        bestSlot = j;
+        bestClassroom = classroom;
+        bestPenalty = penalty;
+      }
+    }
+    if (bestSlot != -1) {
+      assign(next, bestSlot, bestClassroom, blocked, saturation);
+      scheduled++;
+    }
+  }
+  if (data.symmetryBreaking) {
+    data.orderInterchangeableValues(FieldType::classroom, classrooms);
+    data.orderInterchangeableValues(FieldType::slot, slots);
+  }
+  return scheduled;
+}
+
+/**
+ * @brief      Gets the field values of the timetable, in the form of
+ * Data::hintValues.
+ *
+ * The values of the Courses that were not given both a Slot and a Classroom
+ * are left out for those FieldTypes.
+ *
+ * @return     The field values, in the form (Course, FieldType, field value)
+ */
+std::vector<std::vector<std::vector<lbool>>> GreedyScheduler::getFieldValues() {
+  auto single = [](unsigned count, int index) {
+    std::vector<lbool> values(count, l_False);
+    if (index >= 0 && index < static_cast<int>(count)) {
+      values[index] = l_True;
+    }
+    return values;
+  };
+  std::vector<std::vector<std::vector<lbool>>> values(
+      data.courses.size(),
+      std::vector<std::vector<lbool>>(Global::FIELD_COUNT));
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    Course &course = data.courses[i];
+    values[i][FieldType::instructor] =
+        single(data.instructors.size(), course.getInstructor());
+    values[i][FieldType::segment] =
+        single(data.segments.size(), course.getSegment());
+    values[i][FieldType::isMinor] = single(
+        data.isMinors.size(), static_cast<int>(course.getIsMinor()));
+    values[i][FieldType::program].assign(data.programs.size(), l_False);
+    for (int program : course.getPrograms()) {
+      values[i][FieldType::program][program] = l_True;
+    }
+    if (slots[i] != -1 && classrooms[i] != -1) {
+      values[i][FieldType::slot] = single(data.slots.size(), slots[i]);
+      values[i][FieldType::classroom] =
+          single(data.classrooms.size(), classrooms[i]);
+    }
+  }
+  return values;
+}
@@ -0,0 +1,635 @@
+#include "instance_cache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "MaxSATFormula.h"
+#include "global.h"
+#include "mtl/Vec.h"
+#include "utils.h"
+
+using namespace NSPACE;
+
+/**
+ * The bytes at the start of every snapshot
+ */
+static const char SNAPSHOT_MAGIC[8] = {'T', 'T', 'S', 'N', 'A', 'P', 'S', 'H'};
+
+/**
+ * @brief      Adds bytes to a 64 bit FNV-1a hash.
+ *
+ * @param      hash   The hash
+ * @param[in]  bytes  The bytes
+ * @param[in]  size   The number of bytes
+ */
+static void addToHash(uint64_t &hash, const char *bytes, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    hash ^= static_cast<unsigned char>(bytes[i]);
+    hash *= 1099511628211ULL;
+  }
+}
+
+/**
+ * @brief      Constructs the InstanceCache object, and computes the hash of
+ * the input files.
+ *
+ * The hash is the 64 bit FNV-1a hash of the contents of the files, each
+ * followed by its length so that the files cannot run into each other. A file
+ * that cannot be read is hashed as if it were empty.
+ *
+ * @param      timetabler  The timetabler
+ * @param[in]  directory   The directory in which the snapshots are kept
+ * @param[in]  files       The input files, with empty names for the files
+ *                         that are not given
+ */
+InstanceCache::InstanceCache(Timetabler *timetabler, std::string directory,
+                             const std::vector<std::string> &files)
+    : timetabler(timetabler), cursor(NULL), end(NULL), truncated(false) {
+  key = 14695981039346656037ULL;
+  auto hash = [this](const char *bytes, size_t size) {
+    addToHash(key, bytes, size);
+  };
+  unsigned version = Global::SNAPSHOT_VERSION;
+  hash(reinterpret_cast<const char *>(&version), sizeof(version));
+  for (const std::string &file : files) {
+    std::string contents;
+    if (file != "") {
+      std::ifstream in(file, std::ios::binary);
+      std::ostringstream stream;
+      stream << in.rdbuf();
+      contents = stream.str();
+    }
+    uint64_t size = contents.size();
+    hash(contents.data(), contents.size());
+    hash(reinterpret_cast<const char *>(&size), sizeof(size));
+  }
+  std::ostringstream name;
+  name << directory << "/" << std::hex << std::setw(16) << std::setfill('0')
+       << key << ".snapshot";
+  snapshotFile = name.str();
+}
+
+/**
+ * @brief      Appends bytes to the snapshot being written.
+ *
+ * @param[in]  bytes  The bytes
+ * @param[in]  size   The number of bytes
+ */
+void InstanceCache::putBytes(const void *bytes, size_t size) {
+  buffer.append(static_cast<const char *>(bytes), size);
+}
+
+/**
+ * @brief      Reads bytes from the snapshot being read, or zeros if it ends
+ * early.
+ *
+ * @param      bytes  The bytes
+ * @param[in]  size   The number of bytes
+ */
+void InstanceCache::getBytes(void *bytes, size_t size) {
+  if (truncated || static_cast<size_t>(end - cursor) < size) {
+    truncated = true;
+    std::memset(bytes, 0, size);
+    return;
+  }
+  std::memcpy(bytes, cursor, size);
+  cursor += size;
+}
+
+/**
+ * @brief      Writes a value of a trivially copyable type.
+ *
+ * @param[in]  value  The value
+ *
+ * @tparam     T      The type of the value
+ */
+template <typename T>
+void InstanceCache::put(const T &value) {
+  putBytes(&value, sizeof(T));
+}
+
+/**
+ * @brief      Writes a string, preceded by its length.
+ *
+ * @param[in]  value  The string
+ */
+void InstanceCache::put(const std::string &value) {
+  put<uint64_t>(value.size());
+  putBytes(value.data(), value.size());
+}
+
+/**
+ * @brief      Writes a lifted boolean.
+ *
+ * @param[in]  value  The lifted boolean
+ */
+void InstanceCache::put(const lbool &value) {
+  uint8_t byte = (value == l_True) ? 0 : (value == l_False) ? 1 : 2;
+  put(byte);
+}
+
+/**
+ * @brief      Writes a set, preceded by its size.
+ *
+ * @param[in]  value  The set
+ */
+void InstanceCache::put(const std::set<unsigned> &value) {
+  put(std::vector<unsigned>(value.begin(), value.end()));
+}
+
+/**
+ * @brief      Writes a map, preceded by its size.
+ *
+ * @param[in]  value  The map
+ */
+void InstanceCache::put(const std::map<int, unsigned> &value) {
+  put<uint64_t>(value.size());
+  for (auto &entry : value) {
+    put(entry.first);
+    put(entry.second);
+  }
+}
+
+/**
+ * @brief      Writes a vector, preceded by its size.
+ *
+ * @param[in]  value  The vector
+ *
+ * @tparam     T      The type of the elements
+ */
+template <typename T>
+void InstanceCache::put(const std::vector<T> &value) {
+  put<uint64_t>(value.size());
+  for (const T &element : value) {
+    put(element);
+  }
+}
+
+/**
+ * @brief      Reads a value of a trivially copyable type.
+ *
+ * @param      value  The value
+ *
+ * @tparam     T      The type of the value
+ */
+template <typename T>
+void InstanceCache::get(T &value) {
+  getBytes(&value, sizeof(T));
+}
+
+/**
+ * @brief      Reads a size written before a string or a container, which
+ * cannot be more than the number of bytes left in the snapshot.
+ *
+ * @return     The size
+ */
+size_t InstanceCache::getSize() {
+  uint64_t size = 0;
+  get(size);
+  if (size > static_cast<uint64_t>(end - cursor)) {
+    truncated = true;
+    return 0;
+  }
+  return size;
+}
+
+/**
+ * @brief      Reads a string.
+ *
+ * @param      value  The string
+ */
+void InstanceCache::get(std::string &value) {
+  size_t size = getSize();
+  value.assign(cursor, size);
+  cursor += size;
+}
+
+/**
+ * @brief      Reads a lifted boolean.
+ *
+ * @param      value  The lifted boolean
+ */
+void InstanceCache::get(lbool &value) {
+  uint8_t byte = 0;
+  get(byte);
+  value = lbool(byte);
+}
+
+/**
+ * @brief      Reads a set.
+ *
+ * @param      value  The set
+ */
+void InstanceCache::get(std::set<unsigned> &value) {
+  std::vector<unsigned> elements;
+  get(elements);
+  value = std::set<unsigned>(elements.begin(), elements.end());
+}
+
+/**
+ * @brief      Reads a map.
+ *
+ * @param      value  The map
+ */
+void InstanceCache::get(std::map<int, unsigned> &value) {
+  size_t size = getSize();
+  value.clear();
+  for (size_t i = 0; i < size && !truncated; i++) {
+    int first = 0;
+    unsigned second = 0;
+    get(first);
+    get(second);
+    value[first] = second;
+  }
+}
+
+/**
+ * @brief      Reads a vector.
+ *
+ * @param      value  The vector
+ *
+ * @tparam     T      The type of the elements
+ */
+template <typename T>
+void InstanceCache::get(std::vector<T> &value) {
+  size_t size = getSize();
+  value.assign(size, T());
+  for (size_t i = 0; i < size && !truncated; i++) {
+    get(value[i]);
+  }
+}
+
+/**
+ * @brief      Writes the parsed fields and input, and the variables of Data.
+ */
+void InstanceCache::putData() {
+  Data &data = timetabler->data;
+  put<uint64_t>(data.courses.size());
+  for (Course &course : data.courses) {
+    put(course.getName());
+    put(course.getClassSize());
+    put(course.getInstructor());
+    put(course.getPrograms());
+    put(course.getSegment());
+    put(course.getIsMinor());
+    put(course.getClassroom());
+    put(course.getSlot());
+  }
+  put<uint64_t>(data.instructors.size());
+  for (Instructor &instructor : data.instructors) {
+    put(instructor.getName());
+  }
+  put<uint64_t>(data.classrooms.size());
+  for (Classroom &classroom : data.classrooms) {
+    put(classroom.getName());
+    put(classroom.getSize());
+  }
+  put<uint64_t>(data.programs.size());
+  for (Program &program : data.programs) {
+    put(program.getName());
+    put(program.isCoreProgram());
+  }
+  put<uint64_t>(data.segments.size());
+  for (Segment &segment : data.segments) {
+    put(segment.getStartSegment());
+    put(segment.getEndSegment());
+  }
+  put<uint64_t>(data.slots.size());
+  for (Slot &slot : data.slots) {
+    put(slot.getName());
+    put(slot.isMinorSlot());
+    put<uint64_t>(slot.getSlotElements().size());
+    for (const SlotElement &element : slot.getSlotElements()) {
+      put(element.getStartMinuteOfWeek());
+      put(element.getEndMinuteOfWeek());
+    }
+  }
+  put<uint64_t>(data.isMinors.size());
+  for (IsMinor &isMinor : data.isMinors) {
+    put(isMinor.getMinorType());
+  }
+  put(data.fieldValueVars);
+  put(data.trueVar);
+  put(data.falseVar);
+  put(data.highLevelVars);
+  put(data.predefinedConstraintVars);
+  put(data.customConstraintVars);
+  put(data.existingAssignmentVars);
+  put(data.highLevelVarWeights);
+  put(data.existingAssignmentWeights);
+  put(data.predefinedClausesWeights);
+  put(data.customMap);
+  put(data.clashEncoding);
+  put(data.atMostOneEncodings);
+  put(data.disjunctionEncoding);
+  put(data.presolve);
+  put(data.symmetryBreaking);
+  put(data.symmetryBreakingVar);
+  put(data.twoStage);
+  put(data.customFieldValues);
+}
+
+/**
+ * @brief      Reads the parsed fields and input, and the variables of Data,
+ * and computes the data derived from them.
+ */
+void InstanceCache::getData() {
+  Data &data = timetabler->data;
+  size_t count = getSize();
+  for (size_t i = 0; i < count && !truncated; i++) {
+    std::string name;
+    unsigned classSize;
+    int instructor, segment, classroom, slot;
+    std::vector<int> programs;
+    MinorType isMinor;
+    get(name);
+    get(classSize);
+    get(instructor);
+    get(programs);
+    get(segment);
+    get(isMinor);
+    get(classroom);
+    get(slot);
+    data.courses.push_back(
+        Course(name, classSize, instructor, segment, isMinor, programs));
+    data.courses.back().addClassroom(classroom);
+    data.courses.back().addSlot(slot);
+  }
+  count = getSize();
+  for (size_t i = 0; i < count && !truncated; i++) {
+    std::string name;
+    get(name);
+    data.instructors.push_back(Instructor(name));
+  }
+  count = getSize();
+  for (size_t i = 0; i < count && !truncated; i++) {
+    std::string name;
+    unsigned size;
+    get(name);
+    get(size);
+    data.classrooms.push_back(Classroom(name, size));
+  }
+  count = getSize();
+  for (size_t i = 0; i < count && !truncated; i++) {
+    std::string name;
+    bool core;
+    get(name);
+    get(core);
+    data.programs.push_back(
+        Program(name, core ? CourseType::core : CourseType::elective));
+  }
+  count = getSize();
+  for (size_t i = 0; i < count && !truncated; i++) {
+    int start, end;
+    get(start);
+    get(end);
+    data.segments.push_back(Segment(start, end));
+  }
+  count = getSize();
+  for (size_t i = 0; i < count && !truncated; i++) {
+    std::string name;
+    bool minor;
+    get(name);
+    get(minor);
+    std::vector<SlotElement> elements;
+    size_t elementCount = getSize();
+    for (size_t j = 0; j < elementCount && !truncated; j++) {
+      unsigned start, end;
+      get(start);
+      get(end);
+      unsigned dayStart = start - start % Global::MINUTES_PER_DAY;
+      Time startTime(0, start - dayStart);
+      Time endTime(0, end - dayStart);
+      elements.push_back(SlotElement(
+          startTime, endTime,
+          static_cast<Day>(dayStart / Global::MINUTES_PER_DAY)));
+    }
+    data.slots.push_back(Slot(name, IsMinor(minor), elements));
+  }
+  count = getSize();
+  for (size_t i = 0; i < count && !truncated; i++) {
+    MinorType minorType;
+    get(minorType);
+    data.isMinors.push_back(IsMinor(minorType));
+  }
+  get(data.fieldValueVars);
+  get(data.trueVar);
+  get(data.falseVar);
+  get(data.highLevelVars);
+  get(data.predefinedConstraintVars);
+  get(data.customConstraintVars);
+  get(data.existingAssignmentVars);
+  get(data.highLevelVarWeights);
+  get(data.existingAssignmentWeights);
+  get(data.predefinedClausesWeights);
+  get(data.customMap);
+  get(data.clashEncoding);
+  get(data.atMostOneEncodings);
+  get(data.disjunctionEncoding);
+  get(data.presolve);
+  get(data.symmetryBreaking);
+  get(data.symmetryBreakingVar);
+  get(data.twoStage);
+  get(data.customFieldValues);
+  if (!truncated) {
+    data.computeTimeUnits();
+    data.computeIntersections();
+    data.computeFixedFieldValues();
+    data.indexFieldValues();
+    for (unsigned i = 0; i < data.courses.size(); i++) {
+      data.indexCourse(i);
+    }
+  }
+}
+
+/**
+ * @brief      Writes the clauses of the formula, with each literal written as
+ * twice its variable plus its sign.
+ */
+void InstanceCache::putFormula() {
+  MaxSATFormula *formula = timetabler->getFormula();
+  auto putClause = [this](const vec<Lit> &clause) {
+    put<uint32_t>(clause.size());
+    for (int i = 0; i < clause.size(); i++) {
+      put<uint32_t>(2 * var(clause[i]) + sign(clause[i]));
+    }
+  };
+  put<int32_t>(formula->nVars());
+  put<uint64_t>(formula->nHard());
+  for (int i = 0; i < formula->nHard(); i++) {
+    putClause(formula->getHardClause(i).clause);
+  }
+  put<uint64_t>(formula->nSoft());
+  for (int i = 0; i < formula->nSoft(); i++) {
+    put<uint64_t>(formula->getSoftClause(i).weight);
+    putClause(formula->getSoftClause(i).clause);
+  }
+}
+
+/**
+ * @brief      Reads the clauses of the formula into the formula of the
+ * Timetabler.
+ */
+void InstanceCache::getFormula() {
+  MaxSATFormula *formula = timetabler->getFormula();
+  int32_t varCount = 0;
+  get(varCount);
+  vec<Lit> clause;
+  auto getClause = [this, &clause, varCount]() {
+    uint32_t size = 0;
+    get(size);
+    clause.clear();
+    for (uint32_t i = 0; i < size && !truncated; i++) {
+      uint32_t lit = 0;
+      get(lit);
+      if (static_cast<int32_t>(lit / 2) >= varCount) {
+        truncated = true;
+        return;
+      }
+      clause.push(mkLit(lit / 2, lit % 2));
+    }
+  };
+  while (formula->nVars() < varCount) {
+    timetabler->newVar();
+  }
+  uint64_t count = 0;
+  get(count);
+  for (uint64_t i = 0; i < count && !truncated; i++) {
+    getClause();
+    formula->addHardClause(clause);
+  }
+  get(count);
+  for (uint64_t i = 0; i < count && !truncated; i++) {
+    uint64_t weight = 0;
+    get(weight);
+    getClause();
+    formula->addSoftClause(weight, clause);
+  }
+}
+
+/**
+ * @brief      Loads the snapshot of the input files, if there is one.
+ *
+ * This must be called on a Timetabler with no variables. The snapshot is
+ * ignored if it was written for other inputs or by another version, or if its
+ * length or its checksum does not match its contents, as in a snapshot that
+ * was cut short or damaged. Since the whole snapshot is checked before any of
+ * it is read into the Timetabler, the Timetabler is left unchanged when the
+ * snapshot is ignored, and the instance can be parsed and encoded instead.
+ *
+ * @return     True if the snapshot was loaded, False otherwise
+ */
+bool InstanceCache::load() {
+  int fd = open(snapshotFile.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+  struct stat status;
+  if (fstat(fd, &status) == -1 || status.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  size_t size = status.st_size;
+  void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    return false;
+  }
+  cursor = static_cast<const char *>(mapped);
+  end = cursor + size;
+  truncated = false;
+  char magic[sizeof(SNAPSHOT_MAGIC)];
+  unsigned version = 0;
+  uint64_t snapshotKey = 0;
+  uint64_t length = 0;
+  uint64_t checksum = 0;
+  getBytes(magic, sizeof(magic));
+  get(version);
+  get(snapshotKey);
+  get(length);
+  get(checksum);
+  bool valid =
+      !truncated &&
+      std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0 &&
+      version == Global::SNAPSHOT_VERSION && snapshotKey == key &&
+      length == static_cast<uint64_t>(end - cursor);
+  if (valid) {
+    uint64_t contentsChecksum = 14695981039346656037ULL;
+    addToHash(contentsChecksum, cursor, length);
+    valid = contentsChecksum == checksum;
+  }
+  if (valid) {
+    getData();
+    getFormula();
+  }
+  munmap(mapped, size);
+  cursor = end = NULL;
+  if (!valid) {
+    LOG(WARNING) << "Ignored the snapshot " << snapshotFile;
+    return false;
+  }
+  if (truncated) {
+    // the checksum matched, so the snapshot was written by a build whose
+    // format differs without a change of Global::SNAPSHOT_VERSION
+    LOG(ERROR) << "Snapshot " << snapshotFile << " has an unknown format";
+  }
+  LOG(INFO) << "Loaded the snapshot " << snapshotFile;
+  return true;
+}
+
+/**
+ * @brief      Saves the snapshot of the input files.
+ *
+ * This must be called after all the clauses have been added. The header ends
+ * with the length and the checksum of the rest of the snapshot, which are
+ * filled in once the rest has been written. The snapshot is written to a
+ * temporary file that is then renamed, so that a snapshot that is being
+ * written is never loaded.
+ */
+void InstanceCache::save() {
+  buffer.clear();
+  unsigned version = Global::SNAPSHOT_VERSION;
+  uint64_t length = 0;
+  uint64_t checksum = 14695981039346656037ULL;
+  putBytes(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  put(version);
+  put(key);
+  size_t lengthOffset = buffer.size();
+  put(length);
+  put(checksum);
+  size_t start = buffer.size();
+  putData();
+  putFormula();
+  length = buffer.size() - start;
+  addToHash(checksum, buffer.data() + start, length);
+  std::memcpy(&buffer[lengthOffset], &length, sizeof(length));
+  std::memcpy(&buffer[lengthOffset + sizeof(length)], &checksum,
+              sizeof(checksum));
+  std::string temporaryFile = snapshotFile + ".tmp";
+  std::ofstream out(temporaryFile, std::ios::binary);
+  out.write(buffer.data(), buffer.size());
+  out.close();
+  if (!out || std::rename(temporaryFile.c_str(), snapshotFile.c_str()) != 0) {
+    std::remove(temporaryFile.c_str());
+    LOG(WARNING) << "Could not write the snapshot " << snapshotFile;
+  } else {
+    LOG(INFO) << "Saved the snapshot " << snapshotFile;
+  }
+  buffer.clear();
+  buffer.shrink_to_fit();
+}
+
+/**
+ * @brief      Gets the path of the snapshot of the input files.
+ *
+ * @return     The path of the snapshot
+ */
+std::string InstanceCache::getSnapshotFile() { return snapshotFile; }
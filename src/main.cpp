@@ -1,17 +1,22 @@
 #include <getopt.h>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <vector>
 #include "constraint_adder.h"
 #include "constraint_encoder.h"
 #include "core/Solver.h"
 #include "custom_parser.h"
 #include "global.h"
 #include "global_vars.h"
+#include "instance_cache.h"
 #include "mtl/Vec.h"
 #include "parser.h"
+#include "search_progress.h"
 #include "utils.h"
 #include "version.h"
+#include "wcnf_file.h"
 
 /**
  * @brief      Display information about timetabler
@@ -37,6 +42,19 @@ const struct option long_options[] = {{"help", no_argument, 0, 'h'},
                                       {"custom", required_argument, 0, 'c'},
                                       {"output", required_argument, 0, 'o'},
                                       {"verbosity", required_argument, 0, 'b'},
+                                      {"threads", required_argument, 0, 't'},
+                                      {"time-limit", required_argument, 0, 'l'},
+                                      {"conflict-limit", required_argument, 0,
+                                       'n'},
+                                      {"progress", required_argument, 0, 'p'},
+                                      {"hint", required_argument, 0, 'H'},
+                                      {"decompose", no_argument, 0, 'd'},
+                                      {"lns", no_argument, 0, 'L'},
+                                      {"no-greedy", no_argument, 0, 'G'},
+                                      {"dump-wcnf", required_argument, 0, 'w'},
+                                      {"solve-wcnf", required_argument, 0,
+                                       'W'},
+                                      {"cache", required_argument, 0, 'C'},
                                       {"version", no_argument, 0, 'v'},
                                       {0, 0, 0, 0}};
 
@@ -45,10 +63,21 @@ const struct option long_options[] = {{"help", no_argument, 0, 'h'},
  */
 const std::string option_desc[] = {"display this help",
                                    "fields yaml file",
-                                   "input csv file",
+                                   "input csv file, may be repeated",
                                    "custom constraints file",
                                    "output csv file",
-                                   "specify verbosity level (0-3)"
+                                   "specify verbosity level (0-3)",
+                                   "number of solving and encoding threads",
+                                   "stop the search after the given seconds",
+                                   "stop the search after the given conflicts",
+                                   "write search progress as JSON lines",
+                                   "previous output csv file to start from",
+                                   "solve independent groups of courses apart",
+                                   "improve by large neighbourhood search",
+                                   "do not start from a greedy timetable",
+                                   "write the encoded formula as WCNF",
+                                   "solve a WCNF file instead of the input",
+                                   "directory of encoded instance snapshots",
                                    "display version",
                                    ""};
 
@@ -61,10 +90,24 @@ void display_help(std::string exec = "timetabler") {
   display_meta(true);
   std::cout << "\nUsage:\n";
   std::cout << " " << exec
-            << " -i|--input <input_file>"
+            << " -i|--input <input_file>..."
                " -f|--fields <fields_file>"
                " [-c|--custom <custom_constraints_file>]"
                " -o|--output <output_file>"
+               " [-t|--threads <thread_count>]"
+               " [-l|--time-limit <seconds>]"
+               " [-n|--conflict-limit <conflicts>]"
+               " [-p|--progress <progress_file>]"
+               " [-H|--hint <hint_file>]"
+               " [-d|--decompose]"
+               " [-L|--lns]"
+               " [-G|--no-greedy]"
+               " [-w|--dump-wcnf <wcnf_file>]"
+               " [-C|--cache <cache_dir>]"
+               "\n";
+  std::cout << " " << exec
+            << " -W|--solve-wcnf <wcnf_file>"
+               " [-o|--output <output_file>]"
                "\n\n";
   std::cout << "Options:\n";
   for (int i = 0; long_options[i].name != 0; i++) {
@@ -98,13 +141,21 @@ Timetabler *timetabler;
  * @return     Exit code when program ends
  */
 int main(int argc, char *const *argv) {
-  std::string input_file, fields_file, custom_file, output_file;
+  std::vector<std::string> input_files;
+  std::string fields_file, custom_file, output_file, progress_file, hint_file,
+      dump_wcnf_file, solve_wcnf_file, cache_dir;
   unsigned verbosity = 3;
+  int threads = 1;
+  double timeLimit = 0;
+  long long conflictLimit = 0;
+  bool decompose = false;
+  bool lns = false;
+  bool greedy = true;
 
   while (1) {
     int option_index = 0;
-    int c =
-        getopt_long(argc, argv, "hi:f:c:o:b:v", long_options, &option_index);
+    int c = getopt_long(argc, argv, "hi:f:c:o:b:t:l:n:p:H:dLGw:W:C:v", long_options,
+                        &option_index);
 
     if (c == -1) break;
 
@@ -118,7 +169,7 @@ int main(int argc, char *const *argv) {
         display_meta();
         exit(0);
       case 'i':
-        input_file = std::string(optarg);
+        input_files.push_back(std::string(optarg));
         break;
       case 'f':
         fields_file = std::string(optarg);
@@ -129,9 +180,51 @@ int main(int argc, char *const *argv) {
       case 'o':
         output_file = std::string(optarg);
         break;
+      case 'p':
+        progress_file = std::string(optarg);
+        break;
+      case 'H':
+        hint_file = std::string(optarg);
+        break;
+      case 'd':
+        decompose = true;
+        break;
+      case 'L':
+        lns = true;
+        break;
+      case 'G':
+        greedy = false;
+        break;
+      case 'w':
+        dump_wcnf_file = std::string(optarg);
+        break;
+      case 'W':
+        solve_wcnf_file = std::string(optarg);
+        break;
+      case 'C':
+        cache_dir = std::string(optarg);
+        break;
       case 'b':
         verbosity = std::stoi(optarg);
         break;
+      case 't':
+        threads = std::stoi(optarg);
+        if (threads < 1) {
+          display_error("Number of threads must be at least 1");
+        }
+        break;
+      case 'l':
+        timeLimit = std::stod(optarg);
+        if (timeLimit <= 0) {
+          display_error("Time limit must be positive");
+        }
+        break;
+      case 'n':
+        conflictLimit = std::stoll(optarg);
+        if (conflictLimit <= 0) {
+          display_error("Conflict limit must be positive");
+        }
+        break;
       case '?':
         break;
       default:
@@ -145,35 +238,91 @@ int main(int argc, char *const *argv) {
     display_error("Unrecognised argument: " + std::string(argv[optind]));
   }
 
-  if (input_file == "" || fields_file == "" || output_file == "") {
+  if (solve_wcnf_file == "" &&
+      (input_files.empty() || fields_file == "" || output_file == "")) {
     display_error(
         "Fields filename, input filename and output filename are required.");
   }
 
   timetabler = new Timetabler();
-  Parser parser(timetabler);
-  parser.parseFields(fields_file);
-  parser.parseInput(input_file);
-  if (parser.verify()) {
-    LOG(INFO) << "Input is valid";
+  timetabler->setThreadCount(threads);
+  WcnfFile wcnf(timetabler);
+  if (solve_wcnf_file != "") {
+    wcnf.read(solve_wcnf_file);
   } else {
-    LOG(ERROR) << "Input is invalid";
+    Parser parser(timetabler);
+    std::vector<std::string> files = {fields_file, custom_file, hint_file};
+    files.insert(files.end(), input_files.begin(), input_files.end());
+    InstanceCache cache(timetabler, cache_dir, files);
+    if (cache_dir != "" && cache.load()) {
+      if (hint_file != "") {
+        parser.parseHint(hint_file);
+      }
+    } else {
+      parser.parseFields(fields_file);
+      parser.parseInput(input_files);
+      if (hint_file != "") {
+        parser.parseHint(hint_file);
+      }
+      if (parser.verify()) {
+        LOG(INFO) << "Input is valid";
+      } else {
+        LOG(ERROR) << "Input is invalid";
+      }
+      parser.addVars();
+      ConstraintEncoder encoder(timetabler);
+      ConstraintAdder constraintAdder(&encoder, timetabler);
+      constraintAdder.addConstraints();
+      if (custom_file != "") {
+        parseCustomConstraints(custom_file, &encoder, timetabler);
+        LOG(INFO) << "Custom constraints parsed.";
+      }
+      constraintAdder.addSymmetryBreakingConstraints();
+      encoder.displayEncodingStatistics();
+      timetabler->addHighLevelClauses();
+      timetabler->addExistingAssignments();
+      if (cache_dir != "") {
+        cache.save();
+      }
+    }
+    if (dump_wcnf_file != "") {
+      wcnf.write(dump_wcnf_file);
+    }
   }
-  parser.addVars();
-  ConstraintEncoder encoder(timetabler);
-  ConstraintAdder constraintAdder(&encoder, timetabler);
-  constraintAdder.addConstraints();
-  if (custom_file != "") {
-    parseCustomConstraints(custom_file, &encoder, timetabler);
-    LOG(INFO) << "Custom constraints parsed.";
+  timetabler->setSearchLimits(timeLimit, conflictLimit);
+  timetabler->setDecomposition(decompose);
+  timetabler->setLns(lns);
+  // the greedy timetable needs the parsed courses
+  timetabler->setGreedyStart(greedy && solve_wcnf_file == "");
+  std::ofstream progressStream;
+  if (progress_file != "") {
+    progressStream.open(progress_file);
+    if (!progressStream) {
+      LOG(ERROR) << "Could not open progress file " << progress_file;
+    }
+    timetabler->setProgressCallback(
+        [&progressStream](const SearchProgress &progress) {
+          progressStream << progress.toJson() << std::endl;
+        });
   }
-  timetabler->addHighLevelClauses();
-  timetabler->addExistingAssignments();
   SolverStatus solverStatus = timetabler->solve();
-  timetabler->printResult(solverStatus);
-  if (solverStatus == SolverStatus::Solved ||
-      solverStatus == SolverStatus::HighLevelFailed) {
-    timetabler->writeOutput(output_file);
+  if (solve_wcnf_file != "") {
+    if (solverStatus == SolverStatus::Unsolved) {
+      LOG(WARNING) << "Not Solved";
+    } else {
+      LOG(INFO) << "Cost " << timetabler->getCost() << ", lower bound "
+                << timetabler->getLowerBound()
+                << (timetabler->isOptimal() ? ", optimal" : ", not optimal");
+      if (output_file != "") {
+        wcnf.writeAssignment(output_file);
+      }
+    }
+  } else {
+    timetabler->printResult(solverStatus);
+    if (solverStatus == SolverStatus::Solved ||
+        solverStatus == SolverStatus::HighLevelFailed) {
+      timetabler->writeOutput(output_file);
+    }
   }
   delete timetabler;
   return 0;
@@ -0,0 +1,339 @@
+#include "neighbourhood_search.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "utils.h"
+
+using namespace NSPACE;
+
+/**
+ * @brief      Constructs the NeighbourhoodSearch object, and the workers, each
+ * with an incremental session on its own copy of the formula.
+ *
+ * @param      data         The data of the problem
+ * @param      formula      The formula
+ * @param[in]  workerCount  The number of workers, each run by its own thread
+ */
+NeighbourhoodSearch::NeighbourhoodSearch(Data &data, MaxSATFormula *formula,
+                                         unsigned workerCount)
+    : data(data),
+      formula(formula),
+      timed(false),
+      cost(0),
+      lowerBound(0),
+      optimal(false) {
+  for (unsigned i = 0; i < workerCount; i++) {
+    TSolver *worker = new TSolver(1, _CARD_TOTALIZER_);
+    worker->setConfiguration(i);
+    // the worker owns the copy, and deletes it when it is deleted
+    worker->loadFormula(formula->copyMaxSATFormula());
+    worker->startSession();
+    workers.push_back(worker);
+  }
+}
+
+/**
+ * @brief      Destroys the NeighbourhoodSearch object, and its workers.
+ */
+NeighbourhoodSearch::~NeighbourhoodSearch() {
+  for (unsigned i = 0; i < workers.size(); i++) {
+    delete workers[i];
+  }
+}
+
+/**
+ * @brief      Gets the workers, so that they can be interrupted.
+ *
+ * @return     The workers
+ */
+const std::vector<TSolver *> &NeighbourhoodSearch::getWorkers() {
+  return workers;
+}
+
+/**
+ * @brief      Sets the hint, which is used for the first model if it is still
+ * valid.
+ *
+ * @param[in]  hintLits  The literals of the hint
+ */
+void NeighbourhoodSearch::setHint(const std::vector<Lit> &hintLits) {
+  this->hintLits = hintLits;
+}
+
+/**
+ * @brief      Sets the time at which the search is stopped. Without a
+ * deadline, the search stops once every worker has gone
+ * Global::LNS_STALL_LIMIT neighbourhoods without improvement.
+ *
+ * @param[in]  deadline  The deadline
+ */
+void NeighbourhoodSearch::setDeadline(
+    std::chrono::steady_clock::time_point deadline) {
+  timed = true;
+  this->deadline = deadline;
+}
+
+/**
+ * @brief      Sets the function called with an upper bound report whenever a
+ * better model is found.
+ *
+ * @param[in]  callback  The function
+ */
+void NeighbourhoodSearch::setProgressCallback(ProgressCallback callback) {
+  progressCallback = callback;
+}
+
+/**
+ * @brief      Checks if the deadline of the search has passed.
+ *
+ * @return     True, if the search is timed and the deadline has passed, False
+ * otherwise
+ */
+bool NeighbourhoodSearch::isPastDeadline() {
+  return timed && std::chrono::steady_clock::now() >= deadline;
+}
+
+/**
+ * @brief      Finds a model and improves it by the large neighbourhood
+ * search.
+ *
+ * The initial model is the hint if it is still valid, or else any model of
+ * the hard clauses. Then each worker improves it in its own thread, until the
+ * deadline or until every worker stalls.
+ */
+void NeighbourhoodSearch::search() {
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  std::vector<uint64_t> weights;
+  for (int i = 0; i < formula->nSoft(); i++) {
+    weights.push_back(formula->getSoftClause(i).weight);
+  }
+
+  // the first model only has to satisfy the hard clauses, it is improved by
+  // the neighbourhoods
+  std::vector<lbool> best;
+  optimal = false;
+  lowerBound = 0;
+  if (hintLits.size() > 0) {
+    workers[0]->setHint(hintLits);
+    workers[0]->setConflictLimit(Global::LNS_CONFLICT_LIMIT);
+    best = workers[0]->tResolve(std::vector<Lit>(), weights);
+    workers[0]->setHint(std::vector<Lit>());
+    optimal = workers[0]->isSearchCompleted();
+    lowerBound = workers[0]->getLowerBound();
+  }
+  if (best.size() == 0 && !optimal) {
+    workers[0]->setConflictLimit(0);
+    best = workers[0]->tResolve(std::vector<Lit>(),
+                                std::vector<uint64_t>(weights.size(), 0));
+  }
+  cost = Utils::computeCost(formula, best);
+  std::mutex bestMutex;
+  unsigned neighbourhoodCount = 0;
+  unsigned improvementCount = 0;
+  std::vector<std::thread> threads;
+  for (unsigned w = 0; w < workers.size() && best.size() > 0 && !optimal;
+       w++) {
+    threads.push_back(std::thread([&, w]() {
+      std::mt19937 generator(w);
+      workers[w]->setConflictLimit(Global::LNS_CONFLICT_LIMIT);
+      unsigned stall = 0;
+      for (unsigned i = 0;
+           !isPastDeadline() && (timed || stall < Global::LNS_STALL_LIMIT);
+           i++) {
+        std::vector<lbool> current;
+        uint64_t currentCost;
+        {
+          std::lock_guard<std::mutex> lock(bestMutex);
+          current = best;
+          currentCost = cost;
+          neighbourhoodCount++;
+        }
+        NeighbourhoodType type = static_cast<NeighbourhoodType>(
+            (i + w) % Global::NEIGHBOURHOOD_TYPE_COUNT);
+        std::vector<bool> freed = getNeighbourhood(type, generator, current);
+        std::vector<lbool> candidate =
+            workers[w]->tResolve(getFixedCourseLits(current, freed), weights);
+        uint64_t candidateCost = workers[w]->getUpperBound();
+        if (candidate.size() == 0 || candidateCost >= currentCost) {
+          stall++;
+          continue;
+        }
+        stall = 0;
+        std::lock_guard<std::mutex> lock(bestMutex);
+        if (candidateCost >= cost) {
+          continue;
+        }
+        best = candidate;
+        cost = candidateCost;
+        improvementCount++;
+        if (progressCallback) {
+          SearchProgress progress;
+          progress.type = ProgressEventType::UpperBound;
+          progress.configuration = w;
+          progress.elapsedSeconds = std::chrono::duration<double>(
+                                        std::chrono::steady_clock::now() -
+                                        start)
+                                        .count();
+          progress.upperBound = cost;
+          progress.lowerBound = lowerBound;
+          progress.modelCount = improvementCount + 1;
+          progressCallback(progress);
+        }
+      }
+    }));
+  }
+  for (unsigned i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+  model = best;
+  optimal = optimal || (model.size() > 0 && cost == lowerBound);
+  LOG(INFO) << "Large neighbourhood search improved the cost "
+            << improvementCount << " times in " << neighbourhoodCount
+            << " neighbourhoods";
+}
+
+/**
+ * @brief      Chooses a neighbourhood of courses to free.
+ *
+ * If the chosen kind of neighbourhood has no courses, a random neighbourhood
+ * is used instead.
+ *
+ * @param[in]  type       The kind of neighbourhood
+ * @param      generator  The random number generator of the worker
+ * @param[in]  current    The model the neighbourhood is chosen from
+ *
+ * @return     Whether each course is in the neighbourhood
+ */
+std::vector<bool> NeighbourhoodSearch::getNeighbourhood(
+    NeighbourhoodType type, std::mt19937 &generator,
+    const std::vector<lbool> &current) {
+  unsigned courseCount = data.courses.size();
+  std::vector<bool> freed(courseCount, false);
+  auto isTrue = [&current](Var v) {
+    return v < (int)current.size() && current[v] == l_True;
+  };
+  bool found = false;
+  if (type == NeighbourhoodType::programNeighbourhood &&
+      data.programs.size() > 0) {
+    unsigned program = 2 * (generator() % (data.programs.size() / 2));
+    for (unsigned i = 0; i < courseCount; i++) {
+      const std::vector<Var> &vars = data.fieldValueVars[i][FieldType::program];
+      freed[i] = isTrue(vars[program]) || isTrue(vars[program + 1]);
+      found = found || freed[i];
+    }
+  } else if (type == NeighbourhoodType::instructorNeighbourhood &&
+             data.instructors.size() > 0) {
+    unsigned instructor = generator() % data.instructors.size();
+    for (unsigned i = 0; i < courseCount; i++) {
+      freed[i] =
+          isTrue(data.fieldValueVars[i][FieldType::instructor][instructor]);
+      found = found || freed[i];
+    }
+  } else if (type == NeighbourhoodType::dayNeighbourhood &&
+             data.slots.size() > 0) {
+    std::vector<SlotElement> elements =
+        data.slots[generator() % data.slots.size()].getSlotElements();
+    if (elements.size() > 0) {
+      unsigned day = elements[generator() % elements.size()]
+                         .getStartMinuteOfWeek() /
+                     Global::MINUTES_PER_DAY;
+      std::vector<bool> slotOnDay(data.slots.size(), false);
+      for (unsigned j = 0; j < data.slots.size(); j++) {
+        std::vector<SlotElement> slotElements = data.slots[j].getSlotElements();
+        for (unsigned k = 0; k < slotElements.size(); k++) {
+          if (slotElements[k].getStartMinuteOfWeek() /
+                  Global::MINUTES_PER_DAY ==
+              day) {
+            slotOnDay[j] = true;
+          }
+        }
+      }
+      for (unsigned i = 0; i < courseCount; i++) {
+        for (unsigned j = 0; j < data.slots.size(); j++) {
+          if (slotOnDay[j] &&
+              isTrue(data.fieldValueVars[i][FieldType::slot][j])) {
+            freed[i] = true;
+            found = true;
+          }
+        }
+      }
+    }
+  }
+  if (!found) {
+    std::vector<unsigned> courses(courseCount);
+    for (unsigned i = 0; i < courseCount; i++) {
+      courses[i] = i;
+    }
+    std::shuffle(courses.begin(), courses.end(), generator);
+    for (unsigned i = 0;
+         i < std::min(courseCount, Global::LNS_RANDOM_NEIGHBOURHOOD_SIZE);
+         i++) {
+      freed[courses[i]] = true;
+    }
+  }
+  return freed;
+}
+
+/**
+ * @brief      Gets the literals that fix the field values of the courses
+ * outside a neighbourhood to their values in a model.
+ *
+ * Only the true field values are assumed, the others follow from the
+ * constraints that a course has one value of each field. Field values fixed
+ * by the presolve are left out.
+ *
+ * @param[in]  current  The model
+ * @param[in]  freed    Whether each course is in the neighbourhood
+ *
+ * @return     The literals
+ */
+std::vector<Lit> NeighbourhoodSearch::getFixedCourseLits(
+    const std::vector<lbool> &current, const std::vector<bool> &freed) {
+  std::vector<Lit> lits;
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    if (freed[i]) {
+      continue;
+    }
+    for (int j = 0; j < Global::FIELD_COUNT; j++) {
+      const std::vector<Var> &vars = data.fieldValueVars[i][j];
+      for (unsigned k = 0; k < vars.size(); k++) {
+        if (vars[k] != data.trueVar && vars[k] != data.falseVar &&
+            current[vars[k]] == l_True) {
+          lits.push_back(mkLit(vars[k]));
+        }
+      }
+    }
+  }
+  return lits;
+}
+
+/**
+ * @brief      Gets the best model found by the search.
+ *
+ * @return     The model, which is empty if none was found
+ */
+std::vector<lbool> NeighbourhoodSearch::getModel() { return model; }
+
+/**
+ * @brief      Gets the cost of the best model.
+ *
+ * @return     The cost
+ */
+uint64_t NeighbourhoodSearch::getCost() { return cost; }
+
+/**
+ * @brief      Gets the lower bound proved on the optimal cost.
+ *
+ * @return     The lower bound
+ */
+uint64_t NeighbourhoodSearch::getLowerBound() { return lowerBound; }
+
+/**
+ * @brief      Checks if the best model was proved to be optimal.
+ *
+ * @return     True, if the model is optimal, False otherwise
+ */
+bool NeighbourhoodSearch::isOptimal() { return optimal; }
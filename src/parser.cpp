@@ -1,7 +1,17 @@
 #include "parser.h"
 
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "csv_reader.h"
 #include "utils.h"
 
 /**
@@ -97,6 +107,56 @@ void Parser::parseFields(std::string file) {
     int weight = predefinedWeightNode["weight"].as<int>();
     timetabler->data.predefinedClausesWeights[clauseNo] = weight;
   }
+
+  YAML::Node encodingConfig = config["encoding"];
+  if (encodingConfig && encodingConfig["clash"]) {
+    timetabler->data.clashEncoding = getClashEncodingFromString(
+        encodingConfig["clash"].as<std::string>());
+  }
+  if (encodingConfig && encodingConfig["disjunction"]) {
+    timetabler->data.disjunctionEncoding = getDisjunctionEncodingFromString(
+        encodingConfig["disjunction"].as<std::string>());
+  }
+  if (encodingConfig && encodingConfig["presolve"]) {
+    timetabler->data.presolve = encodingConfig["presolve"].as<bool>();
+  }
+  if (encodingConfig && encodingConfig["symmetry_breaking"]) {
+    timetabler->data.symmetryBreaking =
+        encodingConfig["symmetry_breaking"].as<bool>();
+  }
+  if (encodingConfig && encodingConfig["two_stage"]) {
+    timetabler->data.twoStage = encodingConfig["two_stage"].as<bool>();
+  }
+  if (encodingConfig && encodingConfig["at_most_one"]) {
+    YAML::Node atMostOneConfig = encodingConfig["at_most_one"];
+    if (atMostOneConfig.IsScalar()) {
+      // a single encoding for all the field types
+      AtMostOneEncoding encoding =
+          getAtMostOneEncodingFromString(atMostOneConfig.as<std::string>());
+      timetabler->data.atMostOneEncodings.assign(Global::FIELD_COUNT,
+                                                 encoding);
+    } else {
+      // an encoding for each field type, others remain automatic
+      const std::vector<std::pair<std::string, FieldType>> fieldNames = {
+          {"instructor", FieldType::instructor},
+          {"segment", FieldType::segment},
+          {"is_minor", FieldType::isMinor},
+          {"program", FieldType::program},
+          {"classroom", FieldType::classroom},
+          {"slot", FieldType::slot}};
+      for (auto &fieldName : fieldNames) {
+        if (atMostOneConfig[fieldName.first]) {
+          timetabler->data.atMostOneEncodings[fieldName.second] =
+              getAtMostOneEncodingFromString(
+                  atMostOneConfig[fieldName.first].as<std::string>());
+        }
+      }
+    }
+  }
+
+  timetabler->data.computeTimeUnits();
+  timetabler->data.computeIntersections();
+  timetabler->data.indexFieldValues();
 }
 
 /**
@@ -121,256 +181,587 @@ Day Parser::getDayFromString(std::string day) {
   return Day::Monday;
 }
 
+/**
+ * @brief      Gets the clash encoding from the string as a member of the
+ * ClashEncoding enum.
+ *
+ * For example, the input "time_units" returns ClashEncoding::timeUnits.
+ *
+ * @param[in]  encoding  The encoding as a string
+ *
+ * @return     A member of the ClashEncoding enum, corresponding to the
+ * encoding the string represented
+ */
+ClashEncoding Parser::getClashEncodingFromString(std::string encoding) {
+  if (encoding == "pairwise") return ClashEncoding::pairwise;
+  if (encoding == "time_units") return ClashEncoding::timeUnits;
+  LOG(ERROR) << "Invalid clash encoding " << encoding
+             << " (should be 'pairwise' or 'time_units')";
+  return ClashEncoding::pairwise;
+}
+
+/**
+ * @brief      Gets the disjunction encoding from the string as a member of the
+ * DisjunctionEncoding enum.
+ *
+ * For example, the input "polarity" returns DisjunctionEncoding::polarity.
+ *
+ * @param[in]  encoding  The encoding as a string
+ *
+ * @return     A member of the DisjunctionEncoding enum, corresponding to the
+ * encoding the string represented
+ */
+DisjunctionEncoding Parser::getDisjunctionEncodingFromString(
+    std::string encoding) {
+  if (encoding == "equivalence") return DisjunctionEncoding::equivalence;
+  if (encoding == "polarity") return DisjunctionEncoding::polarity;
+  LOG(ERROR) << "Invalid disjunction encoding " << encoding
+             << " (should be 'equivalence' or 'polarity')";
+  return DisjunctionEncoding::polarity;
+}
+
+/**
+ * @brief      Gets the at most one encoding from the string as a member of the
+ * AtMostOneEncoding enum.
+ *
+ * For example, the input "sequential" returns AtMostOneEncoding::sequential.
+ *
+ * @param[in]  encoding  The encoding as a string
+ *
+ * @return     A member of the AtMostOneEncoding enum, corresponding to the
+ * encoding the string represented
+ */
+AtMostOneEncoding Parser::getAtMostOneEncodingFromString(std::string encoding) {
+  if (encoding == "automatic") return AtMostOneEncoding::automatic;
+  if (encoding == "pairwise") return AtMostOneEncoding::pairwise;
+  if (encoding == "sequential") return AtMostOneEncoding::sequential;
+  if (encoding == "commander") return AtMostOneEncoding::commander;
+  if (encoding == "bimander") return AtMostOneEncoding::bimander;
+  LOG(ERROR) << "Invalid at most one encoding " << encoding
+             << " (should be 'automatic', 'pairwise', 'sequential', "
+                "'commander' or 'bimander')";
+  return AtMostOneEncoding::automatic;
+}
+
 /**
  * @brief      Parses the input given in a file.
  *
  * @param[in]  file  The file containig the input
  */
 void Parser::parseInput(std::string file) {
-  csv::Parser parser(file);
-  timetabler->data.existingAssignmentVars.clear();
-  for (unsigned i = 0; i < parser.rowCount(); ++i) {
-    std::vector<std::vector<lbool>> assignmentsThisCourse(Global::FIELD_COUNT);
+  parseInput(std::vector<std::string>(1, file));
+}
 
-    std::string name = parser[i]["name"];
-    std::string classSizeStr = parser[i]["class_size"];
-    unsigned classSize = unsigned(std::stoi(classSizeStr));
+/**
+ * @brief      Parses the input given in several files.
+ *
+ * Each file is parsed by a thread of its own, and the Courses of the files
+ * are added in the order of the files. Courses must have different names
+ * across all the files. The threads do not log their errors, since logging an
+ * error exits, so the first error of the first file that has one is logged
+ * once all the threads have finished.
+ *
+ * @param[in]  files  The files containing the input
+ */
+void Parser::parseInput(const std::vector<std::string> &files) {
+  Data &data = timetabler->data;
+  std::vector<std::vector<Course>> courses(files.size());
+  std::vector<std::vector<std::vector<std::vector<lbool>>>> assignments(
+      files.size());
+  std::vector<std::string> errors(files.size());
+  auto parseFile = [&](unsigned f) {
+    try {
+      errors[f] = parseInputFile(files[f], courses[f], assignments[f]);
+    } catch (const std::exception &e) {
+      errors[f] = "Could not parse input file " + files[f] + ": " + e.what();
+    }
+  };
+  if (files.size() == 1) {
+    parseFile(0);
+  } else {
+    std::vector<std::thread> threads;
+    for (unsigned f = 0; f < files.size(); f++) {
+      threads.push_back(std::thread(parseFile, f));
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+  }
+  for (unsigned f = 0; f < files.size(); f++) {
+    if (errors[f] != "") {
+      LOG(ERROR) << errors[f];
+    }
+  }
+  data.existingAssignmentVars.clear();
+  for (unsigned f = 0; f < files.size(); f++) {
+    for (unsigned i = 0; i < courses[f].size(); i++) {
+      data.courses.push_back(courses[f][i]);
+      data.indexCourse(data.courses.size() - 1);
+      data.existingAssignmentVars.push_back(assignments[f][i]);
+    }
+  }
+}
 
-    std::string instructorStr = parser[i]["instructor"];
-    int instructor = -1;
-    for (unsigned j = 0; j < timetabler->data.instructors.size(); j++) {
-      if (timetabler->data.instructors[j].getName() == instructorStr) {
-        instructor = j;
-        assignmentsThisCourse[FieldType::instructor].push_back(l_True);
-        continue;
-      }
-      assignmentsThisCourse[FieldType::instructor].push_back(l_False);
+/**
+ * @brief      Parses the Courses of an input file, without adding them to
+ * Data.
+ *
+ * The columns are looked up once from the header. The name, class_size,
+ * instructor and segment columns are required, and a missing is_minor,
+ * Program, classroom or slot column is read as empty in every row.
+ *
+ * Since it may be run by a thread other than the main thread, it stops at the
+ * first error and returns it instead of logging it.
+ *
+ * @param[in]  file         The file containing the input
+ * @param      courses      The Courses of the file
+ * @param      assignments  The existing assignments of each Course of the
+ *                          file, as in Data::existingAssignmentVars
+ *
+ * @return     The first error in the file, naming the file and the line, or
+ * an empty string if there was none
+ */
+std::string Parser::parseInputFile(
+    std::string file, std::vector<Course> &courses,
+    std::vector<std::vector<std::vector<lbool>>> &assignments) {
+  Data &data = timetabler->data;
+  CsvReader reader(file);
+  if (reader.getError() != "") {
+    return reader.getError();
+  }
+  auto lineError = [&reader, &file](const std::string &error) {
+    return "Input contains " + error + " on line " +
+           std::to_string(reader.getLineNumber()) + " of " + file;
+  };
+  std::vector<int> requiredColumns;
+  for (const char *name : {"name", "class_size", "instructor", "segment"}) {
+    requiredColumns.push_back(reader.getColumn(name));
+    if (requiredColumns.back() == -1) {
+      return "Input file " + file + " has no column " + name;
     }
+  }
+  int nameColumn = requiredColumns[0];
+  int classSizeColumn = requiredColumns[1];
+  int instructorColumn = requiredColumns[2];
+  int segmentColumn = requiredColumns[3];
+  int isMinorColumn = reader.getColumn("is_minor");
+  int classroomColumn = reader.getColumn("classroom");
+  int slotColumn = reader.getColumn("slot");
+  std::vector<int> programColumns;
+  for (unsigned j = 0; j < data.programs.size(); j += 2) {
+    programColumns.push_back(reader.getColumn(data.programs[j].getName()));
+  }
+  while (reader.readRow()) {
+    std::vector<std::vector<lbool>> assignmentsThisCourse(Global::FIELD_COUNT);
+
+    std::string name = reader.getField(nameColumn);
+    std::string classSizeStr = reader.getField(classSizeColumn);
+    unsigned classSize;
+    try {
+      classSize = unsigned(std::stoi(classSizeStr));
+    } catch (const std::logic_error &) {
+      return lineError("invalid class size");
+    }
+
+    int instructor = data.getFieldValueIndex(
+        FieldType::instructor, reader.getField(instructorColumn));
     if (instructor == -1) {
-      LOG(ERROR) << "Input contains invalid Instructor name";
-    }
-    std::string segmentStr = parser[i]["segment"];
-    int segment = -1;
-    for (unsigned j = 0; j < timetabler->data.segments.size(); j++) {
-      if (timetabler->data.segments[j].getName() == segmentStr) {
-        segment = j;
-        assignmentsThisCourse[FieldType::segment].push_back(l_True);
-        continue;
-      }
-      assignmentsThisCourse[FieldType::segment].push_back(l_False);
+      return lineError("invalid Instructor name");
     }
+    assignmentsThisCourse[FieldType::instructor].assign(
+        data.instructors.size(), l_False);
+    assignmentsThisCourse[FieldType::instructor][instructor] = l_True;
+    int segment = data.getFieldValueIndex(FieldType::segment,
+                                          reader.getField(segmentColumn));
     if (segment == -1) {
-      LOG(ERROR) << "Input contains invalid Segment name";
+      return lineError("invalid Segment name");
     }
-    std::string isMinorStr = parser[i]["is_minor"];
+    assignmentsThisCourse[FieldType::segment].assign(data.segments.size(),
+                                                     l_False);
+    assignmentsThisCourse[FieldType::segment][segment] = l_True;
     MinorType isMinor = MinorType::isMinorCourse;
-    if (isMinorStr == "Yes" || isMinorStr == "Y") {
+    if (reader.isField(isMinorColumn, "Yes") ||
+        reader.isField(isMinorColumn, "Y")) {
       isMinor = MinorType::isMinorCourse;
       assignmentsThisCourse[FieldType::isMinor].push_back(l_True);
-    } else if (isMinorStr == "No" || isMinorStr == "N" || isMinorStr == "") {
+    } else if (reader.isField(isMinorColumn, "No") ||
+               reader.isField(isMinorColumn, "N") ||
+               reader.isField(isMinorColumn, "")) {
       isMinor = MinorType::isNotMinorCourse;
       assignmentsThisCourse[FieldType::isMinor].push_back(l_False);
     } else {
-      LOG(ERROR) << "Input contains invalid IsMinor value (should be "
-                    "'Yes' or 'No')";
+      return lineError("invalid IsMinor value (should be 'Yes' or 'No')");
     }
     Course course(name, classSize, instructor, segment, isMinor);
 
-    for (unsigned j = 0; j < timetabler->data.programs.size(); j += 2) {
-      std::string s = timetabler->data.programs[j].getName();
-      if (parser[i][s] == "Core" || parser[i][s] == "C" ||
-          parser[i][s] == "Y") {
+    for (unsigned j = 0; j < data.programs.size(); j += 2) {
+      int column = programColumns[j / 2];
+      if (reader.isField(column, "Core") || reader.isField(column, "C") ||
+          reader.isField(column, "Y")) {
         course.addProgram(j);
         assignmentsThisCourse[FieldType::program].push_back(l_True);
         assignmentsThisCourse[FieldType::program].push_back(l_False);
-      } else if (parser[i][s] == "Elective" || parser[i][s] == "E") {
+      } else if (reader.isField(column, "Elective") ||
+                 reader.isField(column, "E")) {
         course.addProgram(j + 1);
         assignmentsThisCourse[FieldType::program].push_back(l_False);
         assignmentsThisCourse[FieldType::program].push_back(l_True);
-      } else if (parser[i][s] == "No" || parser[i][s] == "N" ||
-                 parser[i][s] == "") {
+      } else if (reader.isField(column, "No") ||
+                 reader.isField(column, "N") || reader.isField(column, "")) {
         assignmentsThisCourse[FieldType::program].push_back(l_False);
         assignmentsThisCourse[FieldType::program].push_back(l_False);
       } else {
-        LOG(ERROR) << "Input contains invalid Program type (should be "
-                      "'Core', 'Elective', or 'No')";
+        return lineError(
+            "invalid Program type (should be 'Core', 'Elective', or 'No')");
       }
     }
 
-    std::string classroomStr = parser[i]["classroom"];
-    std::string slotStr = parser[i]["slot"];
-    bool foundClassroom = false;
-    bool foundSlot = false;
-    assignmentsThisCourse[FieldType::classroom].resize(
-        timetabler->data.classrooms.size(), l_Undef);
-    assignmentsThisCourse[FieldType::slot].resize(timetabler->data.slots.size(),
-                                                  l_Undef);
-    if (classroomStr != "") {
-      for (unsigned j = 0; j < timetabler->data.classrooms.size(); j++) {
-        if (timetabler->data.classrooms[j].getName() == classroomStr) {
-          assignmentsThisCourse[FieldType::classroom][j] = l_True;
-          foundClassroom = true;
-          course.addClassroom(j);
-          continue;
-        }
-        assignmentsThisCourse[FieldType::classroom][j] = l_False;
+    assignmentsThisCourse[FieldType::classroom].resize(data.classrooms.size(),
+                                                       l_Undef);
+    assignmentsThisCourse[FieldType::slot].resize(data.slots.size(), l_Undef);
+    if (!reader.isField(classroomColumn, "")) {
+      int classroom = data.getFieldValueIndex(
+          FieldType::classroom, reader.getField(classroomColumn));
+      if (classroom == -1) {
+        return lineError("invalid Classroom name");
       }
-      if (!foundClassroom) {
-        LOG(ERROR) << "Input contains invalid Classroom name";
+      assignmentsThisCourse[FieldType::classroom].assign(
+          data.classrooms.size(), l_False);
+      assignmentsThisCourse[FieldType::classroom][classroom] = l_True;
+      course.addClassroom(classroom);
+    }
+    if (!reader.isField(slotColumn, "")) {
+      int slot = data.getFieldValueIndex(FieldType::slot,
+                                         reader.getField(slotColumn));
+      if (slot == -1) {
+        return lineError("invalid Slot name");
       }
+      assignmentsThisCourse[FieldType::slot].assign(data.slots.size(),
+                                                    l_False);
+      assignmentsThisCourse[FieldType::slot][slot] = l_True;
+      course.addSlot(slot);
     }
-    if (slotStr != "") {
-      for (unsigned j = 0; j < timetabler->data.slots.size(); j++) {
-        if (timetabler->data.slots[j].getName() == slotStr) {
-          assignmentsThisCourse[FieldType::slot][j] = l_True;
-          foundSlot = true;
-          course.addSlot(j);
-          continue;
+    courses.push_back(course);
+    assignments.push_back(assignmentsThisCourse);
+  }
+  return reader.getError();
+}
+
+/**
+ * @brief      Parses a previous solution, such as an earlier output, as a hint
+ * for the solver.
+ *
+ * The file has the same columns as the output, of which only the name column
+ * is required. Rows are matched to the courses of the input by name, and rows
+ * of unknown courses are ignored. A field whose value is empty or unknown, or
+ * whose column is missing, is not hinted. This must be called after
+ * parseInput().
+ *
+ * @param[in]  file  The file containing the previous solution
+ */
+void Parser::parseHint(std::string file) {
+  Data &data = timetabler->data;
+  CsvReader reader(file);
+  if (reader.getError() != "") {
+    LOG(ERROR) << reader.getError();
+  }
+  int nameColumn = reader.getColumn("name");
+  if (nameColumn == -1) {
+    LOG(ERROR) << "Hint file " << file << " has no column name";
+  }
+  int instructorColumn = reader.getColumn("instructor");
+  int segmentColumn = reader.getColumn("segment");
+  int isMinorColumn = reader.getColumn("is_minor");
+  int classroomColumn = reader.getColumn("classroom");
+  int slotColumn = reader.getColumn("slot");
+  std::vector<int> programColumns;
+  for (unsigned j = 0; j < data.programs.size(); j += 2) {
+    programColumns.push_back(reader.getColumn(data.programs[j].getName()));
+  }
+  data.hintValues.assign(data.courses.size(),
+                         std::vector<std::vector<lbool>>(Global::FIELD_COUNT));
+  unsigned hintedCourses = 0;
+  while (reader.readRow()) {
+    int course = data.getCourseIndex(reader.getField(nameColumn));
+    if (course == -1) {
+      continue;
+    }
+    hintedCourses++;
+    std::vector<std::vector<lbool>> &hint = data.hintValues[course];
+    hint[FieldType::instructor] = getHintValues(
+        FieldType::instructor, reader.getField(instructorColumn));
+    hint[FieldType::segment] =
+        getHintValues(FieldType::segment, reader.getField(segmentColumn));
+    hint[FieldType::isMinor] =
+        getHintValues(FieldType::isMinor, reader.getField(isMinorColumn));
+    hint[FieldType::classroom] = getHintValues(
+        FieldType::classroom, reader.getField(classroomColumn));
+    hint[FieldType::slot] =
+        getHintValues(FieldType::slot, reader.getField(slotColumn));
+    hint[FieldType::program].clear();
+    for (unsigned j = 0; j < data.programs.size(); j += 2) {
+      int column = programColumns[j / 2];
+      if (column == -1) {
+        hint[FieldType::program].push_back(l_Undef);
+        hint[FieldType::program].push_back(l_Undef);
+        continue;
+      }
+      std::string core = data.programs[j].getCourseTypeName();
+      std::string elective = data.programs[j + 1].getCourseTypeName();
+      hint[FieldType::program].push_back(
+          lbool(reader.isField(column, core.c_str())));
+      hint[FieldType::program].push_back(
+          lbool(reader.isField(column, elective.c_str())));
+    }
+  }
+  if (reader.getError() != "") {
+    LOG(ERROR) << reader.getError();
+  }
+  LOG(INFO) << "Hint given for " << hintedCourses << " of "
+            << data.courses.size() << " courses";
+}
+
+/**
+ * @brief      Gets the hinted values of a field, given the name of the hinted
+ * value.
+ *
+ * @param[in]  fieldType  The FieldType of the field
+ * @param[in]  name       The name of the hinted value
+ *
+ * @return     l_True for the value with the given name and l_False for the
+ * others, or l_Undef for all the values if no value has the name
+ */
+std::vector<lbool> Parser::getHintValues(FieldType fieldType,
+                                         std::string name) {
+  Data &data = timetabler->data;
+  unsigned valueCount = Utils::getFieldValueCount(fieldType, data);
+  int value = data.getFieldValueIndex(fieldType, name);
+  if (value == -1) {
+    return std::vector<lbool>(valueCount, l_Undef);
+  }
+  std::vector<lbool> result(valueCount, l_False);
+  result[value] = l_True;
+  return result;
+}
+
+/**
+ * @brief      Finds the pairs of Courses which share a field value and are
+ * held at intersecting times in the input.
+ *
+ * Each Course with a Slot is put into a bucket for every (field value,
+ * segment unit, slot time unit) it covers, so two Courses clash if and only if
+ * they meet in a bucket. A Course is compared only with the Courses already in
+ * its buckets, and a pair meeting in several buckets is reported once, so the
+ * time taken is linear in the number of Courses and of clashes.
+ *
+ * @param[in]  fieldType  FieldType::instructor, FieldType::classroom or
+ *                        FieldType::program, for which only core Programs are
+ *                        considered
+ *
+ * @return     The clashes, as (field value, earlier Course, later Course), in
+ * the order of the later Course
+ */
+std::vector<std::tuple<unsigned, unsigned, unsigned>> Parser::findClashes(
+    FieldType fieldType) {
+  Data &data = timetabler->data;
+  uint64_t courseCount = data.courses.size();
+  uint64_t segmentUnitCount = data.segmentTimeUnitCount;
+  uint64_t slotUnitCount = data.slotTimeUnitCount;
+  std::unordered_map<uint64_t, std::vector<unsigned>> buckets;
+  std::unordered_set<uint64_t> found;
+  std::vector<std::tuple<unsigned, unsigned, unsigned>> clashes;
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    Course &course = data.courses[i];
+    if (course.getSlot() == -1) {
+      continue;
+    }
+    std::vector<unsigned> values;
+    if (fieldType == FieldType::instructor) {
+      values.push_back(course.getInstructor());
+    } else if (fieldType == FieldType::classroom) {
+      if (course.getClassroom() != -1) {
+        values.push_back(course.getClassroom());
+      }
+    } else {
+      for (int program : course.getPrograms()) {
+        if (data.programs[program].isCoreProgram()) {
+          values.push_back(program);
         }
-        assignmentsThisCourse[FieldType::slot][j] = l_False;
       }
-      if (!foundSlot) {
-        LOG(ERROR) << "Input contains invalid Slot name";
+    }
+    for (uint64_t value : values) {
+      for (uint64_t segmentUnit : data.segmentTimeUnits[course.getSegment()]) {
+        for (uint64_t slotUnit : data.slotTimeUnits[course.getSlot()]) {
+          std::vector<unsigned> &bucket =
+              buckets[(value * segmentUnitCount + segmentUnit) *
+                          slotUnitCount +
+                      slotUnit];
+          for (unsigned j : bucket) {
+            if (found.insert((value * courseCount + j) * courseCount + i)
+                    .second) {
+              clashes.push_back(std::make_tuple(value, j, i));
+            }
+          }
+          bucket.push_back(i);
+        }
       }
     }
-    timetabler->data.courses.push_back(course);
-    timetabler->data.existingAssignmentVars.push_back(assignmentsThisCourse);
   }
+  return clashes;
 }
 
 /**
  * @brief      Verifies if the input is valid.
  *
+ * Every clash between the Instructors, Classrooms and core Programs of the
+ * Courses assigned in the input is reported once.
+ *
  * @return     True, if the input is valid.
  */
 bool Parser::verify() {
+  Data &data = timetabler->data;
   bool result = true;
-  for (auto course1 : timetabler->data.courses) {
-    if (course1.getIsMinor() == MinorType::isMinorCourse &&
-        course1.getSlot() != -1) {
-      if (timetabler->data.slots[course1.getSlot()].isMinorSlot()) {
-        if (timetabler->data.predefinedClausesWeights
+  for (Course &course : data.courses) {
+    if (course.getIsMinor() == MinorType::isMinorCourse &&
+        course.getSlot() != -1) {
+      if (data.slots[course.getSlot()].isMinorSlot()) {
+        if (data.predefinedClausesWeights
                 [PredefinedClauses::minorInMinorTime] != 0) {
           LOG(WARNING)
-              << course1.getName()
+              << course.getName()
               << " which is minor course is scheduled in non minor slot.";
         }
-        if (timetabler->data.predefinedClausesWeights
+        if (data.predefinedClausesWeights
                 [PredefinedClauses::minorInMinorTime] == -1) {
           LOG(WARNING) << "Hard constraint unsatisfied";
           result = false;
         }
       }
     }
+  }
 
-    for (auto course2 : timetabler->data.courses) {
-      if (course1.getName() == course2.getName()) continue;
-      bool segementIntersecting =
-          timetabler->data.segments[course1.getSegment()].isIntersecting(
-              timetabler->data.segments[course2.getSegment()]);
-      bool classroomSame = (course1.getClassroom() != -1 &&
-                            course1.getClassroom() == course2.getClassroom());
-      // bool slotSame =
-      //     (course1.getSlot() != -1 && course1.getSlot() ==
-      //     course2.getSlot());
-      bool slotIntersecting =
-          (course1.getSlot() != -1 && course2.getSlot() != -1)
-              ? (timetabler->data.slots[course1.getSlot()].isIntersecting(
-                    timetabler->data.slots[course2.getSlot()]))
-              : false;
-      if (segementIntersecting && slotIntersecting) {
-        if (course1.getInstructor() == course2.getInstructor()) {
-          if (timetabler->data.predefinedClausesWeights
-                  [PredefinedClauses::instructorSingleCourseAtATime] != 0) {
-            LOG(WARNING) << course1.getName() << " and " << course2.getName()
-                         << " having same instructor clash.";
-          }
-          if (timetabler->data.predefinedClausesWeights
-                  [PredefinedClauses::instructorSingleCourseAtATime] == -1) {
-            LOG(WARNING) << "Hard constraint unsatisfied";
-            result = false;
-          }
-        }
+  for (auto &clash : findClashes(FieldType::instructor)) {
+    Course &course1 = data.courses[std::get<1>(clash)];
+    Course &course2 = data.courses[std::get<2>(clash)];
+    if (data.predefinedClausesWeights
+            [PredefinedClauses::instructorSingleCourseAtATime] != 0) {
+      LOG(WARNING) << course1.getName() << " and " << course2.getName()
+                   << " having same instructor clash.";
+    }
+    if (data.predefinedClausesWeights
+            [PredefinedClauses::instructorSingleCourseAtATime] == -1) {
+      LOG(WARNING) << "Hard constraint unsatisfied";
+      result = false;
+    }
+  }
 
-        if (classroomSame) {
-          if (timetabler->data.predefinedClausesWeights
-                  [PredefinedClauses::classroomSingleCourseAtATime] != 0) {
-            LOG(WARNING) << course1.getName() << " and " << course2.getName()
-                         << " having same classroom clash.";
-          }
-          if (timetabler->data.predefinedClausesWeights
-                  [PredefinedClauses::classroomSingleCourseAtATime] == -1) {
-            LOG(WARNING) << "Hard constraint unsatisfied";
-            result = false;
-          }
-        }
+  for (auto &clash : findClashes(FieldType::classroom)) {
+    Course &course1 = data.courses[std::get<1>(clash)];
+    Course &course2 = data.courses[std::get<2>(clash)];
+    if (data.predefinedClausesWeights
+            [PredefinedClauses::classroomSingleCourseAtATime] != 0) {
+      LOG(WARNING) << course1.getName() << " and " << course2.getName()
+                   << " having same classroom clash.";
+    }
+    if (data.predefinedClausesWeights
+            [PredefinedClauses::classroomSingleCourseAtATime] == -1) {
+      LOG(WARNING) << "Hard constraint unsatisfied";
+      result = false;
+    }
+  }
 
-        for (auto program1 : course1.getPrograms()) {
-          for (auto program2 : course2.getPrograms()) {
-            if (program1 == program2) {
-              if (timetabler->data.programs[program1].isCoreProgram() &&
-                  timetabler->data.programs[program2].isCoreProgram()) {
-                if (timetabler->data.predefinedClausesWeights
-                        [PredefinedClauses::programSingleCoreCourseAtATime] !=
-                    0) {
-                  LOG(WARNING)
-                      << course1.getName() << " and " << course2.getName()
-                      << " which have common core program "
-                      << timetabler->data.programs[program1].getName()
-                      << " clash.";
-                }
-                if (timetabler->data.predefinedClausesWeights
-                        [PredefinedClauses::programSingleCoreCourseAtATime] ==
-                    -1) {
-                  LOG(WARNING) << "Hard constraint unsatisfied";
-                  result = false;
-                }
-              }
-            }
-          }
-        }
-      }
+  for (auto &clash : findClashes(FieldType::program)) {
+    Course &course1 = data.courses[std::get<1>(clash)];
+    Course &course2 = data.courses[std::get<2>(clash)];
+    if (data.predefinedClausesWeights
+            [PredefinedClauses::programSingleCoreCourseAtATime] != 0) {
+      LOG(WARNING) << course1.getName() << " and " << course2.getName()
+                   << " which have common core program "
+                   << data.programs[std::get<0>(clash)].getName()
+                   << " clash.";
+    }
+    if (data.predefinedClausesWeights
+            [PredefinedClauses::programSingleCoreCourseAtATime] == -1) {
+      LOG(WARNING) << "Hard constraint unsatisfied";
+      result = false;
     }
   }
   return result;
 }
 
+/**
+ * @brief      Gets the variable to be used for a field value of a Course.
+ *
+ * A new variable is created unless the field value is fixed, in which case the
+ * variable that is always True or always False is used.
+ *
+ * @param[in]  course     The course
+ * @param[in]  fieldType  The field type
+ * @param[in]  value      The index of the field value
+ *
+ * @return     The variable
+ */
+Var Parser::getFieldValueVar(unsigned course, FieldType fieldType,
+                             unsigned value) {
+  lbool fixed = timetabler->data.fixedFieldValues[course][fieldType][value];
+  if (fixed == l_True) {
+    return timetabler->data.trueVar;
+  }
+  if (fixed == l_False) {
+    return timetabler->data.falseVar;
+  }
+  return timetabler->newVar();
+}
+
 /**
  * @brief      Requests for variables to be added to the solver and stores the
  * data.
+ *
+ * The field values fixed by hard unit facts are found first, and variables are
+ * created only for the field values that are not fixed.
  */
 void Parser::addVars() {
-  for (Course c : timetabler->data.courses) {
+  Data &data = timetabler->data;
+  unsigned fixedCount = data.computeFixedFieldValues();
+  data.trueVar = timetabler->newVar();
+  data.falseVar = timetabler->newVar();
+  timetabler->addToFormula(mkLit(data.trueVar, false), -1);
+  timetabler->addToFormula(mkLit(data.falseVar, true), -1);
+  unsigned valueCount = 0;
+  for (unsigned i = 0; i < data.courses.size(); i++) {
     std::vector<std::vector<Var>> courseVars;
     courseVars.resize(Global::FIELD_COUNT);
-    for (Classroom cr : timetabler->data.classrooms) {
-      Var v = timetabler->newVar();
-      courseVars[FieldType::classroom].push_back(v);
+    for (unsigned j = 0; j < data.classrooms.size(); j++) {
+      courseVars[FieldType::classroom].push_back(
+          getFieldValueVar(i, FieldType::classroom, j));
     }
-    for (Instructor i : timetabler->data.instructors) {
-      Var v = timetabler->newVar();
-      courseVars[FieldType::instructor].push_back(v);
+    for (unsigned j = 0; j < data.instructors.size(); j++) {
+      courseVars[FieldType::instructor].push_back(
+          getFieldValueVar(i, FieldType::instructor, j));
     }
-    for (IsMinor i : timetabler->data.isMinors) {
-      Var v = timetabler->newVar();
-      courseVars[FieldType::isMinor].push_back(v);
+    for (unsigned j = 0; j < data.isMinors.size(); j++) {
+      courseVars[FieldType::isMinor].push_back(
+          getFieldValueVar(i, FieldType::isMinor, j));
     }
-    for (Program p : timetabler->data.programs) {
-      Var v = timetabler->newVar();
-      courseVars[FieldType::program].push_back(v);
+    for (unsigned j = 0; j < data.programs.size(); j++) {
+      courseVars[FieldType::program].push_back(
+          getFieldValueVar(i, FieldType::program, j));
     }
-    for (Segment s : timetabler->data.segments) {
-      Var v = timetabler->newVar();
-      courseVars[FieldType::segment].push_back(v);
+    for (unsigned j = 0; j < data.segments.size(); j++) {
+      courseVars[FieldType::segment].push_back(
+          getFieldValueVar(i, FieldType::segment, j));
     }
-    for (Slot s : timetabler->data.slots) {
-      Var v = timetabler->newVar();
-      courseVars[FieldType::slot].push_back(v);
+    for (unsigned j = 0; j < data.slots.size(); j++) {
+      courseVars[FieldType::slot].push_back(
+          getFieldValueVar(i, FieldType::slot, j));
+    }
+    for (unsigned j = 0; j < Global::FIELD_COUNT; j++) {
+      valueCount += courseVars[j].size();
     }
     timetabler->data.fieldValueVars.push_back(courseVars);
 
     std::vector<Var> highLevelCourseVars;
-    for (unsigned i = 0; i < Global::FIELD_COUNT; ++i) {
+    for (unsigned j = 0; j < Global::FIELD_COUNT; ++j) {
       Var v = timetabler->newVar();
       highLevelCourseVars.push_back(v);
     }
@@ -392,4 +783,6 @@ void Parser::addVars() {
       }
     }
   }
+  LOG(INFO) << "Presolve fixed " << fixedCount << " of " << valueCount
+            << " field values";
 }
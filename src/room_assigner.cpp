@@ -0,0 +1,241 @@
+#include "room_assigner.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+#include "global.h"
+
+/**
+ * @brief      Constructs the RoomAssigner object.
+ *
+ * @param      data            The data of the problem
+ * @param[in]  slots           The Slot of each Course
+ * @param[in]  segments        The Segment of each Course
+ * @param[in]  preferredRooms  The Classroom each Course had before, -1 if it
+ *                             had none, which is kept where possible
+ */
+RoomAssigner::RoomAssigner(Data &data, const std::vector<int> &slots,
+                           const std::vector<int> &segments,
+                           const std::vector<int> &preferredRooms)
+    : data(data),
+      slots(slots),
+      segments(segments),
+      preferredRooms(preferredRooms) {}
+
+/**
+ * @brief      Gets the Classrooms that can be given to a Course.
+ *
+ * A Classroom given to the Course in the input by a hard assignment, or named
+ * in a custom constraint and held by the Course before, is the only one
+ * allowed. Otherwise, the Classrooms that are large enough, not fixed to
+ * False, and not named in a custom constraint are allowed. In both cases,
+ * Classrooms used by an assigned Course at an intersecting time are left out.
+ * The preferred Classroom of the Course comes first.
+ *
+ * @param[in]  course  The course
+ *
+ * @return     The indices of the allowed Classrooms
+ */
+std::vector<unsigned> RoomAssigner::getAllowedRooms(unsigned course) {
+  unsigned roomCount = data.classrooms.size();
+  std::vector<bool> allowed(roomCount, false);
+  const std::set<unsigned> &customRooms =
+      data.customFieldValues[FieldType::classroom];
+  int preferred = preferredRooms[course];
+  int given = -1;
+  if (data.existingAssignmentWeights[FieldType::classroom] < 0 &&
+      course < data.existingAssignmentVars.size()) {
+    const std::vector<lbool> &existing =
+        data.existingAssignmentVars[course][FieldType::classroom];
+    for (unsigned i = 0; i < existing.size(); i++) {
+      if (existing[i] == l_True) {
+        given = i;
+      }
+    }
+  }
+  if (given != -1) {
+    allowed[given] = true;
+  } else if (preferred != -1 && customRooms.count(preferred) > 0) {
+    allowed[preferred] = true;
+  } else {
+    for (unsigned i = 0; i < roomCount; i++) {
+      bool fixedFalse = course < data.fixedFieldValues.size() &&
+                        data.fixedFieldValues[course][FieldType::classroom]
+                                             [i] == l_False;
+      allowed[i] = !fixedFalse && customRooms.count(i) == 0 &&
+                   data.classrooms[i].getSize() >=
+                       data.courses[course].getClassSize();
+    }
+  }
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    if (rooms[i] != -1 &&
+        data.isIntersecting(FieldType::slot, slots[i], slots[course]) &&
+        data.isIntersecting(FieldType::segment, segments[i],
+                            segments[course])) {
+      allowed[rooms[i]] = false;
+    }
+  }
+  std::vector<unsigned> result;
+  if (preferred != -1 && allowed[preferred]) {
+    result.push_back(preferred);
+  }
+  for (unsigned i = 0; i < roomCount; i++) {
+    if (allowed[i] && static_cast<int>(i) != preferred) {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief      Finds an augmenting path from a Course of a block along the
+ * layers of the current phase of the Hopcroft-Karp algorithm, and augments
+ * the matching along it.
+ *
+ * @param[in]  course       The position of the Course in the block
+ * @param[in]  adjacent     The allowed Classrooms of each Course of the block
+ * @param      courseMatch  The Classroom matched to each Course of the block,
+ *                          -1 if there is none
+ * @param      roomMatch    The Course of the block matched to each Classroom,
+ *                          -1 if there is none
+ * @param      layers       The layer of each Course of the block
+ *
+ * @return     True if the matching was augmented, False otherwise
+ */
+bool RoomAssigner::findAugmentingPath(
+    unsigned course, const std::vector<std::vector<unsigned>> &adjacent,
+    std::vector<int> &courseMatch, std::vector<int> &roomMatch,
+    std::vector<unsigned> &layers) {
+  for (unsigned room : adjacent[course]) {
+    int other = roomMatch[room];
+    if (other == -1 ||
+        (layers[other] == layers[course] + 1 &&
+         findAugmentingPath(other, adjacent, courseMatch, roomMatch,
+                            layers))) {
+      courseMatch[course] = room;
+      roomMatch[room] = course;
+      return true;
+    }
+  }
+  layers[course] = std::numeric_limits<unsigned>::max();
+  return false;
+}
+
+/**
+ * @brief      Gives Classrooms to a block of Courses held at the same time by
+ * a maximum matching, found with the Hopcroft-Karp algorithm starting from
+ * the preferred Classrooms.
+ *
+ * @param[in]  block  The courses
+ *
+ * @return     True if every Course of the block was given a Classroom, False
+ * otherwise
+ */
+bool RoomAssigner::matchBlock(const std::vector<unsigned> &block) {
+  const unsigned unreached = std::numeric_limits<unsigned>::max();
+  std::vector<std::vector<unsigned>> adjacent;
+  for (unsigned course : block) {
+    adjacent.push_back(getAllowedRooms(course));
+  }
+  std::vector<int> courseMatch(block.size(), -1);
+  std::vector<int> roomMatch(data.classrooms.size(), -1);
+  for (unsigned i = 0; i < block.size(); i++) {
+    int preferred = preferredRooms[block[i]];
+    if (!adjacent[i].empty() &&
+        static_cast<int>(adjacent[i][0]) == preferred &&
+        roomMatch[preferred] == -1) {
+      courseMatch[i] = preferred;
+      roomMatch[preferred] = i;
+    }
+  }
+  while (true) {
+    // breadth first search from the unmatched courses gives the layers
+    std::vector<unsigned> layers(block.size(), unreached);
+    std::vector<unsigned> queue;
+    for (unsigned i = 0; i < block.size(); i++) {
+      if (courseMatch[i] == -1) {
+        layers[i] = 0;
+        queue.push_back(i);
+      }
+    }
+    bool found = false;
+    for (unsigned head = 0; head < queue.size(); head++) {
+      unsigned course = queue[head];
+      for (unsigned room : adjacent[course]) {
+        int other = roomMatch[room];
+        if (other == -1) {
+          found = true;
+        } else if (layers[other] == unreached) {
+          layers[other] = layers[course] + 1;
+          queue.push_back(other);
+        }
+      }
+    }
+    bool augmented = false;
+    for (unsigned i = 0; i < block.size() && found; i++) {
+      if (courseMatch[i] == -1 &&
+          findAugmentingPath(i, adjacent, courseMatch, roomMatch, layers)) {
+        augmented = true;
+      }
+    }
+    if (!augmented) {
+      break;
+    }
+  }
+  bool complete = true;
+  for (unsigned i = 0; i < block.size(); i++) {
+    rooms[block[i]] = courseMatch[i];
+    complete = complete && (courseMatch[i] != -1);
+  }
+  return complete;
+}
+
+/**
+ * @brief      Gives Classrooms to all the Courses.
+ *
+ * The blocks are matched in decreasing order of the size of their largest
+ * Course. If symmetry breaking is enabled, interchangeable Classrooms are
+ * renamed in the order of their first use, so that the Classrooms are kept by
+ * the symmetry breaking clauses.
+ *
+ * @return     True if every Course was given a Classroom, False otherwise
+ */
+bool RoomAssigner::assign() {
+  rooms.assign(data.courses.size(), -1);
+  std::map<std::pair<int, int>, std::vector<unsigned>> blockMap;
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    blockMap[std::make_pair(slots[i], segments[i])].push_back(i);
+  }
+  std::vector<std::pair<unsigned, std::vector<unsigned>>> blocks;
+  for (auto &entry : blockMap) {
+    unsigned largest = 0;
+    for (unsigned course : entry.second) {
+      largest = std::max(largest, data.courses[course].getClassSize());
+    }
+    blocks.push_back(std::make_pair(largest, entry.second));
+  }
+  std::stable_sort(blocks.begin(), blocks.end(),
+                   [](const std::pair<unsigned, std::vector<unsigned>> &a,
+                      const std::pair<unsigned, std::vector<unsigned>> &b) {
+                     return a.first > b.first;
+                   });
+  for (unsigned i = 0; i < blocks.size(); i++) {
+    if (!matchBlock(blocks[i].second)) {
+      return false;
+    }
+  }
+  if (data.symmetryBreaking) {
+    data.orderInterchangeableValues(FieldType::classroom, rooms);
+  }
+  return true;
+}
+
+/**
+ * @brief      Gets the Classrooms given to the Courses.
+ *
+ * @return     The Classroom of each Course, -1 if it has none
+ */
+std::vector<int> RoomAssigner::getRooms() { return rooms; }
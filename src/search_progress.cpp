@@ -0,0 +1,66 @@
+#include "search_progress.h"
+
+#include <sstream>
+#include <string>
+
+/**
+ * @brief      Constructs the SearchProgress object for the start of a search.
+ */
+SearchProgress::SearchProgress() {
+  type = ProgressEventType::Started;
+  configuration = 0;
+  elapsedSeconds = 0;
+  upperBound = 0;
+  lowerBound = 0;
+  coreSize = 0;
+  coreCount = 0;
+  modelCount = 0;
+  variableCount = 0;
+  clauseCount = 0;
+}
+
+/**
+ * @brief      Gets the name of the event, as used in the JSON output.
+ *
+ * @return     The event name
+ */
+std::string SearchProgress::getEventName() const {
+  switch (type) {
+    case ProgressEventType::Started:
+      return "started";
+    case ProgressEventType::UpperBound:
+      return "upper_bound";
+    case ProgressEventType::LowerBound:
+      return "lower_bound";
+    case ProgressEventType::Completed:
+      return "completed";
+    case ProgressEventType::Stopped:
+      return "stopped";
+  }
+  return "";
+}
+
+/**
+ * @brief      Converts the report to a single line JSON object, so that
+ * reports can be written as newline delimited JSON.
+ *
+ * The upper bound is null until a model has been found.
+ *
+ * @return     The JSON object, without a trailing newline
+ */
+std::string SearchProgress::toJson() const {
+  std::ostringstream json;
+  json << "{\"event\":\"" << getEventName() << "\""
+       << ",\"configuration\":" << configuration
+       << ",\"elapsed\":" << elapsedSeconds << ",\"upper_bound\":";
+  if (modelCount > 0) {
+    json << upperBound;
+  } else {
+    json << "null";
+  }
+  json << ",\"lower_bound\":" << lowerBound << ",\"core_size\":" << coreSize
+       << ",\"cores\":" << coreCount << ",\"models\":" << modelCount
+       << ",\"variables\":" << variableCount
+       << ",\"clauses\":" << clauseCount << "}";
+  return json.str();
+}
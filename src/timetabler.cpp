@@ -1,26 +1,57 @@
 #include "timetabler.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include "MaxSATFormula.h"
 #include "cclause.h"
+#include "clause_buffer.h"
 #include "clauses.h"
+#include "component_solver.h"
 #include "core/SolverTypes.h"
+#include "greedy_scheduler.h"
 #include "mtl/Vec.h"
+#include "neighbourhood_search.h"
+#include "room_assigner.h"
 #include "tsolver.h"
 #include "utils.h"
 
 using namespace NSPACE;
 
+/**
+ * The buffer of the part of the formula being encoded by this thread, to which
+ * new variables and clauses go instead of the formula, or NULL if none
+ */
+static thread_local ClauseBuffer *partBuffer = NULL;
+
 /**
  * @brief      Constructs the Timetabler object.
  */
 Timetabler::Timetabler() {
   solver = new TSolver(1, _CARD_TOTALIZER_);
+  sessionSolver = NULL;
   formula = new MaxSATFormula();
   formula->setProblemType(_WEIGHTED_);
+  threadCount = 1;
+  timeLimit = 0;
+  conflictLimit = 0;
+  optimal = false;
+  cost = 0;
+  lowerBound = 0;
+  searchFinished = false;
+  decomposition = false;
+  lns = false;
+  greedyStart = true;
+  greedyHint = false;
+  greedyModel = false;
+  symmetryReleased = false;
 }
 
 /**
@@ -34,12 +65,8 @@ Timetabler::Timetabler() {
  */
 void Timetabler::addClauses(const std::vector<CClause> &clauses, int weight) {
   for (unsigned i = 0; i < clauses.size(); i++) {
-    vec<Lit> clauseVec;
-    std::vector<Lit> clauseVector = clauses[i].getLits();
-    for (unsigned j = 0; j < clauseVector.size(); j++) {
-      clauseVec.push(clauseVector[j]);
-    }
-    addToFormula(clauseVec, weight);
+    const std::vector<Lit> &lits = clauses[i].getLits();
+    addToFormula(ClauseSpan(lits.data(), lits.size()), weight);
   }
 }
 
@@ -145,7 +172,10 @@ void Timetabler::addExistingAssignments() {
  * @param[in]  weight  The weight
  */
 void Timetabler::addToFormula(vec<Lit> &input, int weight) {
-  if (weight < 0) {
+  if (partBuffer != NULL) {
+    partBuffer->addClause(
+        ClauseSpan(input.size() > 0 ? &input[0] : NULL, input.size()), weight);
+  } else if (weight < 0) {
     formula->addHardClause(input);
   } else if (weight > 0) {
     formula->addSoftClause(weight, input);
@@ -159,9 +189,28 @@ void Timetabler::addToFormula(vec<Lit> &input, int weight) {
  * @param[in]  weight  The weight
  */
 void Timetabler::addToFormula(Lit input, int weight) {
-  vec<Lit> inputLits;
-  inputLits.push(input);
-  addToFormula(inputLits, weight);
+  addToFormula(ClauseSpan(&input, 1), weight);
+}
+
+/**
+ * @brief      Add a given clause with the given weight to the formula.
+ *
+ * The literals are copied through a buffer that is reused between calls, so
+ * that no memory is allocated for the clause apart from that in the formula.
+ *
+ * @param[in]  input   The input
+ * @param[in]  weight  The weight
+ */
+void Timetabler::addToFormula(const ClauseSpan &input, int weight) {
+  if (partBuffer != NULL) {
+    partBuffer->addClause(input, weight);
+    return;
+  }
+  clauseBuffer.clear();
+  for (Lit lit : input) {
+    clauseBuffer.push(lit);
+  }
+  addToFormula(clauseBuffer, weight);
 }
 
 /**
@@ -174,17 +223,377 @@ void Timetabler::addToFormula(Lit input, int weight) {
  * @param[in]  weight   The weight
  */
 void Timetabler::addClauses(const Clauses &clauses, int weight) {
-  addClauses(clauses.getClauses(), weight);
+  for (unsigned i = 0; i < clauses.size(); i++) {
+    addToFormula(clauses.getClause(i), weight);
+  }
 }
 
 /**
  * @brief      Calls the solver to solve for the constraints.
  *
+ * If a time limit or a conflict limit is set and the search is stopped by it,
+ * the best model found so far is used, and the timetable is marked as not
+ * optimal. The time limit applies to all the phases together, including the
+ * assignment of the Classrooms in two stage solving. If the large
+ * neighbourhood search is enabled, it is used instead. Otherwise, if
+ * decomposition is enabled and the formula splits into several independent
+ * components, the components are solved separately.
+ *
+ * If no hint is given, a greedy timetable is used as the hint, which gives an
+ * initial model within a few milliseconds if it satisfies the constraints. If
+ * the search is stopped before any model is found, the greedy timetable is
+ * used as the result.
+ *
  * @return     True, if all high level variables were satisfied, False otherwise
  */
 SolverStatus Timetabler::solve() {
-  solver->loadFormula(formula);
-  model = solver->tSearch();
+  startDeadline();
+  if (greedyStart && data.hintValues.size() == 0) {
+    scheduleGreedily();
+  }
+  if (lns) {
+    solveLns();
+  } else if (!decomposition || !solveComponents()) {
+    solveFormula();
+  }
+  if (data.twoStage && model.size() > 0 &&
+      data.predefinedClausesWeights
+              [PredefinedClauses::classroomSingleCourseAtATime] != 0) {
+    assignRooms();
+  }
+  if (model.size() == 0 && !optimal && greedyHint) {
+    useGreedyModel();
+  }
+  return getModelStatus();
+}
+
+/**
+ * @brief      Solves the formula as a whole, by a single solver or by a
+ * portfolio of solvers.
+ */
+void Timetabler::solveFormula() {
+  std::vector<TSolver *> solvers;
+  if (threadCount > 1) {
+    for (unsigned i = 0; i < threadCount; i++) {
+      TSolver *portfolioSolver = new TSolver(1, _CARD_TOTALIZER_);
+      portfolioSolver->setConfiguration(i);
+      // the solver owns the copy, and deletes it when it is deleted
+      portfolioSolver->loadFormula(formula->copyMaxSATFormula());
+      solvers.push_back(portfolioSolver);
+    }
+  } else {
+    solver->loadFormula(formula);
+    solvers.push_back(solver);
+  }
+  for (unsigned i = 0; i < solvers.size(); i++) {
+    configureSolver(solvers[i]);
+  }
+  std::thread timer = startTimer(solvers);
+  unsigned chosen = 0;
+  if (threadCount > 1) {
+    chosen = solvePortfolio(solvers);
+  } else {
+    model = solver->tSearch();
+  }
+  stopTimer(timer);
+  optimal = solvers[chosen]->isSearchCompleted();
+  cost = solvers[chosen]->getUpperBound();
+  lowerBound = 0;
+  for (unsigned i = 0; i < solvers.size(); i++) {
+    lowerBound = std::max(lowerBound, solvers[i]->getLowerBound());
+  }
+  if (threadCount > 1) {
+    for (unsigned i = 0; i < solvers.size(); i++) {
+      delete solvers[i];
+    }
+  }
+}
+
+/**
+ * @brief      Sets whether independent parts of the formula are solved
+ * separately.
+ *
+ * @param[in]  decomposition  True to solve the components separately
+ */
+void Timetabler::setDecomposition(bool decomposition) {
+  this->decomposition = decomposition;
+}
+
+/**
+ * @brief      Solves the independent components of the formula separately, and
+ * merges their models, with a ComponentSolver.
+ *
+ * @return     True, if the formula was solved by components, False if it has
+ * fewer than two components and must be solved as a whole
+ */
+bool Timetabler::solveComponents() {
+  ComponentSolver componentSolver(formula);
+  if (!componentSolver.loadComponents()) {
+    LOG(INFO) << "Formula has no independent components";
+    return false;
+  }
+  const std::vector<TSolver *> &solvers = componentSolver.getSolvers();
+  LOG(INFO) << "Solving " << solvers.size() << " independent components";
+  for (unsigned i = 0; i < solvers.size(); i++) {
+    configureSolver(solvers[i]);
+  }
+  // the hint of configureSolver is on the whole formula
+  componentSolver.setHint(data.hintValues.size() > 0 ? getHintLits()
+                                                     : std::vector<Lit>());
+  std::thread timer = startTimer(solvers);
+  componentSolver.solve(threadCount);
+  stopTimer(timer);
+  model = componentSolver.getModel();
+  optimal = componentSolver.isOptimal();
+  cost = componentSolver.getCost();
+  lowerBound = componentSolver.getLowerBound();
+  return true;
+}
+
+/**
+ * @brief      Sets whether a greedy timetable is used as the hint if none is
+ * given.
+ *
+ * @param[in]  greedyStart  True to use the greedy timetable
+ */
+void Timetabler::setGreedyStart(bool greedyStart) {
+  this->greedyStart = greedyStart;
+}
+
+/**
+ * @brief      Builds a timetable with the GreedyScheduler and uses it as the
+ * hint.
+ */
+void Timetabler::scheduleGreedily() {
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  GreedyScheduler scheduler(data);
+  unsigned scheduled = scheduler.schedule();
+  data.hintValues = scheduler.getFieldValues();
+  greedyHint = true;
+  LOG(INFO) << "Greedy timetable scheduled " << scheduled << " of "
+            << data.courses.size() << " courses in "
+            << std::chrono::duration<double, std::milli>(
+                   std::chrono::steady_clock::now() - start)
+                   .count()
+            << " ms";
+}
+
+/**
+ * @brief      Uses the greedy timetable as the model, when the search found
+ * no model.
+ *
+ * The greedy timetable is not checked against the custom constraints and the
+ * soft predefined constraints, so their high level variables are taken to be
+ * True. The high level variables of the Slot and Classroom of a Course left
+ * unscheduled are False.
+ */
+void Timetabler::useGreedyModel() {
+  model.assign(formula->nVars(), l_Undef);
+  if (data.trueVar != var_Undef) {
+    model[data.trueVar] = l_True;
+  }
+  if (data.falseVar != var_Undef) {
+    model[data.falseVar] = l_False;
+  }
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    for (unsigned j = 0; j < Global::FIELD_COUNT; j++) {
+      const std::vector<lbool> &values = data.hintValues[i][j];
+      const std::vector<Var> &vars = data.fieldValueVars[i][j];
+      bool assigned = (values.size() == vars.size());
+      for (unsigned k = 0; k < vars.size(); k++) {
+        if (vars[k] != data.trueVar && vars[k] != data.falseVar) {
+          model[vars[k]] = assigned ? values[k] : l_False;
+        }
+      }
+      model[data.highLevelVars[i][j]] = lbool(assigned);
+    }
+  }
+  for (unsigned i = 0; i < data.predefinedConstraintVars.size(); i++) {
+    for (unsigned j = 0; j < data.predefinedConstraintVars[i].size(); j++) {
+      model[data.predefinedConstraintVars[i][j]] = l_True;
+    }
+  }
+  for (unsigned i = 0; i < data.customConstraintVars.size(); i++) {
+    model[data.customConstraintVars[i]] = l_True;
+  }
+  greedyModel = true;
+}
+
+/**
+ * @brief      Assigns the Classrooms in the second stage of a two stage
+ * solve, keeping the times of the Courses found in the first stage.
+ *
+ * The first stage only counts the Classrooms in use at each time, so the
+ * Classrooms in its model may clash. The RoomAssigner matches the Courses to
+ * Classrooms, and the matching is checked by solving again with every field
+ * value assumed. If there is no matching, or it violates some constraint,
+ * the Classrooms are chosen by the solver instead, with the clashes between
+ * Courses held at intersecting times ruled out. The cost of the first stage
+ * is a lower bound, since its constraints are weaker. If both fail, or the
+ * time limit is reached first, the model of the first stage is kept, and the
+ * Classroom constraint is marked as violated.
+ */
+void Timetabler::assignRooms() {
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  unsigned courseCount = data.courses.size();
+  auto getValue = [this](unsigned course, FieldType fieldType) {
+    const std::vector<Var> &vars = data.fieldValueVars[course][fieldType];
+    for (unsigned k = 0; k < vars.size(); k++) {
+      if (isVarTrue(vars[k])) {
+        return static_cast<int>(k);
+      }
+    }
+    return -1;
+  };
+  std::vector<int> slots, segments, rooms;
+  bool timed = true;
+  for (unsigned i = 0; i < courseCount; i++) {
+    slots.push_back(getValue(i, FieldType::slot));
+    segments.push_back(getValue(i, FieldType::segment));
+    rooms.push_back(getValue(i, FieldType::classroom));
+    timed = timed && slots[i] != -1 && segments[i] != -1;
+  }
+  bool matched = false;
+  if (timed) {
+    RoomAssigner assigner(data, slots, segments, rooms);
+    matched = assigner.assign();
+    rooms = assigner.getRooms();
+  }
+
+  std::vector<uint64_t> weights;
+  for (int i = 0; i < formula->nSoft(); i++) {
+    weights.push_back(formula->getSoftClause(i).weight);
+  }
+  TSolver *worker = new TSolver(1, _CARD_TOTALIZER_);
+  // the worker owns the copy, and deletes it when it is deleted
+  worker->loadFormula(formula->copyMaxSATFormula());
+  worker->startSession();
+  configureSolver(worker);
+  std::vector<Lit> times;
+  for (unsigned i = 0; i < courseCount; i++) {
+    for (int j = 0; j < Global::FIELD_COUNT; j++) {
+      if (j == FieldType::classroom) {
+        continue;
+      }
+      for (Var v : data.fieldValueVars[i][j]) {
+        if (v != data.trueVar && v != data.falseVar && model[v] == l_True) {
+          times.push_back(mkLit(v));
+        }
+      }
+    }
+  }
+  std::vector<TSolver *> workers(1, worker);
+  std::thread timer = startTimer(workers);
+  std::vector<lbool> assigned;
+  // a search started after the deadline would clear the interrupt of the timer
+  if (matched && !isPastDeadline()) {
+    std::vector<Lit> assumptions = times;
+    for (unsigned i = 0; i < courseCount; i++) {
+      const std::vector<Var> &vars =
+          data.fieldValueVars[i][FieldType::classroom];
+      if (vars[rooms[i]] != data.trueVar) {
+        assumptions.push_back(mkLit(vars[rooms[i]]));
+      }
+    }
+    assigned = worker->tResolve(assumptions, weights);
+  }
+  bool byMatching = assigned.size() > 0;
+  if (!byMatching) {
+    Var guard = data.predefinedConstraintVars
+                    [PredefinedClauses::classroomSingleCourseAtATime][0];
+    for (unsigned i = 0; i < courseCount && timed; i++) {
+      for (unsigned j = i + 1; j < courseCount; j++) {
+        if (!data.isIntersecting(FieldType::slot, slots[i], slots[j]) ||
+            !data.isIntersecting(FieldType::segment, segments[i],
+                                 segments[j])) {
+          continue;
+        }
+        for (unsigned k = 0; k < data.classrooms.size(); k++) {
+          Var room1 = data.fieldValueVars[i][FieldType::classroom][k];
+          Var room2 = data.fieldValueVars[j][FieldType::classroom][k];
+          if (room1 == data.falseVar || room2 == data.falseVar) {
+            continue;
+          }
+          vec<Lit> clash;
+          clash.push(~mkLit(guard));
+          clash.push(~mkLit(room1));
+          clash.push(~mkLit(room2));
+          worker->addSessionClause(clash);
+        }
+      }
+    }
+    if (timed && !isPastDeadline()) {
+      assigned = worker->tResolve(times, weights);
+    }
+  }
+  stopTimer(timer);
+  if (assigned.size() > 0) {
+    uint64_t stageCost = Utils::computeCost(formula, assigned);
+    optimal = optimal && stageCost == cost;
+    cost = stageCost;
+    model = assigned;
+    LOG(INFO) << "Classrooms assigned "
+              << (byMatching ? "by matching" : "by the solver") << " in "
+              << std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - start)
+                     .count()
+              << " ms";
+  } else {
+    model[data.predefinedConstraintVars
+              [PredefinedClauses::classroomSingleCourseAtATime][0]] = l_False;
+    optimal = false;
+    LOG(WARNING) << "Classrooms could not be assigned without clashes";
+  }
+  delete worker;
+}
+
+/**
+ * @brief      Sets whether the model is improved by a large neighbourhood
+ * search instead of being solved to optimality.
+ *
+ * @param[in]  lns   True to use the large neighbourhood search
+ */
+void Timetabler::setLns(bool lns) { this->lns = lns; }
+
+/**
+ * @brief      Finds a model and improves it by a large neighbourhood search,
+ * with a NeighbourhoodSearch of threadCount workers.
+ *
+ * The search stops at the time limit, or if there is none, once every worker
+ * has gone Global::LNS_STALL_LIMIT neighbourhoods without improvement.
+ */
+void Timetabler::solveLns() {
+  NeighbourhoodSearch neighbourhoodSearch(data, formula, threadCount);
+  if (data.hintValues.size() > 0) {
+    neighbourhoodSearch.setHint(getHintLits());
+  }
+  if (timeLimit > 0) {
+    neighbourhoodSearch.setDeadline(deadline);
+  }
+  if (progressCallback) {
+    neighbourhoodSearch.setProgressCallback(
+        [this](const SearchProgress &progress) {
+          std::lock_guard<std::mutex> lock(progressMutex);
+          progressCallback(progress);
+        });
+  }
+  std::thread timer = startTimer(neighbourhoodSearch.getWorkers());
+  neighbourhoodSearch.search();
+  stopTimer(timer);
+  model = neighbourhoodSearch.getModel();
+  optimal = neighbourhoodSearch.isOptimal();
+  cost = neighbourhoodSearch.getCost();
+  lowerBound = neighbourhoodSearch.getLowerBound();
+}
+
+/**
+ * @brief      Gets the status of the model found by the solver.
+ *
+ * @return     The status
+ */
+SolverStatus Timetabler::getModelStatus() {
   if (model.size() == 0) {
     return SolverStatus::Unsolved;
   }
@@ -196,6 +605,496 @@ SolverStatus Timetabler::solve() {
   return SolverStatus::HighLevelFailed;
 }
 
+/**
+ * @brief      Gets the literals of the field values given in the hint.
+ *
+ * Field values fixed by the presolve are left out, since the solver cannot
+ * choose them.
+ *
+ * @return     The literals
+ */
+std::vector<Lit> Timetabler::getHintLits() {
+  std::vector<Lit> hintLits;
+  for (unsigned i = 0; i < data.hintValues.size(); i++) {
+    for (unsigned j = 0; j < data.hintValues[i].size(); j++) {
+      const std::vector<lbool> &values = data.hintValues[i][j];
+      const std::vector<Var> &vars = data.fieldValueVars[i][j];
+      if (values.size() != vars.size()) {
+        continue;
+      }
+      for (unsigned k = 0; k < values.size(); k++) {
+        if (values[k] == l_Undef || vars[k] == data.trueVar ||
+            vars[k] == data.falseVar) {
+          continue;
+        }
+        hintLits.push_back(mkLit(vars[k], values[k] == l_False));
+      }
+    }
+  }
+  return hintLits;
+}
+
+/**
+ * @brief      Applies the search limits, the progress callback and the hint to
+ * a solver.
+ *
+ * @param      solver  The solver
+ */
+void Timetabler::configureSolver(TSolver *solver) {
+  solver->setConflictLimit(conflictLimit);
+  if (data.hintValues.size() > 0) {
+    solver->setHint(getHintLits());
+  }
+  if (progressCallback) {
+    solver->setProgressCallback([this](const SearchProgress &progress) {
+      std::lock_guard<std::mutex> lock(progressMutex);
+      progressCallback(progress);
+    });
+  }
+}
+
+/**
+ * @brief      Starts an incremental session, in which the encoded problem can
+ * be solved again after small edits without encoding it again.
+ *
+ * The solver keeps its clauses, including the ones it has learnt, between the
+ * calls to resolve(). Edits are either assumptions, which can be changed or
+ * cleared at any time, changes to the weights of the constraints, or hard
+ * clauses, which hold for the rest of the session. This must be called after
+ * all the clauses have been added, and instead of solve().
+ *
+ * The session solver is loaded with a copy of the formula without the unit
+ * clause of Data::symmetryBreakingVar, so that the symmetry breaking clauses
+ * hold only while they are assumed. They are released by resolve() while a
+ * Classroom or Slot of a class of interchangeable values is assumed, and for
+ * the rest of the session once a session clause names one.
+ */
+void Timetabler::startSession() {
+  sessionWeights.clear();
+  unitSoftClauses.clear();
+  sessionAssumptions.clear();
+  fieldValueAssumptions.clear();
+  symmetryReleased = false;
+  MaxSATFormula *sessionFormula = new MaxSATFormula();
+  sessionFormula->setProblemType(_WEIGHTED_);
+  while (sessionFormula->nVars() < formula->nVars()) {
+    sessionFormula->newVar();
+  }
+  for (int i = 0; i < formula->nHard(); i++) {
+    vec<Lit> &clause = formula->getHardClause(i).clause;
+    if (clause.size() != 1 || var(clause[0]) != data.symmetryBreakingVar) {
+      sessionFormula->addHardClause(clause);
+    }
+  }
+  for (int i = 0; i < formula->nSoft(); i++) {
+    sessionWeights.push_back(formula->getSoftClause(i).weight);
+    sessionFormula->addSoftClause(formula->getSoftClause(i).weight,
+                                  formula->getSoftClause(i).clause);
+    if (formula->getSoftClause(i).clause.size() == 1 &&
+        !sign(formula->getSoftClause(i).clause[0])) {
+      unitSoftClauses[var(formula->getSoftClause(i).clause[0])] = i;
+    }
+  }
+  interchangeableVars.assign(formula->nVars(), false);
+  if (data.symmetryBreakingVar != var_Undef) {
+    for (FieldType fieldType : {FieldType::classroom, FieldType::slot}) {
+      for (const std::vector<unsigned> &valueClass :
+           data.getInterchangeableValues(fieldType)) {
+        for (unsigned i = 0; i < data.courses.size(); i++) {
+          for (unsigned value : valueClass) {
+            Var v = data.fieldValueVars[i][fieldType][value];
+            if (v != data.trueVar && v != data.falseVar) {
+              interchangeableVars[v] = true;
+            }
+          }
+        }
+      }
+    }
+  }
+  delete sessionSolver;
+  sessionSolver = new TSolver(1, _CARD_TOTALIZER_);
+  // the solver owns the copy, and deletes it when it is deleted
+  sessionSolver->loadFormula(sessionFormula);
+  sessionSolver->startSession();
+}
+
+/**
+ * @brief      Checks if a literal is on a Classroom or Slot of a class of
+ * interchangeable values, which the symmetry breaking clauses may rule out.
+ *
+ * @param[in]  lit   The literal
+ *
+ * @return     True, if the variable of the literal is such a field value,
+ * False otherwise
+ */
+bool Timetabler::isInterchangeableLit(Lit lit) {
+  return var(lit) < (int)interchangeableVars.size() &&
+         interchangeableVars[var(lit)];
+}
+
+/**
+ * @brief      Assumes a value for a field of a course in the following calls
+ * to resolve().
+ *
+ * @param[in]  course     The index of the course
+ * @param[in]  fieldType  The field type
+ * @param[in]  index      The index of the field value
+ * @param[in]  value      l_True to assign the value to the course, l_False to
+ * forbid it, or l_Undef to remove an earlier assumption
+ */
+void Timetabler::setFieldValueAssumption(int course, FieldType fieldType,
+                                         unsigned index, lbool value) {
+  std::tuple<int, FieldType, unsigned> fieldValue =
+      std::make_tuple(course, fieldType, index);
+  if (value == l_Undef) {
+    fieldValueAssumptions.erase(fieldValue);
+  } else {
+    fieldValueAssumptions[fieldValue] = (value == l_True);
+  }
+}
+
+/**
+ * @brief      Removes all the assumptions on the field values and the
+ * constraints made in the session.
+ *
+ * Changes to the weights of soft constraints and the clauses added to the
+ * session are kept.
+ */
+void Timetabler::clearAssumptions() {
+  sessionAssumptions.clear();
+  fieldValueAssumptions.clear();
+}
+
+/**
+ * @brief      Changes the weight of a predefined constraint in the following
+ * calls to resolve().
+ *
+ * @param[in]  clauseType  The predefined constraint
+ * @param[in]  course      The index of the course for constraints that apply
+ * to each course, or -1 for constraints that apply to all the courses
+ * @param[in]  weight      The new weight. A negative weight makes the
+ * constraint hard, and a zero weight disables it
+ */
+void Timetabler::setConstraintWeight(PredefinedClauses clauseType, int course,
+                                     int weight) {
+  if (course == -1) {
+    setSessionWeight(data.predefinedConstraintVars[clauseType][0], weight);
+  } else {
+    setSessionWeight(data.predefinedConstraintVars[clauseType][course],
+                     weight);
+  }
+}
+
+/**
+ * @brief      Changes the weight of a custom constraint in the following calls
+ * to resolve().
+ *
+ * @param[in]  index   The index of the custom constraint
+ * @param[in]  weight  The new weight. A negative weight makes the constraint
+ * hard, and a zero weight disables it
+ */
+void Timetabler::setCustomConstraintWeight(unsigned index, int weight) {
+  setSessionWeight(data.customConstraintVars[index], weight);
+}
+
+/**
+ * @brief      Changes the weight of the unit soft clause of a constraint
+ * variable in the session.
+ *
+ * A constraint that was hard when the session started stays hard.
+ *
+ * @param[in]  v       The constraint variable
+ * @param[in]  weight  The new weight
+ */
+void Timetabler::setSessionWeight(Var v, int weight) {
+  std::map<Var, unsigned>::iterator softClause = unitSoftClauses.find(v);
+  if (weight < 0) {
+    sessionAssumptions[v] = true;
+    if (softClause != unitSoftClauses.end()) {
+      sessionWeights[softClause->second] = 0;
+    }
+    return;
+  }
+  sessionAssumptions.erase(v);
+  if (softClause == unitSoftClauses.end()) {
+    LOG(WARNING) << "Constraint is hard in the session, its weight cannot be "
+                    "changed";
+    return;
+  }
+  sessionWeights[softClause->second] = weight;
+}
+
+/**
+ * @brief      Adds clauses as hard clauses for the rest of the session.
+ *
+ * @param[in]  clauses  The clauses
+ */
+void Timetabler::addSessionClauses(const Clauses &clauses) {
+  for (unsigned i = 0; i < clauses.size(); i++) {
+    ClauseSpan clause = clauses.getClause(i);
+    clauseBuffer.clear();
+    for (unsigned j = 0; j < clause.size(); j++) {
+      clauseBuffer.push(clause[j]);
+      symmetryReleased = symmetryReleased || isInterchangeableLit(clause[j]);
+    }
+    sessionSolver->addSessionClause(clauseBuffer);
+  }
+}
+
+/**
+ * @brief      Gets the literals of the assumptions of the session.
+ *
+ * An assumption on a field value fixed by the presolve gives no literal if it
+ * agrees with the fixed value, and cannot be satisfied otherwise.
+ *
+ * @param      assumptions  The literals
+ *
+ * @return     False if an assumption contradicts a fixed field value, True
+ * otherwise
+ */
+bool Timetabler::getAssumptionLits(std::vector<Lit> &assumptions) {
+  for (std::map<Var, bool>::iterator it = sessionAssumptions.begin();
+       it != sessionAssumptions.end(); ++it) {
+    assumptions.push_back(mkLit(it->first, !it->second));
+  }
+  bool satisfiable = true;
+  for (std::map<std::tuple<int, FieldType, unsigned>, bool>::iterator it =
+           fieldValueAssumptions.begin();
+       it != fieldValueAssumptions.end(); ++it) {
+    int course = std::get<0>(it->first);
+    FieldType fieldType = std::get<1>(it->first);
+    unsigned index = std::get<2>(it->first);
+    Var v = data.fieldValueVars[course][fieldType][index];
+    if (v != data.trueVar && v != data.falseVar) {
+      assumptions.push_back(mkLit(v, !it->second));
+    } else if ((v == data.trueVar) != it->second) {
+      LOG(WARNING) << "Assumption on "
+                   << Utils::getFieldTypeName(fieldType) << " "
+                   << Utils::getFieldName(fieldType, index, data) << " of "
+                   << data.courses[course].getName()
+                   << " contradicts its fixed value";
+      satisfiable = false;
+    }
+  }
+  return satisfiable;
+}
+
+/**
+ * @brief      Solves the problem of the session again with the current edits.
+ *
+ * The search limits and the progress callback apply as in solve(). If an
+ * assumption contradicts a field value fixed by the presolve, there is no
+ * model and no search is made.
+ *
+ * @return     The status of the new model
+ */
+SolverStatus Timetabler::resolve() {
+  startDeadline();
+  std::vector<Lit> assumptions;
+  if (!getAssumptionLits(assumptions)) {
+    model.clear();
+    optimal = true;
+    cost = 0;
+    lowerBound = 0;
+    return getModelStatus();
+  }
+  bool symmetryHolds = !symmetryReleased;
+  for (unsigned i = 0; i < assumptions.size() && symmetryHolds; i++) {
+    symmetryHolds = !isInterchangeableLit(assumptions[i]);
+  }
+  if (data.symmetryBreakingVar != var_Undef && symmetryHolds) {
+    assumptions.push_back(mkLit(data.symmetryBreakingVar));
+  }
+  std::vector<TSolver *> solvers(1, sessionSolver);
+  configureSolver(sessionSolver);
+  std::thread timer = startTimer(solvers);
+  model = sessionSolver->tResolve(assumptions, sessionWeights);
+  stopTimer(timer);
+  optimal = sessionSolver->isSearchCompleted();
+  cost = sessionSolver->getUpperBound();
+  lowerBound = sessionSolver->getLowerBound();
+  return getModelStatus();
+}
+
+/**
+ * @brief      Sets the number of threads used for solving.
+ *
+ * @param[in]  threadCount  The number of threads
+ */
+void Timetabler::setThreadCount(unsigned threadCount) {
+  this->threadCount = threadCount;
+}
+
+/**
+ * @brief      Limits the search, so that the best model found so far is used
+ * when a limit is reached.
+ *
+ * @param[in]  timeLimit      The number of seconds after which the search is
+ * stopped, or 0 for no limit
+ * @param[in]  conflictLimit  The number of conflicts after which the search
+ * of each solver is stopped, or 0 for no limit
+ */
+void Timetabler::setSearchLimits(double timeLimit, uint64_t conflictLimit) {
+  this->timeLimit = timeLimit;
+  this->conflictLimit = conflictLimit;
+}
+
+/**
+ * @brief      Sets the function called with the progress reports of the
+ * search.
+ *
+ * With several threads, the reports of all the solver configurations are
+ * passed to the function, one at a time.
+ *
+ * @param[in]  callback  The function
+ */
+void Timetabler::setProgressCallback(ProgressCallback callback) {
+  progressCallback = callback;
+}
+
+/**
+ * @brief      Checks if the model found by the last call to solve() was
+ * proved to be optimal.
+ *
+ * @return     True, if the model is optimal, False if the search was stopped
+ * by a limit
+ */
+bool Timetabler::isOptimal() { return optimal; }
+
+/**
+ * @brief      Gets the cost of the model found by the last call to solve().
+ *
+ * @return     The sum of the weights of the unsatisfied soft clauses
+ */
+uint64_t Timetabler::getCost() { return cost; }
+
+/**
+ * @brief      Gets the lower bound on the optimal cost proved by the last call
+ * to solve().
+ *
+ * @return     The lower bound, which is equal to the cost if the model is
+ * optimal
+ */
+uint64_t Timetabler::getLowerBound() { return lowerBound; }
+
+/**
+ * @brief      Solves the formula with a portfolio of solver configurations,
+ * each running on its own thread with its own copy of the formula.
+ *
+ * The model of the first configuration to finish is used, and the other
+ * configurations are then interrupted. If every configuration is stopped by a
+ * limit instead, the model with the lowest cost is used.
+ *
+ * @param[in]  solvers  The solvers, each loaded with a copy of the formula
+ *
+ * @return     The index of the solver whose model is used
+ */
+unsigned Timetabler::solvePortfolio(const std::vector<TSolver *> &solvers) {
+  std::mutex resultMutex;
+  int winner = -1;
+  std::vector<std::vector<lbool>> models(solvers.size());
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < solvers.size(); i++) {
+    threads.push_back(std::thread([&, i]() {
+      models[i] = solvers[i]->tSearch();
+      if (!solvers[i]->isSearchCompleted()) {
+        return;
+      }
+      std::lock_guard<std::mutex> lock(resultMutex);
+      if (winner != -1) {
+        return;
+      }
+      winner = i;
+      for (unsigned j = 0; j < solvers.size(); j++) {
+        if (j != i) {
+          solvers[j]->interrupt();
+        }
+      }
+    }));
+  }
+  for (unsigned i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+  if (winner != -1) {
+    LOG(INFO) << "Solver configuration " << winner << " of " << solvers.size()
+              << " finished first";
+  } else {
+    winner = 0;
+    for (unsigned i = 1; i < solvers.size(); i++) {
+      if (solvers[i]->hasModel() &&
+          (!solvers[winner]->hasModel() ||
+           solvers[i]->getUpperBound() < solvers[winner]->getUpperBound())) {
+        winner = i;
+      }
+    }
+  }
+  model = models[winner];
+  return winner;
+}
+
+/**
+ * @brief      Sets the deadline of a search, which is the time limit from now.
+ */
+void Timetabler::startDeadline() {
+  deadline = std::chrono::steady_clock::now() +
+             std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                 std::chrono::duration<double>(timeLimit));
+}
+
+/**
+ * @brief      Checks if the deadline of the search has passed.
+ *
+ * @return     True, if the time is limited and the deadline has passed, False
+ * otherwise
+ */
+bool Timetabler::isPastDeadline() {
+  return timeLimit > 0 && std::chrono::steady_clock::now() >= deadline;
+}
+
+/**
+ * @brief      Starts a thread that interrupts the solvers when the deadline of
+ * the search is reached.
+ *
+ * A phase of the search that starts after the deadline is stopped at once.
+ *
+ * @param[in]  solvers  The solvers to interrupt
+ *
+ * @return     The timer thread, which is not joinable if there is no time limit
+ */
+std::thread Timetabler::startTimer(const std::vector<TSolver *> &solvers) {
+  searchFinished = false;
+  if (timeLimit <= 0) {
+    return std::thread();
+  }
+  return std::thread([this, solvers]() {
+    std::unique_lock<std::mutex> lock(timerMutex);
+    if (!timerCondition.wait_until(lock, deadline,
+                                   [this]() { return searchFinished; })) {
+      LOG(INFO) << "Time limit reached, stopping the search";
+      for (unsigned i = 0; i < solvers.size(); i++) {
+        solvers[i]->interrupt();
+      }
+    }
+  });
+}
+
+/**
+ * @brief      Stops the timer thread started by startTimer(), if it is still
+ * running.
+ *
+ * @param      timer  The timer thread
+ */
+void Timetabler::stopTimer(std::thread &timer) {
+  {
+    std::lock_guard<std::mutex> lock(timerMutex);
+    searchFinished = true;
+  }
+  timerCondition.notify_all();
+  if (timer.joinable()) {
+    timer.join();
+  }
+}
+
 /**
  * @brief      Checks if a given set of variables are true in the model returned
  * by the solver.
@@ -255,11 +1154,15 @@ bool Timetabler::isVarTrue(const Var &v) {
 }
 
 /**
- * @brief      Calls the formula to issue a new variable and returns it.
+ * @brief      Calls the formula to issue a new variable and returns it, or
+ * the buffer of the part being encoded by this thread if there is one.
  *
  * @return     The new Var added to the formula
  */
 Var Timetabler::newVar() {
+  if (partBuffer != NULL) {
+    return partBuffer->newVar();
+  }
   Var var = formula->nVars();
   formula->newVar();
   return var;
@@ -274,15 +1177,81 @@ Var Timetabler::newVar() {
  * @return     The Lit corresponding to the new Var added to the formula
  */
 Lit Timetabler::newLiteral(bool sign) {
-  Lit p = mkLit(formula->nVars(), sign);
-  formula->newVar();
-  return p;
+  return mkLit(newVar(), sign);
+}
+
+/**
+ * @brief      Gets the number of variables, including those of the part of
+ * the formula being encoded by this thread.
+ *
+ * @return     The number of variables
+ */
+int Timetabler::getVarCount() {
+  return (partBuffer != NULL) ? partBuffer->getVarCount() : formula->nVars();
+}
+
+/**
+ * @brief      Encodes parts of the formula in parallel, and adds them to the
+ * formula in order.
+ *
+ * Each part is encoded by one of threadCount threads into a ClauseBuffer of
+ * its own, to which the variables and the clauses created through newVar(),
+ * newLiteral() and addToFormula() go. The buffers are merged into the formula
+ * in the order of the parts, a batch of Global::ENCODING_BATCH_SIZE parts at a
+ * time, so the formula is the same for any number of threads. A part must not
+ * use the variables created by another part.
+ *
+ * @param[in]  partCount   The number of parts
+ * @param[in]  encodePart  The function which encodes a part given its index
+ */
+void Timetabler::encodeInParallel(
+    unsigned partCount, const std::function<void(unsigned)> &encodePart) {
+  assert(partBuffer == NULL);
+  for (unsigned first = 0; first < partCount;
+       first += Global::ENCODING_BATCH_SIZE) {
+    unsigned count =
+        std::min<unsigned>(Global::ENCODING_BATCH_SIZE, partCount - first);
+    std::vector<ClauseBuffer> buffers(count, ClauseBuffer(formula->nVars()));
+    std::atomic<unsigned> nextPart(0);
+    auto encodeParts = [&]() {
+      for (unsigned i = nextPart++; i < count; i = nextPart++) {
+        partBuffer = &buffers[i];
+        encodePart(first + i);
+        partBuffer = NULL;
+      }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < std::min(threadCount, count); t++) {
+      threads.push_back(std::thread(encodeParts));
+    }
+    encodeParts();
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    for (ClauseBuffer &buffer : buffers) {
+      buffer.mergeInto(formula);
+    }
+  }
 }
 
 /**
  * @brief      Prints the result of the problem.
  */
 void Timetabler::printResult(SolverStatus status) {
+  if (greedyModel) {
+    LOG(WARNING) << "Search stopped before any timetable was found, using the "
+                    "greedy timetable, which is not checked against the custom "
+                    "and soft constraints";
+  } else if (status != SolverStatus::Unsolved) {
+    if (optimal) {
+      LOG(INFO) << "Optimal timetable found with cost " << cost;
+    } else {
+      LOG(WARNING) << "Search stopped before proving optimality, best cost "
+                   << cost << ", lower bound " << lowerBound;
+    }
+  } else if (!optimal) {
+    LOG(WARNING) << "Search stopped before any timetable was found";
+  }
   if (status == SolverStatus::Solved) {
     LOG(INFO) << "All high level clauses were satisfied";
     displayChangesInGivenAssignment();
@@ -374,6 +1343,9 @@ void Timetabler::displayTimeTable() {
 /**
  * @brief      Writes the generated time table to a CSV file.
  *
+ * If the search was stopped by a limit before the time table was proved to be
+ * optimal, a status column marks every course as non-optimal.
+ *
  * @param[in]  fileName  The file path of the output CSV file
  */
 void Timetabler::writeOutput(std::string fileName) {
@@ -383,7 +1355,11 @@ void Timetabler::writeOutput(std::string fileName) {
   for (unsigned i = 0; i < data.programs.size(); i += 2) {
     fileObject << data.programs[i].getName() << ",";
   }
-  fileObject << "classroom,slot" << std::endl;
+  fileObject << "classroom,slot";
+  if (!optimal) {
+    fileObject << ",status";
+  }
+  fileObject << std::endl;
   for (unsigned i = 0; i < data.courses.size(); i++) {
     fileObject << data.courses[i].getName() << ","
                << data.courses[i].getClassSize() << ",";
@@ -431,6 +1407,11 @@ void Timetabler::writeOutput(std::string fileName) {
         fileObject << data.slots[j].getName();
       }
     }
+    if (greedyModel) {
+      fileObject << ",greedy";
+    } else if (!optimal) {
+      fileObject << ",non-optimal";
+    }
     fileObject << std::endl;
   }
   fileObject.close();
@@ -468,6 +1449,16 @@ void Timetabler::displayUnsatisfiedOutputReasons() {
 }
 
 /**
- * @brief      Destroys the object, and deletes the solver.
+ * @brief      Gets the MaxSAT formula to which the clauses are added.
+ *
+ * @return     A pointer to the MaxSAT formula
  */
-Timetabler::~Timetabler() { delete solver; }
+MaxSATFormula *Timetabler::getFormula() { return formula; }
+
+/**
+ * @brief      Destroys the object, and deletes the solvers.
+ */
+Timetabler::~Timetabler() {
+  delete solver;
+  delete sessionSolver;
+}
@@ -33,6 +33,7 @@
 #include "tsolver.h"
 
 #include "algorithms/Alg_OLL.h"
+#include "global.h"
 #include "mtl/Vec.h"
 #include "utils.h"
 
@@ -45,7 +46,326 @@ using namespace openwbo;
  * @param[in]  verb  The verbosity value to be given to the OLL object
  * @param[in]  enc   The encoding value to be given to the OLL object
  */
-TSolver::TSolver(int verb, int enc) : OLL(verb, enc) {}
+TSolver::TSolver(int verb, int enc) : OLL(verb, enc) {
+  interruptRequested = false;
+  searchCompleted = false;
+  conflictLimit = 0;
+  lastCoreSize = 0;
+  conflictsAtStart = 0;
+  sessionFormula = NULL;
+  searchGuard = lit_Undef;
+  hintModelFound = false;
+  setConfiguration(0);
+}
+
+/**
+ * @brief      Sets the configuration of the search.
+ *
+ * Configuration 0 is the default configuration of OLL. The other
+ * configurations give the SAT solver different random seeds and a small
+ * frequency of random decisions, and every odd numbered configuration
+ * considers all the soft clauses at once instead of stratifying them by
+ * weight. All the configurations find an optimal solution, but the time they
+ * take can differ widely, which makes them useful in a portfolio.
+ *
+ * @param[in]  index  The index of the configuration
+ */
+void TSolver::setConfiguration(unsigned index) {
+  configuration = index;
+  randomSeed = 91648253 + index;
+  randomVarFreq = (index == 0) ? 0 : 0.01 * (1 + index % 3);
+  stratification = (index % 2 == 0);
+}
+
+/**
+ * @brief      Asks the search to stop as soon as possible.
+ *
+ * This can be called from another thread while the search is running.
+ */
+void TSolver::interrupt() {
+  std::lock_guard<std::mutex> lock(solverMutex);
+  interruptRequested = true;
+  if (solver != NULL) {
+    solver->interrupt();
+  }
+}
+
+/**
+ * @brief      Checks if the last search ran until its result was proved.
+ *
+ * @return     True, if the search was completed, False if it was interrupted
+ */
+bool TSolver::isSearchCompleted() { return searchCompleted; }
+
+/**
+ * @brief      Limits the number of conflicts of the SAT solver over the whole
+ * search.
+ *
+ * @param[in]  limit  The number of conflicts, or 0 for no limit
+ */
+void TSolver::setConflictLimit(uint64_t limit) { conflictLimit = limit; }
+
+/**
+ * @brief      Checks if the last search found a model of the hard clauses.
+ *
+ * @return     True, if a model was found, False otherwise
+ */
+bool TSolver::hasModel() { return model.size() > 0; }
+
+/**
+ * @brief      Gets the cost of the best model found by the last search.
+ *
+ * @return     The cost of the model, which is the sum of the weights of the
+ * unsatisfied soft clauses
+ */
+uint64_t TSolver::getUpperBound() { return ubCost; }
+
+/**
+ * @brief      Gets the lower bound on the optimal cost proved by the last
+ * search.
+ *
+ * This is equal to the upper bound if the search was completed.
+ *
+ * @return     The lower bound
+ */
+uint64_t TSolver::getLowerBound() {
+  return searchCompleted && hasModel() ? ubCost : lbCost;
+}
+
+/**
+ * @brief      Sets the function called when a progress event occurs during
+ * the search.
+ *
+ * The function is called from the thread running the search, and should
+ * return quickly.
+ *
+ * @param[in]  callback  The function, or an empty function to stop reporting
+ */
+void TSolver::setProgressCallback(ProgressCallback callback) {
+  progressCallback = callback;
+}
+
+/**
+ * @brief      Reports the current state of the search to the progress
+ * callback, if one is set.
+ *
+ * @param[in]  type  The event that occurred
+ */
+void TSolver::reportProgress(ProgressEventType type) {
+  if (!progressCallback) {
+    return;
+  }
+  SearchProgress progress;
+  progress.type = type;
+  progress.configuration = configuration;
+  progress.elapsedSeconds = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() -
+                                searchStartTime)
+                                .count();
+  progress.upperBound = ubCost;
+  progress.lowerBound =
+      (type == ProgressEventType::Completed) ? getLowerBound() : lbCost;
+  progress.coreSize = lastCoreSize;
+  progress.coreCount = nbCores;
+  progress.modelCount = nbSatisfiable + (hintModelFound ? 1 : 0);
+  progress.variableCount = solver->nVars();
+  progress.clauseCount = solver->nClauses();
+  progressCallback(progress);
+}
+
+/**
+ * @brief      Starts an incremental session on the loaded formula.
+ *
+ * The SAT solver is built once with the hard clauses and the relaxed soft
+ * clauses, and is kept for all the following calls to tResolve().
+ */
+void TSolver::startSession() {
+  initRelaxation();
+  {
+    std::lock_guard<std::mutex> lock(solverMutex);
+    solver = rebuildSolver();
+    solver->random_seed = randomSeed;
+    solver->random_var_freq = randomVarFreq;
+  }
+  sessionFormula = maxsat_formula;
+}
+
+/**
+ * @brief      Adds a hard clause to the SAT solver of the session, which
+ * holds for all the following searches.
+ *
+ * @param      clause  The clause
+ */
+void TSolver::addSessionClause(vec<Lit> &clause) {
+  for (int i = 0; i < clause.size(); i++) {
+    while (var(clause[i]) >= solver->nVars()) {
+      newSATVariable(solver);
+    }
+  }
+  solver->addClause(clause);
+}
+
+/**
+ * @brief      Solves the formula of the session again, under the given
+ * assumptions and soft clause weights.
+ *
+ * The soft clauses of the session are given the new weights in a formula
+ * used only for this search, and the soft clauses with a weight of zero are
+ * left out. The cores found during the search may depend on the assumptions,
+ * so the clauses derived from them are guarded by a new literal, which is
+ * assumed during the search and falsified after it. The clauses learnt by the
+ * SAT solver from the hard clauses are kept.
+ *
+ * @param[in]  assumptions  The literals assumed to be true
+ * @param[in]  weights      The weight of each soft clause of the session
+ *
+ * @return     The model found by the solver. This could be empty if the hard
+ * clauses and the assumptions are unsatisfiable
+ */
+std::vector<lbool> TSolver::tResolve(const std::vector<Lit> &assumptions,
+                                     const std::vector<uint64_t> &weights) {
+  assert(sessionFormula != NULL);
+  assert((int)weights.size() == sessionFormula->nSoft());
+  // variables may have been added to either since the last search
+  while (solver->nVars() < sessionFormula->nVars()) {
+    newSATVariable(solver);
+  }
+  MaxSATFormula *searchFormula = new MaxSATFormula();
+  searchFormula->setProblemType(_WEIGHTED_);
+  while (searchFormula->nVars() < solver->nVars()) {
+    searchFormula->newVar();
+  }
+  for (int i = 0; i < sessionFormula->nSoft(); i++) {
+    if (weights[i] == 0) {
+      continue;
+    }
+    Soft &softClause = sessionFormula->getSoftClause(i);
+    searchFormula->addSoftClause(weights[i], softClause.clause,
+                                 softClause.relaxation_vars);
+    searchFormula->getSoftClause(searchFormula->nSoft() - 1).assumption_var =
+        softClause.assumption_var;
+  }
+  maxsat_formula = searchFormula;
+
+  ubCost = 0;
+  lbCost = 0;
+  nbCores = 0;
+  nbSatisfiable = 0;
+  sumSizeCores = 0;
+  model.clear();
+  coreMapping.clear();
+  boundMapping.clear();
+  activeSoft.clear();
+  searchGuard = maxsat_formula->newLiteral();
+  newSATVariable(solver);
+  fixedAssumptions.clear();
+  for (unsigned i = 0; i < assumptions.size(); i++) {
+    fixedAssumptions.push(assumptions[i]);
+  }
+  fixedAssumptions.push(searchGuard);
+  {
+    std::lock_guard<std::mutex> lock(solverMutex);
+    interruptRequested = false;
+    solver->clearInterrupt();
+  }
+  solver->budgetOff();
+
+  if (maxsat_formula->nSoft() == 0) {
+    // nothing to optimise, only check the hard clauses
+    searchStartTime = std::chrono::steady_clock::now();
+    conflictsAtStart = solver->conflicts;
+    reportProgress(ProgressEventType::Started);
+    vec<Lit> noAssumptions;
+    lbool res = searchWithFixedAssumptions(noAssumptions);
+    searchCompleted = (res != l_Undef);
+    if (res == l_True) {
+      nbSatisfiable++;
+      saveModel(solver->model);
+    }
+  } else {
+    tWeighted();
+  }
+  reportProgress(searchCompleted ? ProgressEventType::Completed
+                                 : ProgressEventType::Stopped);
+
+  solver->addClause(~searchGuard);
+  searchGuard = lit_Undef;
+  while (sessionFormula->nVars() < solver->nVars()) {
+    sessionFormula->newVar();
+  }
+  fixedAssumptions.clear();
+  maxsat_formula = sessionFormula;
+  delete searchFormula;
+  return Utils::convertVecDataToVector<lbool>(model, model.size());
+}
+
+/**
+ * @brief      Sets a previous solution to guide the following searches.
+ *
+ * The hint does not change the formula. The SAT solver prefers the hinted
+ * values in its decisions, and a model that agrees with the whole hint is
+ * looked for before the search, to give an initial upper bound.
+ *
+ * @param[in]  hint  The literals of the previous solution
+ */
+void TSolver::setHint(const std::vector<Lit> &hint) { this->hint = hint; }
+
+/**
+ * @brief      Seeds the phases of the SAT solver with the hint, and looks for
+ * a model that agrees with the whole hint, which is saved as the best model
+ * so far if found.
+ *
+ * The hint may not be satisfiable if the problem has changed, so only a small
+ * number of conflicts is spent on it.
+ */
+void TSolver::searchFromHint() {
+  // the values of the other variables are not hinted, prefer the values that
+  // satisfy the soft clauses
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    const vec<Lit> &clause = maxsat_formula->getSoftClause(i).clause;
+    for (int j = 0; j < clause.size(); j++) {
+      solver->setPolarity(var(clause[j]), sign(clause[j]));
+    }
+  }
+  vec<Lit> hintAssumptions;
+  for (unsigned i = 0; i < hint.size(); i++) {
+    while (var(hint[i]) >= solver->nVars()) {
+      newSATVariable(solver);
+    }
+    solver->setPolarity(var(hint[i]), sign(hint[i]));
+    hintAssumptions.push(hint[i]);
+  }
+  solver->setConfBudget(Global::HINT_CONFLICT_BUDGET);
+  lbool res = searchWithFixedAssumptions(hintAssumptions);
+  solver->budgetOff();
+  if (res != l_True) {
+    return;
+  }
+  saveModel(solver->model);
+  ubCost = computeCostModel(solver->model);
+  hintModelFound = true;
+  reportProgress(ProgressEventType::UpperBound);
+}
+
+/**
+ * @brief      Calls the SAT solver with the given assumptions, in addition to
+ * the fixed assumptions of the search.
+ *
+ * @param      assumptions  The assumptions
+ *
+ * @return     The result of the SAT solver
+ */
+lbool TSolver::searchWithFixedAssumptions(vec<Lit> &assumptions) {
+  if (fixedAssumptions.size() == 0) {
+    return searchSATSolver(solver, assumptions);
+  }
+  vec<Lit> allAssumptions;
+  fixedAssumptions.copyTo(allAssumptions);
+  for (int i = 0; i < assumptions.size(); i++) {
+    allAssumptions.push(assumptions[i]);
+  }
+  return searchSATSolver(solver, allAssumptions);
+}
 
 /**
  * @brief      Solves the MaxSAT problem by calling the solver
@@ -69,6 +389,8 @@ std::vector<lbool> TSolver::tSearch() {
 
   if (maxsat_formula->getProblemType() == _WEIGHTED_) {
     tWeighted();
+    reportProgress(searchCompleted ? ProgressEventType::Completed
+                                   : ProgressEventType::Stopped);
     return Utils::convertVecDataToVector<lbool>(model, model.size());
   } else {
     printf("Error: Use the solver in 'weighted' mode only!\n");
@@ -82,13 +404,35 @@ std::vector<lbool> TSolver::tSearch() {
  * This is a modification of the weighted() function in the OLL algorithm of
  * Open WBO. Most of the code is identical, except that when the result is
  * found, the function returns instead of printing the answer to stdout and
- * exiting.
+ * exiting. It also returns if the search is interrupted or reaches the
+ * conflict limit, in which case the model is the best one found so far.
  */
 void TSolver::tWeighted() {
   // nbInitialVariables = nVars();
   lbool res = l_True;
-  initRelaxation();
-  solver = rebuildSolver();
+  searchCompleted = true;
+  searchStartTime = std::chrono::steady_clock::now();
+  lastCoreSize = 0;
+  if (sessionFormula == NULL) {
+    initRelaxation();
+  }
+  {
+    std::lock_guard<std::mutex> lock(solverMutex);
+    if (sessionFormula == NULL) {
+      solver = rebuildSolver();
+      solver->random_seed = randomSeed;
+      solver->random_var_freq = randomVarFreq;
+    }
+    if (interruptRequested) {
+      solver->interrupt();
+    }
+  }
+  conflictsAtStart = solver->conflicts;
+  hintModelFound = false;
+  reportProgress(ProgressEventType::Started);
+  if (hint.size() > 0) {
+    searchFromHint();
+  }
 
   vec<Lit> assumptions;
   vec<Lit> joinObjFunction;
@@ -103,15 +447,28 @@ void TSolver::tWeighted() {
   std::set<Lit> cardinality_assumptions;
   vec<Encoder *> soft_cardinality;
 
-  min_weight = maxsat_formula->getMaximumWeight();
+  min_weight = stratification ? maxsat_formula->getMaximumWeight() : 1;
   // printf("current weight %d\n",maxsat_formula->getMaximumWeight());
 
   for (;;) {
-    res = searchSATSolver(solver, assumptions);
+    if (conflictLimit != 0) {
+      uint64_t conflicts = solver->conflicts - conflictsAtStart;
+      if (conflicts >= conflictLimit) {
+        searchCompleted = false;
+        return;
+      }
+      solver->setConfBudget(conflictLimit - conflicts);
+    }
+    res = searchWithFixedAssumptions(assumptions);
+    if (res == l_Undef) {
+      // the search was interrupted, or ran out of conflicts
+      searchCompleted = false;
+      return;
+    }
     if (res == l_True) {
       nbSatisfiable++;
       uint64_t newCost = computeCostModel(solver->model);
-      if (newCost < ubCost || nbSatisfiable == 1) {
+      if (newCost < ubCost || (nbSatisfiable == 1 && !hintModelFound)) {
         saveModel(solver->model);
         if (maxsat_formula->getFormat() == _FORMAT_PB_) {
           // optimization problem
@@ -121,6 +478,7 @@ void TSolver::tWeighted() {
         } else
           // printf("o %" PRId64 "\n", newCost + off_set);
           ubCost = newCost;
+        reportProgress(ProgressEventType::UpperBound);
       }
 
       if (nbSatisfiable == 1) {
@@ -211,6 +569,8 @@ void TSolver::tWeighted() {
 
       lbCost += min_core;
       nbCores++;
+      lastCoreSize = solver->conflict.size();
+      reportProgress(ProgressEventType::LowerBound);
       if (verbosity > 0)
         // printf("c LB : %-12" PRIu64 "\n", lbCost);
 
@@ -464,7 +824,11 @@ void TSolver::tWeighted() {
       if (soft_relax.size() == 1 && cardinality_relax.size() == 0) {
         // Unit core
         // printf("UNIT CORE\n");
-        solver->addClause(soft_relax[0]);
+        if (searchGuard == lit_Undef) {
+          solver->addClause(soft_relax[0]);
+        } else {
+          solver->addClause(~searchGuard, soft_relax[0]);
+        }
       }
 
       // assert (soft_relax.size() > 0 || cardinality_relax.size() != 1);
@@ -89,6 +89,51 @@ std::string getFieldName(FieldType fieldType, int index, Data &data) {
   return "Invalid Type";
 }
 
+/**
+ * @brief      Gets the number of values a given FieldType can take in the Data
+ *
+ * @param[in]  fieldType  The FieldType member
+ * @param      data       The Data object
+ *
+ * @return     The number of field values
+ */
+unsigned getFieldValueCount(FieldType fieldType, Data &data) {
+  if (fieldType == FieldType::classroom) return data.classrooms.size();
+  if (fieldType == FieldType::instructor) return data.instructors.size();
+  if (fieldType == FieldType::isMinor) return data.isMinors.size();
+  if (fieldType == FieldType::program) return data.programs.size();
+  if (fieldType == FieldType::segment) return data.segments.size();
+  if (fieldType == FieldType::slot) return data.slots.size();
+  assert(false && "Invalid field type!");
+  return 0;
+}
+
+/**
+ * @brief      Computes the cost of a model of a formula.
+ *
+ * @param      formula  The formula
+ * @param[in]  model    The model
+ *
+ * @return     The sum of the weights of the soft clauses not satisfied by the
+ * model
+ */
+uint64_t computeCost(MaxSATFormula *formula, const std::vector<lbool> &model) {
+  uint64_t total = 0;
+  for (int i = 0; i < formula->nSoft(); i++) {
+    const vec<Lit> &clause = formula->getSoftClause(i).clause;
+    bool satisfied = false;
+    for (int j = 0; j < clause.size() && !satisfied; j++) {
+      Var v = var(clause[j]);
+      satisfied = v < (int)model.size() &&
+                  model[v] == (sign(clause[j]) ? l_False : l_True);
+    }
+    if (!satisfied) {
+      total += formula->getSoftClause(i).weight;
+    }
+  }
+  return total;
+}
+
 /**
  * @brief      Constructor for the Logger.
  *
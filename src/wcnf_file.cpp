@@ -0,0 +1,312 @@
+#include "wcnf_file.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "MaxSATFormula.h"
+#include "global.h"
+#include "mtl/Vec.h"
+#include "utils.h"
+
+using namespace NSPACE;
+
+/**
+ * @brief      Constructs the WcnfFile object.
+ *
+ * @param      timetabler  The timetabler
+ */
+WcnfFile::WcnfFile(Timetabler *timetabler) : timetabler(timetabler) {}
+
+/**
+ * @brief      Writes the formula and the variable map.
+ *
+ * This must be called after all the clauses have been added.
+ *
+ * @param[in]  file  The file to which the formula is written
+ */
+void WcnfFile::write(std::string file) {
+  MaxSATFormula *formula = timetabler->getFormula();
+  std::ofstream out(file);
+  if (!out) {
+    LOG(ERROR) << "Could not open WCNF file " << file;
+  }
+  uint64_t top = 1;
+  for (int i = 0; i < formula->nSoft(); i++) {
+    top += formula->getSoftClause(i).weight;
+  }
+  auto writeClause = [&out](const vec<Lit> &clause) {
+    for (int i = 0; i < clause.size(); i++) {
+      out << (sign(clause[i]) ? "-" : "") << var(clause[i]) + 1 << " ";
+    }
+    out << "0\n";
+  };
+  out << "p wcnf " << formula->nVars() << " "
+      << formula->nHard() + formula->nSoft() << " " << top << "\n";
+  for (int i = 0; i < formula->nHard(); i++) {
+    out << top << " ";
+    writeClause(formula->getHardClause(i).clause);
+  }
+  for (int i = 0; i < formula->nSoft(); i++) {
+    out << formula->getSoftClause(i).weight << " ";
+    writeClause(formula->getSoftClause(i).clause);
+  }
+  out.close();
+  writeMap(file + ".map");
+  LOG(INFO) << "Formula written to " << file << " with " << formula->nVars()
+            << " variables, " << formula->nHard() << " hard and "
+            << formula->nSoft() << " soft clauses";
+}
+
+/**
+ * @brief      Writes the variable map of the formula.
+ *
+ * Each line starts with a tag. "t" gives the variables fixed to True and to
+ * False, "o" the name of a Course, "n" the name of a field value, "f" the
+ * variables of the field values of a Course for a FieldType, "h" the high
+ * level variables of a Course, "p" the variables of a predefined constraint
+ * and "u" the variables of the custom constraints. Variables are numbered
+ * from 1 as in the formula, and 0 stands for no variable.
+ *
+ * @param[in]  file  The file to which the map is written
+ */
+void WcnfFile::writeMap(std::string file) {
+  Data &data = timetabler->data;
+  std::ofstream out(file);
+  if (!out) {
+    LOG(ERROR) << "Could not open variable map file " << file;
+  }
+  auto writeVars = [&out](const std::vector<Var> &vars) {
+    out << vars.size();
+    for (Var v : vars) {
+      out << " " << (v == var_Undef ? 0 : v + 1);
+    }
+    out << "\n";
+  };
+  out << "c Timetabler variable map\n";
+  out << "t " << (data.trueVar == var_Undef ? 0 : data.trueVar + 1) << " "
+      << (data.falseVar == var_Undef ? 0 : data.falseVar + 1) << "\n";
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    out << "o " << i << " " << data.courses[i].getName() << "\n";
+  }
+  for (int j = 0; j < Global::FIELD_COUNT; j++) {
+    FieldType fieldType = static_cast<FieldType>(j);
+    unsigned valueCount = Utils::getFieldValueCount(fieldType, data);
+    for (unsigned k = 0; k < valueCount; k++) {
+      out << "n " << j << " " << k << " "
+          << (fieldType == FieldType::program
+                  ? data.programs[k].getNameWithType()
+                  : Utils::getFieldName(fieldType, k, data))
+          << "\n";
+    }
+  }
+  for (unsigned i = 0; i < data.fieldValueVars.size(); i++) {
+    for (int j = 0; j < Global::FIELD_COUNT; j++) {
+      out << "f " << i << " " << j << " ";
+      writeVars(data.fieldValueVars[i][j]);
+    }
+    out << "h " << i << " ";
+    writeVars(data.highLevelVars[i]);
+  }
+  for (unsigned i = 0; i < data.predefinedConstraintVars.size(); i++) {
+    out << "p " << i << " ";
+    writeVars(data.predefinedConstraintVars[i]);
+  }
+  out << "u ";
+  writeVars(data.customConstraintVars);
+}
+
+/**
+ * @brief      Reads a variable from a line of the variable map.
+ *
+ * @param      in    The stream of the line
+ *
+ * @return     The variable, or var_Undef if it is 0
+ */
+Var WcnfFile::readVar(std::istream &in) {
+  long long v;
+  if (!(in >> v) || v < 0) {
+    LOG(ERROR) << "Invalid variable in the variable map";
+  }
+  return (v == 0) ? var_Undef : static_cast<Var>(v - 1);
+}
+
+/**
+ * @brief      Reads a formula and its variable map, and adds the formula to
+ * the Timetabler.
+ *
+ * Both the classic WCNF format and the format in which hard clauses start
+ * with "h" are accepted. This must be called on a Timetabler with no
+ * variables, instead of parsing the fields, the input and the custom
+ * constraints, and adding the constraints.
+ *
+ * @param[in]  file  The file containing the formula
+ */
+void WcnfFile::read(std::string file) {
+  MaxSATFormula *formula = timetabler->getFormula();
+  std::ifstream in(file);
+  if (!in) {
+    LOG(ERROR) << "Could not open WCNF file " << file;
+  }
+  // in the classic format, clauses with at least the top weight are hard
+  uint64_t top = 0;
+  std::string line;
+  vec<Lit> clause;
+  unsigned lineNumber = 0;
+  while (std::getline(in, line)) {
+    lineNumber++;
+    if (line.empty() || line[0] == 'c') {
+      continue;
+    }
+    std::istringstream tokens(line);
+    if (line[0] == 'p') {
+      std::string p, format;
+      int varCount;
+      unsigned clauseCount;
+      tokens >> p >> format >> varCount >> clauseCount >> top;
+      if (format != "wcnf") {
+        LOG(ERROR) << "Unsupported format " << format << " in " << file;
+      }
+      while (formula->nVars() < varCount) {
+        timetabler->newVar();
+      }
+      continue;
+    }
+    bool hard = false;
+    uint64_t weight = 0;
+    if (line[0] == 'h') {
+      std::string h;
+      tokens >> h;
+      hard = true;
+    } else {
+      tokens >> weight;
+      hard = (top > 0 && weight >= top);
+    }
+    clause.clear();
+    long long lit;
+    bool terminated = false;
+    while (tokens >> lit) {
+      if (lit == 0) {
+        terminated = true;
+        break;
+      }
+      Var v = static_cast<Var>(std::llabs(lit) - 1);
+      while (formula->nVars() <= v) {
+        timetabler->newVar();
+      }
+      clause.push(mkLit(v, lit < 0));
+    }
+    if (!terminated) {
+      LOG(ERROR) << "Malformed clause on line " << lineNumber << " of "
+                 << file;
+    }
+    if (hard) {
+      formula->addHardClause(clause);
+    } else if (weight > 0) {
+      formula->addSoftClause(weight, clause);
+    }
+  }
+  readMap(file + ".map");
+  LOG(INFO) << "Formula read from " << file << " with " << formula->nVars()
+            << " variables, " << formula->nHard() << " hard and "
+            << formula->nSoft() << " soft clauses";
+}
+
+/**
+ * @brief      Reads the variable map of the formula into Data, in the form
+ * written by writeMap().
+ *
+ * @param[in]  file  The file containing the variable map
+ */
+void WcnfFile::readMap(std::string file) {
+  Data &data = timetabler->data;
+  std::ifstream in(file);
+  if (!in) {
+    LOG(ERROR) << "Could not open variable map file " << file;
+  }
+  auto readVars = [this](std::istream &tokens) {
+    unsigned count = 0;
+    tokens >> count;
+    std::vector<Var> vars;
+    for (unsigned i = 0; i < count; i++) {
+      vars.push_back(readVar(tokens));
+    }
+    return vars;
+  };
+  auto readName = [](std::istream &tokens) {
+    std::string name;
+    std::getline(tokens >> std::ws, name);
+    return name;
+  };
+  valueNames.assign(Global::FIELD_COUNT, std::vector<std::string>());
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream tokens(line);
+    std::string tag;
+    unsigned index = 0;
+    int fieldType = 0;
+    tokens >> tag;
+    if (tag == "t") {
+      data.trueVar = readVar(tokens);
+      data.falseVar = readVar(tokens);
+    } else if (tag == "o") {
+      tokens >> index;
+      courseNames.resize(std::max<size_t>(courseNames.size(), index + 1));
+      courseNames[index] = readName(tokens);
+    } else if (tag == "n") {
+      tokens >> fieldType >> index;
+      std::vector<std::string> &names = valueNames.at(fieldType);
+      names.resize(std::max<size_t>(names.size(), index + 1));
+      names[index] = readName(tokens);
+    } else if (tag == "f") {
+      tokens >> index >> fieldType;
+      data.fieldValueVars.resize(
+          std::max<size_t>(data.fieldValueVars.size(), index + 1),
+          std::vector<std::vector<Var>>(Global::FIELD_COUNT));
+      data.fieldValueVars[index].at(fieldType) = readVars(tokens);
+    } else if (tag == "h") {
+      tokens >> index;
+      data.highLevelVars.resize(
+          std::max<size_t>(data.highLevelVars.size(), index + 1));
+      data.highLevelVars[index] = readVars(tokens);
+    } else if (tag == "p") {
+      tokens >> index;
+      data.predefinedConstraintVars.resize(
+          std::max<size_t>(data.predefinedConstraintVars.size(), index + 1));
+      data.predefinedConstraintVars[index] = readVars(tokens);
+    } else if (tag == "u") {
+      data.customConstraintVars = readVars(tokens);
+    } else if (tag != "c" && tag != "") {
+      LOG(ERROR) << "Unknown tag " << tag << " in variable map " << file;
+    }
+  }
+}
+
+/**
+ * @brief      Writes the field values of the model of a formula that was
+ * read, as a CSV file with a row for each field value that is True.
+ *
+ * @param[in]  file  The file to which the field values are written
+ */
+void WcnfFile::writeAssignment(std::string file) {
+  Data &data = timetabler->data;
+  std::ofstream out(file);
+  if (!out) {
+    LOG(ERROR) << "Could not open output file " << file;
+  }
+  out << "course,field,value\n";
+  for (unsigned i = 0; i < data.fieldValueVars.size(); i++) {
+    for (int j = 0; j < Global::FIELD_COUNT; j++) {
+      const std::vector<Var> &vars = data.fieldValueVars[i][j];
+      for (unsigned k = 0; k < vars.size(); k++) {
+        if (vars[k] != var_Undef && timetabler->isVarTrue(vars[k])) {
+          out << (i < courseNames.size() ? courseNames[i] : "") << ","
+              << Utils::getFieldTypeName(static_cast<FieldType>(j)) << ","
+              << (k < valueNames[j].size() ? valueNames[j][k] : "") << "\n";
+        }
+      }
+    }
+  }
+}
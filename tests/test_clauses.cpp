@@ -2,7 +2,9 @@
 #include <iostream>
 #include "cclause.h"
 #include "clauses.h"
+#include "core/Solver.h"
 #include "global.h"
+#include "global_vars.h"
 #include "timetabler.h"
 
 class TestClauses : public ::testing::Test {
@@ -13,6 +15,8 @@ class TestClauses : public ::testing::Test {
   void SetUp();
   void TearDown() {}
   void printClause(Clauses);
+  bool evaluate(Clauses, unsigned);
+  void checkDisjunctionEncoding(DisjunctionEncoding);
 };
 
 void TestClauses::SetUp() {
@@ -55,6 +59,80 @@ void TestClauses::printClause(Clauses input) {
   std::cout << "Done" << std::endl;
 }
 
+bool TestClauses::evaluate(Clauses input, unsigned assignment) {
+  for (CClause clause : input.getClauses()) {
+    bool satisfied = false;
+    for (Lit l : clause.getLits()) {
+      if (((assignment >> var(l)) & 1) != sign(l)) {
+        satisfied = true;
+      }
+    }
+    if (!satisfied) return false;
+  }
+  return true;
+}
+
+/*
+ * Checks that disjunctions, negations and implications of clauseG1 and
+ * clauseG2 are satisfiable together with the hard clauses of the auxiliary
+ * variables exactly for the assignments to lit which satisfy them.
+ */
+void TestClauses::checkDisjunctionEncoding(DisjunctionEncoding encoding) {
+  Timetabler *savedTimetabler = timetabler;
+  timetabler = new Timetabler();
+  timetabler->data.disjunctionEncoding = encoding;
+  for (int i = 0; i < 6; i++) {
+    timetabler->newLiteral(false);
+  }
+  std::vector<Clauses> formulas;
+  std::vector<std::vector<bool>> expected(4);
+  for (unsigned a = 0; a < 64; a++) {
+    bool g1 = evaluate(clauseG1, a), g2 = evaluate(clauseG2, a);
+    expected[0].push_back(g1 || g2);
+    expected[1].push_back(!(g1 || g2));
+    expected[2].push_back(!g1 || g2);
+    expected[3].push_back(!(!(g1 || g2) || g1));
+  }
+  formulas.push_back(clauseG1 | clauseG2);
+  formulas.push_back(~(clauseG1 | clauseG2));
+  formulas.push_back(clauseG1 >> clauseG2);
+  formulas.push_back(~((clauseG1 | clauseG2) >> clauseG1));
+  MaxSATFormula *formula = timetabler->getFormula();
+  for (unsigned i = 0; i < formulas.size(); i++) {
+    Solver solver;
+    while (solver.nVars() < formula->nVars()) {
+      solver.newVar();
+    }
+    for (int j = 0; j < formula->nHard(); j++) {
+      solver.addClause(formula->getHardClause(j).clause);
+    }
+    for (CClause clause : formulas[i].getClauses()) {
+      vec<Lit> lits;
+      for (Lit l : clause.getLits()) {
+        lits.push(l);
+      }
+      solver.addClause(lits);
+    }
+    for (unsigned a = 0; a < 64; a++) {
+      vec<Lit> assumptions;
+      for (int j = 0; j < 6; j++) {
+        assumptions.push(mkLit(j, !((a >> j) & 1)));
+      }
+      ASSERT_EQ(expected[i][a], solver.solve(assumptions));
+    }
+  }
+  delete timetabler;
+  timetabler = savedTimetabler;
+}
+
+TEST_F(TestClauses, DisjunctionEncodingEquivalence) {
+  checkDisjunctionEncoding(DisjunctionEncoding::equivalence);
+}
+
+TEST_F(TestClauses, DisjunctionEncodingPolarity) {
+  checkDisjunctionEncoding(DisjunctionEncoding::polarity);
+}
+
 // Disabled because this need Timetabler and it fails (TODO)
 /*TEST_F(TestClauses, ORTestNormal) {
     Clauses result = clauseG1 | clauseG2;
@@ -0,0 +1,328 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "constraint_adder.h"
+#include "constraint_encoder.h"
+#include "core/Solver.h"
+#include "global.h"
+#include "test_helper.h"
+#include "timetabler.h"
+
+class TestConstraintAdder : public TestTimetabler {
+ public:
+  Timetabler *encode(std::string, std::string, ClashEncoding, bool,
+                     unsigned = 1);
+  void loadHardClauses(Timetabler *, Solver &);
+  void assumeAssignment(Timetabler *, const std::vector<unsigned> &,
+                        const std::vector<unsigned> &, vec<Lit> &);
+  void checkEquivalentEncodings(Timetabler *, Timetabler *);
+  bool nextAssignment(std::vector<unsigned> &, std::vector<unsigned> &,
+                      unsigned, unsigned);
+  std::vector<unsigned> renameInterchangeable(
+      const std::vector<unsigned> &,
+      const std::vector<std::vector<unsigned>> &);
+};
+
+/*
+ * Parses an example and adds the predefined constraints, with the time clash
+ * constraints forced to be hard and encoded with the given encoding, and with
+ * presolve enabled or disabled, using the given number of encoding threads.
+ */
+Timetabler *TestConstraintAdder::encode(std::string fieldsFile,
+                                        std::string inputFile,
+                                        ClashEncoding clashEncoding,
+                                        bool presolve,
+                                        unsigned threadCount) {
+  Timetabler *encoded = parseExample(fieldsFile, inputFile);
+  encoded->setThreadCount(threadCount);
+  encoded->data.clashEncoding = clashEncoding;
+  encoded->data.presolve = presolve;
+  encoded->data.predefinedClausesWeights
+      [PredefinedClauses::instructorSingleCourseAtATime] = -1;
+  encoded->data.predefinedClausesWeights
+      [PredefinedClauses::classroomSingleCourseAtATime] = -1;
+  encoded->data.predefinedClausesWeights
+      [PredefinedClauses::programSingleCoreCourseAtATime] = -1;
+  encodeExample(encoded, false);
+  return encoded;
+}
+
+void TestConstraintAdder::loadHardClauses(Timetabler *input, Solver &solver) {
+  MaxSATFormula *formula = input->getFormula();
+  while (solver.nVars() < formula->nVars()) {
+    solver.newVar();
+  }
+  for (int i = 0; i < formula->nHard(); i++) {
+    solver.addClause(formula->getHardClause(i).clause);
+  }
+}
+
+/*
+ * Fixes every field value of every course: the given slots and classrooms,
+ * and the input values for the other field types. The time clash constraints
+ * and the high level variables are required to hold.
+ */
+void TestConstraintAdder::assumeAssignment(
+    Timetabler *input, const std::vector<unsigned> &slots,
+    const std::vector<unsigned> &classrooms, vec<Lit> &assumptions) {
+  Data &data = input->data;
+  assumptions.clear();
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    Course &course = data.courses[i];
+    std::vector<int> programs = course.getPrograms();
+    for (unsigned j = 0; j < Global::FIELD_COUNT; j++) {
+      for (unsigned k = 0; k < data.fieldValueVars[i][j].size(); k++) {
+        bool value = false;
+        if (j == FieldType::slot) {
+          value = (slots[i] == k);
+        } else if (j == FieldType::classroom) {
+          value = (classrooms[i] == k);
+        } else if (j == FieldType::instructor) {
+          value = (course.getInstructor() == static_cast<int>(k));
+        } else if (j == FieldType::segment) {
+          value = (course.getSegment() == static_cast<int>(k));
+        } else if (j == FieldType::isMinor) {
+          value = (static_cast<unsigned>(course.getIsMinor()) == k);
+        } else if (j == FieldType::program) {
+          value = (std::find(programs.begin(), programs.end(), k) !=
+                   programs.end());
+        }
+        assumptions.push(mkLit(data.fieldValueVars[i][j][k], !value));
+      }
+      assumptions.push(mkLit(data.highLevelVars[i][j], false));
+    }
+  }
+  assumptions.push(mkLit(data.predefinedConstraintVars
+                             [PredefinedClauses::instructorSingleCourseAtATime]
+                             [0],
+                         false));
+  assumptions.push(mkLit(data.predefinedConstraintVars
+                             [PredefinedClauses::classroomSingleCourseAtATime]
+                             [0],
+                         false));
+  assumptions.push(mkLit(data.predefinedConstraintVars
+                             [PredefinedClauses::programSingleCoreCourseAtATime]
+                             [0],
+                         false));
+}
+
+/*
+ * Moves to the next assignment of slots and classrooms to the courses, slots
+ * changing fastest. Returns false after the last assignment.
+ */
+bool TestConstraintAdder::nextAssignment(std::vector<unsigned> &slots,
+                                         std::vector<unsigned> &classrooms,
+                                         unsigned slotCount,
+                                         unsigned classroomCount) {
+  unsigned courseCount = slots.size();
+  for (unsigned i = 0; i < 2 * courseCount; i++) {
+    if (i < courseCount) {
+      slots[i] = (slots[i] + 1) % slotCount;
+      if (slots[i] != 0) return true;
+    } else {
+      unsigned j = i - courseCount;
+      classrooms[j] = (classrooms[j] + 1) % classroomCount;
+      if (classrooms[j] != 0) return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Renames the values of each class of interchangeable values in the order in
+ * which they are first taken by the courses.
+ */
+std::vector<unsigned> TestConstraintAdder::renameInterchangeable(
+    const std::vector<unsigned> &values,
+    const std::vector<std::vector<unsigned>> &valueClasses) {
+  std::vector<unsigned> renamed = values;
+  for (const std::vector<unsigned> &valueClass : valueClasses) {
+    std::vector<unsigned> order;
+    for (unsigned value : values) {
+      if (std::find(valueClass.begin(), valueClass.end(), value) !=
+              valueClass.end() &&
+          std::find(order.begin(), order.end(), value) == order.end()) {
+        order.push_back(value);
+      }
+    }
+    for (unsigned i = 0; i < values.size(); i++) {
+      auto position = std::find(order.begin(), order.end(), values[i]);
+      if (position != order.end()) {
+        renamed[i] = valueClass[position - order.begin()];
+      }
+    }
+  }
+  return renamed;
+}
+
+/*
+ * Checks that two encodings of the same example accept exactly the same
+ * assignments of slots and classrooms to the courses.
+ */
+void TestConstraintAdder::checkEquivalentEncodings(Timetabler *pairwise,
+                                                   Timetabler *timeUnits) {
+  Solver pairwiseSolver, timeUnitsSolver;
+  loadHardClauses(pairwise, pairwiseSolver);
+  loadHardClauses(timeUnits, timeUnitsSolver);
+
+  unsigned courseCount = pairwise->data.courses.size();
+  unsigned slotCount = pairwise->data.slots.size();
+  unsigned classroomCount = pairwise->data.classrooms.size();
+  std::vector<unsigned> slots(courseCount, 0), classrooms(courseCount, 0);
+  unsigned satisfiable = 0, unsatisfiable = 0;
+  vec<Lit> assumptions;
+  while (true) {
+    assumeAssignment(pairwise, slots, classrooms, assumptions);
+    bool pairwiseResult = pairwiseSolver.solve(assumptions);
+    assumeAssignment(timeUnits, slots, classrooms, assumptions);
+    bool timeUnitsResult = timeUnitsSolver.solve(assumptions);
+    ASSERT_EQ(pairwiseResult, timeUnitsResult);
+    if (pairwiseResult) {
+      satisfiable++;
+    } else {
+      unsatisfiable++;
+    }
+    if (!nextAssignment(slots, classrooms, slotCount, classroomCount)) break;
+  }
+  ASSERT_GT(satisfiable, 0);
+  ASSERT_GT(unsatisfiable, 0);
+  delete pairwise;
+  delete timeUnits;
+}
+
+TEST_F(TestConstraintAdder, ClashEncodingsEquivalentExample1) {
+  std::string fields = TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml";
+  std::string input = TIMETABLER_EXAMPLES_DIR "/example1/input.csv";
+  checkEquivalentEncodings(
+      encode(fields, input, ClashEncoding::pairwise, true),
+      encode(fields, input, ClashEncoding::timeUnits, true));
+}
+
+TEST_F(TestConstraintAdder, ClashEncodingsEquivalentExample2) {
+  std::string fields = TIMETABLER_EXAMPLES_DIR "/example2/fields.yaml";
+  std::string input = TIMETABLER_EXAMPLES_DIR "/example2/input.csv";
+  checkEquivalentEncodings(
+      encode(fields, input, ClashEncoding::pairwise, true),
+      encode(fields, input, ClashEncoding::timeUnits, true));
+}
+
+TEST_F(TestConstraintAdder, PresolveEquivalentExample1) {
+  std::string fields = TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml";
+  std::string input = TIMETABLER_EXAMPLES_DIR "/example1/input.csv";
+  Timetabler *presolved = encode(fields, input, ClashEncoding::pairwise, true);
+  Timetabler *plain = encode(fields, input, ClashEncoding::pairwise, false);
+  ASSERT_LT(presolved->getFormula()->nVars(), plain->getFormula()->nVars());
+  ASSERT_LT(presolved->getFormula()->nHard(), plain->getFormula()->nHard());
+  checkEquivalentEncodings(presolved, plain);
+}
+
+/*
+ * Only facts that hold in every model fix field values: hard existing
+ * assignments, and classrooms too small for a course when the constraint of
+ * exactly one classroom per course cannot be relaxed.
+ */
+TEST_F(TestConstraintAdder, PresolveUsesOnlyUnguardedFactsExample1) {
+  Timetabler *parsed =
+      parseExample(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml",
+                   TIMETABLER_EXAMPLES_DIR "/example1/input.csv");
+  Data &data = parsed->data;
+  ASSERT_GT(data.courses[0].getClassSize(), 10);
+  data.classrooms[0] = Classroom(data.classrooms[0].getName(), 10);
+  data.predefinedClausesWeights
+      [PredefinedClauses::exactlyOneClassroomPerCourse] = -1;
+  ASSERT_LT(data.existingAssignmentWeights[FieldType::instructor], 0);
+  ASSERT_GT(data.existingAssignmentWeights[FieldType::classroom], 0);
+
+  data.highLevelVarWeights[FieldType::classroom] = 2;
+  data.computeFixedFieldValues();
+  EXPECT_EQ(data.fixedFieldValues[0][FieldType::classroom][0], l_Undef);
+  const std::vector<lbool> &existing =
+      data.existingAssignmentVars[0][FieldType::instructor];
+  for (unsigned k = 0; k < existing.size(); k++) {
+    EXPECT_EQ(data.fixedFieldValues[0][FieldType::instructor][k], existing[k]);
+  }
+
+  data.highLevelVarWeights[FieldType::classroom] = -2;
+  data.computeFixedFieldValues();
+  EXPECT_EQ(data.fixedFieldValues[0][FieldType::classroom][0], l_False);
+  for (unsigned k = 1; k < data.classrooms.size(); k++) {
+    EXPECT_EQ(data.fixedFieldValues[0][FieldType::classroom][k], l_Undef);
+  }
+}
+
+TEST_F(TestConstraintAdder, SymmetryBreakingKeepsRenamedAssignmentsExample1) {
+  std::string fields = TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml";
+  std::string input = TIMETABLER_EXAMPLES_DIR "/example1/input.csv";
+  Timetabler *plain = encode(fields, input, ClashEncoding::pairwise, true);
+  Timetabler *broken = encode(fields, input, ClashEncoding::pairwise, true);
+  ConstraintEncoder encoder(broken);
+  ConstraintAdder constraintAdder(&encoder, broken);
+  constraintAdder.addSymmetryBreakingConstraints();
+  std::vector<std::vector<unsigned>> valueClasses =
+      broken->data.getInterchangeableValues(FieldType::classroom);
+  ASSERT_GT(valueClasses.size(), 0);
+
+  Solver plainSolver, brokenSolver;
+  loadHardClauses(plain, plainSolver);
+  loadHardClauses(broken, brokenSolver);
+  unsigned courseCount = plain->data.courses.size();
+  std::vector<unsigned> slots(courseCount, 0), classrooms(courseCount, 0);
+  unsigned removed = 0;
+  vec<Lit> assumptions;
+  do {
+    assumeAssignment(plain, slots, classrooms, assumptions);
+    if (!plainSolver.solve(assumptions)) continue;
+    // every accepted assignment has a renaming that is still accepted
+    assumeAssignment(broken, slots,
+                     renameInterchangeable(classrooms, valueClasses),
+                     assumptions);
+    ASSERT_TRUE(brokenSolver.solve(assumptions));
+    assumeAssignment(broken, slots, classrooms, assumptions);
+    if (!brokenSolver.solve(assumptions)) {
+      removed++;
+    }
+  } while (nextAssignment(slots, classrooms, plain->data.slots.size(),
+                          plain->data.classrooms.size()));
+  ASSERT_GT(removed, 0);
+  delete plain;
+  delete broken;
+}
+
+/*
+ * Checks that the formula does not depend on the number of threads used to
+ * encode it, clause by clause and weight by weight.
+ */
+TEST_F(TestConstraintAdder, EncodingSameForAnyThreadCountExample2) {
+  std::string fields = TIMETABLER_EXAMPLES_DIR "/example2/fields.yaml";
+  std::string input = TIMETABLER_EXAMPLES_DIR "/example2/input.csv";
+  Timetabler *single =
+      encode(fields, input, ClashEncoding::pairwise, true, 1);
+  Timetabler *parallel =
+      encode(fields, input, ClashEncoding::pairwise, true, 4);
+  MaxSATFormula *singleFormula = single->getFormula();
+  MaxSATFormula *parallelFormula = parallel->getFormula();
+  ASSERT_EQ(parallelFormula->nVars(), singleFormula->nVars());
+  ASSERT_EQ(parallelFormula->nHard(), singleFormula->nHard());
+  ASSERT_EQ(parallelFormula->nSoft(), singleFormula->nSoft());
+  for (int i = 0; i < singleFormula->nHard(); i++) {
+    const vec<Lit> &expected = singleFormula->getHardClause(i).clause;
+    const vec<Lit> &actual = parallelFormula->getHardClause(i).clause;
+    ASSERT_EQ(actual.size(), expected.size());
+    for (int j = 0; j < expected.size(); j++) {
+      ASSERT_EQ(actual[j], expected[j]);
+    }
+  }
+  for (int i = 0; i < singleFormula->nSoft(); i++) {
+    const vec<Lit> &expected = singleFormula->getSoftClause(i).clause;
+    const vec<Lit> &actual = parallelFormula->getSoftClause(i).clause;
+    ASSERT_EQ(parallelFormula->getSoftClause(i).weight,
+              singleFormula->getSoftClause(i).weight);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (int j = 0; j < expected.size(); j++) {
+      ASSERT_EQ(actual[j], expected[j]);
+    }
+  }
+  delete parallel;
+  delete single;
+}
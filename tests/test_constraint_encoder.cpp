@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "clauses.h"
+#include "constraint_encoder.h"
+#include "core/Solver.h"
+#include "global.h"
+#include "global_vars.h"
+#include "test_helper.h"
+#include "timetabler.h"
+
+class TestConstraintEncoder : public TestTimetabler {
+ public:
+  void checkAtMostOne(AtMostOneEncoding, unsigned);
+};
+
+/*
+ * Encodes that at most one of a number of classroom values is True for a
+ * single course, and checks that exactly the assignments with at most one
+ * True value satisfy the clauses.
+ */
+void TestConstraintEncoder::checkAtMostOne(AtMostOneEncoding encoding,
+                                           unsigned valueCount) {
+  timetabler = new Timetabler();
+  Data &data = timetabler->data;
+  data.fieldValueVars.assign(
+      1, std::vector<std::vector<Var>>(Global::FIELD_COUNT));
+  for (unsigned i = 0; i < valueCount; i++) {
+    data.fieldValueVars[0][FieldType::classroom].push_back(
+        timetabler->newVar());
+  }
+  data.atMostOneEncodings[FieldType::classroom] = encoding;
+  ConstraintEncoder encoder(timetabler);
+  Clauses clauses =
+      encoder.hasAtMostOneFieldValueTrue(0, FieldType::classroom);
+
+  Solver solver;
+  while (solver.nVars() < timetabler->getFormula()->nVars()) {
+    solver.newVar();
+  }
+  for (CClause clause : clauses.getClauses()) {
+    vec<Lit> lits;
+    for (Lit lit : clause.getLits()) {
+      lits.push(lit);
+    }
+    solver.addClause(lits);
+  }
+  for (unsigned assignment = 0; assignment < (1u << valueCount);
+       assignment++) {
+    vec<Lit> assumptions;
+    unsigned trueCount = 0;
+    for (unsigned i = 0; i < valueCount; i++) {
+      bool value = (assignment >> i) & 1;
+      trueCount += value;
+      assumptions.push(
+          mkLit(data.fieldValueVars[0][FieldType::classroom][i], !value));
+    }
+    ASSERT_EQ(trueCount <= 1, solver.solve(assumptions));
+  }
+  delete timetabler;
+}
+
+TEST_F(TestConstraintEncoder, AtMostOnePairwise) {
+  for (unsigned n = 1; n <= 9; n++) {
+    checkAtMostOne(AtMostOneEncoding::pairwise, n);
+  }
+}
+
+TEST_F(TestConstraintEncoder, AtMostOneSequential) {
+  for (unsigned n = 1; n <= 9; n++) {
+    checkAtMostOne(AtMostOneEncoding::sequential, n);
+  }
+}
+
+TEST_F(TestConstraintEncoder, AtMostOneCommander) {
+  for (unsigned n = 1; n <= 11; n++) {
+    checkAtMostOne(AtMostOneEncoding::commander, n);
+  }
+}
+
+TEST_F(TestConstraintEncoder, AtMostOneBimander) {
+  for (unsigned n = 1; n <= 11; n++) {
+    checkAtMostOne(AtMostOneEncoding::bimander, n);
+  }
+}
+
+TEST_F(TestConstraintEncoder, AtMostOneAutomatic) {
+  for (unsigned n = 1; n <= 9; n++) {
+    checkAtMostOne(AtMostOneEncoding::automatic, n);
+  }
+}
+
+/*
+ * Checks that the literal for two courses having the same classroom is True
+ * exactly when they have the same classroom, and that it is encoded once for
+ * the pair of courses.
+ */
+TEST_F(TestConstraintEncoder, HasSameFieldTypeAndValueCached) {
+  const unsigned valueCount = 3;
+  timetabler = new Timetabler();
+  Data &data = timetabler->data;
+  data.fieldValueVars.assign(
+      2, std::vector<std::vector<Var>>(Global::FIELD_COUNT));
+  for (unsigned course = 0; course < 2; course++) {
+    for (unsigned i = 0; i < valueCount; i++) {
+      data.fieldValueVars[course][FieldType::classroom].push_back(
+          timetabler->newVar());
+    }
+  }
+  ConstraintEncoder encoder(timetabler);
+  std::vector<CClause> same =
+      encoder.hasSameFieldTypeAndValue(0, 1, FieldType::classroom)
+          .getClauses();
+  int varCount = timetabler->getFormula()->nVars();
+  std::vector<CClause> sameAgain =
+      encoder.hasSameFieldTypeAndValue(1, 0, FieldType::classroom)
+          .getClauses();
+  ASSERT_EQ(encoder.getCacheHitCount(), 1);
+  ASSERT_EQ(timetabler->getFormula()->nVars(), varCount);
+  ASSERT_EQ(same.size(), 1);
+  ASSERT_EQ(sameAgain.size(), 1);
+  ASSERT_EQ(same[0].getLits(), sameAgain[0].getLits());
+  ASSERT_EQ(same[0].getLits().size(), 1);
+  Lit sameLit = same[0].getLits()[0];
+
+  Solver solver;
+  while (solver.nVars() < timetabler->getFormula()->nVars()) {
+    solver.newVar();
+  }
+  for (int i = 0; i < timetabler->getFormula()->nHard(); i++) {
+    solver.addClause(timetabler->getFormula()->getHardClause(i).clause);
+  }
+  for (unsigned value1 = 0; value1 < valueCount; value1++) {
+    for (unsigned value2 = 0; value2 < valueCount; value2++) {
+      vec<Lit> assumptions;
+      for (unsigned i = 0; i < valueCount; i++) {
+        assumptions.push(mkLit(data.fieldValueVars[0][FieldType::classroom][i],
+                               i != value1));
+        assumptions.push(mkLit(data.fieldValueVars[1][FieldType::classroom][i],
+                               i != value2));
+      }
+      assumptions.push(sameLit);
+      ASSERT_EQ(value1 == value2, solver.solve(assumptions));
+      assumptions.last() = ~sameLit;
+      ASSERT_EQ(value1 != value2, solver.solve(assumptions));
+    }
+  }
+  delete timetabler;
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "csv_reader.h"
+#include "global_vars.h"
+#include "parser.h"
+#include "test_helper.h"
+#include "timetabler.h"
+
+class TestCsvReader : public TestTimetabler {
+ public:
+  void writeFile(std::string, std::string);
+};
+
+/*
+ * Writes the given contents to a file.
+ */
+void TestCsvReader::writeFile(std::string file, std::string contents) {
+  std::ofstream out(file, std::ios::binary);
+  out << contents;
+}
+
+/*
+ * Reads quoted fields, line breaks with carriage returns, empty lines, short
+ * rows and a last row with no line break.
+ */
+TEST_F(TestCsvReader, ReadsRows) {
+  std::string file = getTempPath("rows.csv");
+  writeFile(file,
+            "name,size,note\r\n"
+            "a,1,\"x, \"\"y\"\"\"\r\n"
+            "\r\n"
+            "\"b\",2\n"
+            "c,3,\"two\nlines\"");
+  CsvReader reader(file);
+  int name = reader.getColumn("name");
+  int size = reader.getColumn("size");
+  int note = reader.getColumn("note");
+  ASSERT_EQ(name, 0);
+  ASSERT_EQ(note, 2);
+  ASSERT_EQ(reader.getColumn("slot"), -1);
+
+  ASSERT_TRUE(reader.readRow());
+  ASSERT_EQ(reader.getLineNumber(), 2u);
+  ASSERT_EQ(reader.getField(name), "a");
+  ASSERT_TRUE(reader.isField(size, "1"));
+  ASSERT_FALSE(reader.isField(size, "12"));
+  ASSERT_EQ(reader.getField(note), "x, \"y\"");
+
+  ASSERT_TRUE(reader.readRow());
+  ASSERT_EQ(reader.getLineNumber(), 4u);
+  ASSERT_EQ(reader.getField(name), "b");
+  ASSERT_TRUE(reader.isField(name, "b"));
+  ASSERT_EQ(reader.getField(note), "");
+  ASSERT_TRUE(reader.isField(note, ""));
+  ASSERT_TRUE(reader.isField(-1, ""));
+
+  ASSERT_TRUE(reader.readRow());
+  ASSERT_EQ(reader.getLineNumber(), 5u);
+  ASSERT_EQ(reader.getField(size), "3");
+  ASSERT_EQ(reader.getField(note), "two\nlines");
+
+  ASSERT_FALSE(reader.readRow());
+}
+
+/*
+ * Parses the input of example 1 split across two files, and checks that the
+ * courses and the existing assignments are the same as from a single file.
+ */
+TEST_F(TestCsvReader, ParsesSplitInputExample1) {
+  std::string input = TIMETABLER_EXAMPLES_DIR "/example1/input.csv";
+  std::ifstream in(input);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(in, line)) {
+    lines.push_back(line + "\n");
+  }
+  ASSERT_GT(lines.size(), 2u);
+  std::string first = lines[0] + lines[1];
+  std::string second = lines[0];
+  for (unsigned i = 2; i < lines.size(); i++) {
+    second += lines[i];
+  }
+  std::vector<std::string> files = {getTempPath("input1.csv"),
+                                    getTempPath("input2.csv")};
+  writeFile(files[0], first);
+  writeFile(files[1], second);
+
+  Timetabler *single =
+      parseExample(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml", input);
+
+  Timetabler *split = new Timetabler();
+  timetabler = split;
+  Parser splitParser(split);
+  splitParser.parseFields(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml");
+  splitParser.parseInput(files);
+
+  ASSERT_EQ(split->data.courses.size(), single->data.courses.size());
+  for (unsigned i = 0; i < split->data.courses.size(); i++) {
+    ASSERT_EQ(split->data.courses[i].getName(),
+              single->data.courses[i].getName());
+    ASSERT_EQ(split->data.courses[i].getInstructor(),
+              single->data.courses[i].getInstructor());
+    ASSERT_EQ(split->data.courses[i].getPrograms(),
+              single->data.courses[i].getPrograms());
+    ASSERT_EQ(split->data.getCourseIndex(split->data.courses[i].getName()),
+              static_cast<int>(i));
+  }
+  ASSERT_EQ(split->data.existingAssignmentVars,
+            single->data.existingAssignmentVars);
+
+  delete split;
+  delete single;
+}
+
+/*
+ * A file that cannot be opened and an unterminated quoted field are kept as
+ * the error of the reader, instead of being logged, and end the rows.
+ */
+TEST_F(TestCsvReader, KeepsErrors) {
+  CsvReader missing(getTempPath("missing.csv"));
+  EXPECT_NE(missing.getError(), "");
+  EXPECT_EQ(missing.getColumn("name"), -1);
+  EXPECT_FALSE(missing.readRow());
+
+  std::string file = getTempPath("unterminated.csv");
+  writeFile(file, "name,note\na,1\nb,\"two\nlines\n");
+  CsvReader reader(file);
+  EXPECT_EQ(reader.getError(), "");
+  ASSERT_TRUE(reader.readRow());
+  EXPECT_EQ(reader.getField(0), "a");
+  EXPECT_FALSE(reader.readRow());
+  EXPECT_EQ(reader.getError(),
+            "Unterminated quoted field on line 3 of " + file);
+  EXPECT_FALSE(reader.readRow());
+}
+
+/*
+ * An error in any of several input files, including a class size that is not
+ * a number and a file that does not exist, is logged by the main thread once
+ * every file has been parsed, and exits.
+ */
+TEST_F(TestCsvReader, SplitInputErrorsExitExample1) {
+  std::string header =
+      "name,class_size,instructor,segment,is_minor,B.Tech.1,B.Tech.2,"
+      "B.Tech.3,B.Tech.4,M.Tech.,classroom,slot\n";
+  const std::vector<std::string> invalidInputs = {
+      header + "C2,many,A,16,No,Core,No,No,No,No,,\n",
+      header + "C2,30,Unknown,16,No,Core,No,No,No,No,,\n",
+      "name,class_size,segment\nC2,30,16\n", ""};
+  for (unsigned i = 0; i < invalidInputs.size(); i++) {
+    std::vector<std::string> files = {getTempPath("input1.csv"),
+                                      getTempPath("input2.csv")};
+    writeFile(files[0], header + "C1,30,A,16,No,Core,No,No,No,No,,\n");
+    if (invalidInputs[i] != "") {
+      writeFile(files[1], invalidInputs[i]);
+    } else {
+      files[1] = getTempPath("missing.csv");
+    }
+    Timetabler *split = new Timetabler();
+    timetabler = split;
+    Parser splitParser(split);
+    splitParser.parseFields(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml");
+    EXPECT_EXIT(splitParser.parseInput(files), ::testing::ExitedWithCode(1),
+                "");
+    delete split;
+  }
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "data.h"
+#include "global.h"
+#include "test_helper.h"
+#include "timetabler.h"
+#include "utils.h"
+
+class TestData : public TestTimetabler {
+ public:
+  std::string readExample1(std::string);
+};
+
+/*
+ * Reads a file of example 1.
+ */
+std::string TestData::readExample1(std::string name) {
+  std::ifstream in(TIMETABLER_EXAMPLES_DIR "/example1/" + name);
+  std::ostringstream stream;
+  stream << in.rdbuf();
+  return stream.str();
+}
+
+/*
+ * Every field value and every Course is found by its name, with programs
+ * named along with their type, and unknown names are not found.
+ */
+TEST_F(TestData, IndicesExample1) {
+  Timetabler *parsed =
+      parseExample(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml",
+                   TIMETABLER_EXAMPLES_DIR "/example1/input.csv");
+  Data &data = parsed->data;
+  for (int j = 0; j < Global::FIELD_COUNT; j++) {
+    FieldType fieldType = static_cast<FieldType>(j);
+    unsigned valueCount = Utils::getFieldValueCount(fieldType, data);
+    for (unsigned k = 0; k < valueCount; k++) {
+      std::string name = (fieldType == FieldType::program)
+                             ? data.programs[k].getNameWithType()
+                             : Utils::getFieldName(fieldType, k, data);
+      EXPECT_EQ(data.getFieldValueIndex(fieldType, name), (int)k);
+    }
+    EXPECT_EQ(data.getFieldValueIndex(fieldType, "Unknown"), -1);
+  }
+  ASSERT_GT(data.courses.size(), 0);
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    EXPECT_EQ(data.getCourseIndex(data.courses[i].getName()), (int)i);
+  }
+  EXPECT_EQ(data.getCourseIndex("Unknown"), -1);
+  EXPECT_EQ(data.getCourseIndex(""), -1);
+  delete parsed;
+}
+
+/*
+ * Two values of a field with the same name are an error, which is logged to
+ * the standard output and exits.
+ */
+TEST_F(TestData, DuplicateFieldValueName) {
+  std::string fields = readExample1("fields.yaml");
+  size_t position = fields.find("  - B\n");
+  ASSERT_NE(position, std::string::npos);
+  fields.replace(position, 6, "  - A\n");
+  std::string fieldsFile = writeTempFile("fields.yaml", fields);
+  EXPECT_EXIT(parseExample(fieldsFile,
+                           TIMETABLER_EXAMPLES_DIR "/example1/input.csv"),
+              ::testing::ExitedWithCode(1), "");
+}
+
+/*
+ * Two Courses with the same name are an error, which is logged to the
+ * standard output and exits.
+ */
+TEST_F(TestData, DuplicateCourseName) {
+  std::string input = readExample1("input.csv");
+  size_t start = input.find("\nC1,");
+  ASSERT_NE(start, std::string::npos);
+  size_t end = input.find('\n', start + 1);
+  ASSERT_NE(end, std::string::npos);
+  input.insert(end, input.substr(start, end - start));
+  std::string inputFile = writeTempFile("input.csv", input);
+  EXPECT_EXIT(
+      parseExample(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml", inputFile),
+      ::testing::ExitedWithCode(1), "");
+}
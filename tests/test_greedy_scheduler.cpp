@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "core/Solver.h"
+#include "global.h"
+#include "greedy_scheduler.h"
+#include "test_helper.h"
+#include "timetabler.h"
+
+class TestGreedyScheduler : public TestTimetabler {
+ public:
+  void checkHardConstraints(std::string, std::string);
+};
+
+/*
+ * Parses an example, adds the predefined constraints, and checks that the
+ * greedy timetable schedules every course and satisfies the hard constraints.
+ */
+void TestGreedyScheduler::checkHardConstraints(std::string fieldsFile,
+                                               std::string inputFile) {
+  Timetabler *encoded = parseExample(fieldsFile, inputFile);
+  encodeExample(encoded, true);
+  Data &data = encoded->data;
+
+  GreedyScheduler scheduler(data);
+  ASSERT_EQ(scheduler.schedule(), data.courses.size());
+  std::vector<std::vector<std::vector<lbool>>> values =
+      scheduler.getFieldValues();
+
+  Solver solver;
+  MaxSATFormula *formula = encoded->getFormula();
+  while (solver.nVars() < formula->nVars()) {
+    solver.newVar();
+  }
+  for (int i = 0; i < formula->nHard(); i++) {
+    solver.addClause(formula->getHardClause(i).clause);
+  }
+  vec<Lit> assumptions;
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    for (unsigned j = 0; j < Global::FIELD_COUNT; j++) {
+      const std::vector<Var> &vars = data.fieldValueVars[i][j];
+      ASSERT_EQ(values[i][j].size(), vars.size());
+      for (unsigned k = 0; k < vars.size(); k++) {
+        assumptions.push(mkLit(vars[k], values[i][j][k] == l_False));
+      }
+      assumptions.push(mkLit(data.highLevelVars[i][j], false));
+    }
+  }
+  for (int i = 0; i < Global::PREDEFINED_CLAUSES_COUNT; i++) {
+    if (data.predefinedClausesWeights[i] >= 0) {
+      continue;
+    }
+    for (Var v : data.predefinedConstraintVars[i]) {
+      assumptions.push(mkLit(v, false));
+    }
+  }
+  ASSERT_TRUE(solver.solve(assumptions));
+  delete encoded;
+}
+
+TEST_F(TestGreedyScheduler, HardConstraintsExample1) {
+  checkHardConstraints(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml",
+                       TIMETABLER_EXAMPLES_DIR "/example1/input.csv");
+}
+
+TEST_F(TestGreedyScheduler, HardConstraintsExample2) {
+  checkHardConstraints(TIMETABLER_EXAMPLES_DIR "/example2/fields.yaml",
+                       TIMETABLER_EXAMPLES_DIR "/example2/input.csv");
+}
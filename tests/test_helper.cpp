@@ -0,0 +1,106 @@
+#include "test_helper.h"
+
+#include <dirent.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "constraint_adder.h"
+#include "constraint_encoder.h"
+#include "global_vars.h"
+#include "parser.h"
+
+void TestTimetabler::SetUp() { savedTimetabler = timetabler; }
+
+/*
+ * Restores the global timetabler, and removes the temporary directory with
+ * the files in it.
+ */
+void TestTimetabler::TearDown() {
+  timetabler = savedTimetabler;
+  if (tempDir.empty()) {
+    return;
+  }
+  DIR *dir = opendir(tempDir.c_str());
+  if (dir != NULL) {
+    std::vector<std::string> names;
+    for (dirent *entry = readdir(dir); entry != NULL; entry = readdir(dir)) {
+      names.push_back(entry->d_name);
+    }
+    closedir(dir);
+    for (unsigned i = 0; i < names.size(); i++) {
+      if (names[i] != "." && names[i] != "..") {
+        std::remove((tempDir + "/" + names[i]).c_str());
+      }
+    }
+  }
+  rmdir(tempDir.c_str());
+  tempDir.clear();
+}
+
+/*
+ * Makes a Timetabler, which becomes the global timetabler, and parses the
+ * fields and the input of an example into it.
+ */
+Timetabler *TestTimetabler::parseExample(std::string fieldsFile,
+                                         std::string inputFile) {
+  timetabler = new Timetabler();
+  Parser parser(timetabler);
+  parser.parseFields(fieldsFile);
+  parser.parseInput(inputFile);
+  return timetabler;
+}
+
+/*
+ * Creates the variables of a parsed example and adds the predefined
+ * constraints. If complete, the symmetry breaking constraints, the high level
+ * clauses and the existing assignments are added as well, as in a run of the
+ * timetabler.
+ */
+void TestTimetabler::encodeExample(Timetabler *input, bool complete) {
+  timetabler = input;
+  Parser parser(input);
+  parser.addVars();
+  ConstraintEncoder encoder(input);
+  ConstraintAdder constraintAdder(&encoder, input);
+  constraintAdder.addConstraints();
+  if (complete) {
+    constraintAdder.addSymmetryBreakingConstraints();
+    input->addHighLevelClauses();
+    input->addExistingAssignments();
+  }
+}
+
+/*
+ * Gets the path of a file in a temporary directory of the test, which is
+ * made on first use and removed after the test.
+ */
+std::string TestTimetabler::getTempPath(std::string name) {
+  if (tempDir.empty()) {
+    const char *base = std::getenv("TMPDIR");
+    std::string pattern =
+        std::string(base != NULL ? base : "/tmp") + "/timetabler_test_XXXXXX";
+    std::vector<char> path(pattern.begin(), pattern.end());
+    path.push_back('\0');
+    if (mkdtemp(path.data()) == NULL) {
+      ADD_FAILURE() << "Could not make a temporary directory";
+      return name;
+    }
+    tempDir = path.data();
+  }
+  return tempDir + "/" + name;
+}
+
+/*
+ * Writes a file with the given contents in the temporary directory of the
+ * test, and returns its path.
+ */
+std::string TestTimetabler::writeTempFile(std::string name,
+                                          std::string contents) {
+  std::string fileName = getTempPath(name);
+  std::ofstream file(fileName);
+  file << contents;
+  return fileName;
+}
@@ -0,0 +1,25 @@
+#ifndef TEST_HELPER_H
+#define TEST_HELPER_H
+
+#include <gtest/gtest.h>
+#include <string>
+#include "timetabler.h"
+
+/*
+ * Base of the test fixtures that build Timetabler objects. The global
+ * timetabler, which is used by the clause operators, is restored after each
+ * test, and the files made with getTempPath() are removed.
+ */
+class TestTimetabler : public ::testing::Test {
+ public:
+  Timetabler *savedTimetabler;
+  std::string tempDir;
+  void SetUp();
+  void TearDown();
+  Timetabler *parseExample(std::string, std::string);
+  void encodeExample(Timetabler *, bool);
+  std::string getTempPath(std::string);
+  std::string writeTempFile(std::string, std::string);
+};
+
+#endif
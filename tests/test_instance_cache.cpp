@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "MaxSATFormula.h"
+#include "global.h"
+#include "global_vars.h"
+#include "instance_cache.h"
+#include "test_helper.h"
+#include "timetabler.h"
+
+class TestInstanceCache : public TestTimetabler {
+ public:
+  std::vector<std::string> files = {
+      TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml",
+      TIMETABLER_EXAMPLES_DIR "/example1/input.csv", "", ""};
+  std::string getCacheDir();
+  Timetabler *saveExample1();
+  void checkClauses(const vec<Lit> &, const vec<Lit> &);
+  void checkSame(Timetabler *, Timetabler *);
+  std::string readFile(std::string);
+  void writeFile(std::string, std::string);
+};
+
+/*
+ * Gets the temporary directory of the test, in which the snapshots are kept.
+ */
+std::string TestInstanceCache::getCacheDir() {
+  getTempPath("");
+  return tempDir;
+}
+
+/*
+ * Parses and encodes example 1, and saves its snapshot in the temporary
+ * directory of the test.
+ */
+Timetabler *TestInstanceCache::saveExample1() {
+  Timetabler *saved = parseExample(files[0], files[1]);
+  InstanceCache cache(saved, getCacheDir(), files);
+  encodeExample(saved, true);
+  cache.save();
+  return saved;
+}
+
+void TestInstanceCache::checkClauses(const vec<Lit> &clause,
+                                     const vec<Lit> &expected) {
+  ASSERT_EQ(clause.size(), expected.size());
+  for (int i = 0; i < clause.size(); i++) {
+    ASSERT_EQ(clause[i], expected[i]);
+  }
+}
+
+/*
+ * Checks that the courses, the slots, the clauses and the variables in Data
+ * of two Timetablers are the same.
+ */
+void TestInstanceCache::checkSame(Timetabler *loaded, Timetabler *saved) {
+  ASSERT_EQ(loaded->data.courses.size(), saved->data.courses.size());
+  for (unsigned i = 0; i < loaded->data.courses.size(); i++) {
+    ASSERT_EQ(loaded->data.courses[i].getName(),
+              saved->data.courses[i].getName());
+    ASSERT_EQ(loaded->data.courses[i].getPrograms(),
+              saved->data.courses[i].getPrograms());
+  }
+  ASSERT_EQ(loaded->data.slots.size(), saved->data.slots.size());
+  ASSERT_EQ(loaded->data.intersectingSlots, saved->data.intersectingSlots);
+  MaxSATFormula *savedFormula = saved->getFormula();
+  MaxSATFormula *loadedFormula = loaded->getFormula();
+  ASSERT_EQ(loadedFormula->nVars(), savedFormula->nVars());
+  ASSERT_EQ(loadedFormula->nHard(), savedFormula->nHard());
+  ASSERT_EQ(loadedFormula->nSoft(), savedFormula->nSoft());
+  for (int i = 0; i < loadedFormula->nHard(); i++) {
+    checkClauses(loadedFormula->getHardClause(i).clause,
+                 savedFormula->getHardClause(i).clause);
+  }
+  for (int i = 0; i < loadedFormula->nSoft(); i++) {
+    ASSERT_EQ(loadedFormula->getSoftClause(i).weight,
+              savedFormula->getSoftClause(i).weight);
+    checkClauses(loadedFormula->getSoftClause(i).clause,
+                 savedFormula->getSoftClause(i).clause);
+  }
+  ASSERT_EQ(loaded->data.fieldValueVars, saved->data.fieldValueVars);
+  ASSERT_EQ(loaded->data.highLevelVars, saved->data.highLevelVars);
+  ASSERT_EQ(loaded->data.predefinedConstraintVars,
+            saved->data.predefinedConstraintVars);
+  ASSERT_EQ(loaded->data.trueVar, saved->data.trueVar);
+}
+
+std::string TestInstanceCache::readFile(std::string fileName) {
+  std::ifstream in(fileName, std::ios::binary);
+  std::ostringstream stream;
+  stream << in.rdbuf();
+  return stream.str();
+}
+
+void TestInstanceCache::writeFile(std::string fileName,
+                                  std::string contents) {
+  std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+  out << contents;
+}
+
+/*
+ * Saves a snapshot of example 1, loads it into another Timetabler, and checks
+ * that the fields, the clauses, the variables in Data and the optimal cost
+ * are the same.
+ */
+TEST_F(TestInstanceCache, SaveAndLoadExample1) {
+  Timetabler *saved = saveExample1();
+
+  Timetabler *loaded = new Timetabler();
+  timetabler = loaded;
+  InstanceCache loadedCache(loaded, getCacheDir(), files);
+  ASSERT_TRUE(loadedCache.load());
+  checkSame(loaded, saved);
+
+  timetabler = saved;
+  saved->solve();
+  timetabler = loaded;
+  loaded->solve();
+  ASSERT_EQ(loaded->getCost(), saved->getCost());
+
+  delete loaded;
+  delete saved;
+}
+
+/*
+ * A snapshot that was cut short, or whose contents were changed, is ignored
+ * without changing the Timetabler, which can then be parsed and encoded as
+ * usual, and saving it again replaces the damaged snapshot.
+ */
+TEST_F(TestInstanceCache, DamagedSnapshotExample1) {
+  Timetabler *saved = saveExample1();
+  std::string snapshotFile =
+      InstanceCache(saved, getCacheDir(), files).getSnapshotFile();
+  std::string contents = readFile(snapshotFile);
+  ASSERT_GT(contents.size(), 100);
+  std::string flipped = contents;
+  flipped[flipped.size() / 2] ^= 1;
+  std::vector<std::string> damaged = {
+      contents.substr(0, contents.size() / 2),
+      contents.substr(0, contents.size() - 1), contents + '\0', flipped};
+
+  for (const std::string &damagedContents : damaged) {
+    writeFile(snapshotFile, damagedContents);
+    Timetabler *loaded = new Timetabler();
+    timetabler = loaded;
+    InstanceCache loadedCache(loaded, getCacheDir(), files);
+    ASSERT_FALSE(loadedCache.load());
+    EXPECT_TRUE(loaded->data.courses.empty());
+    EXPECT_EQ(loaded->getFormula()->nVars(), 0);
+    EXPECT_EQ(loaded->getFormula()->nHard(), 0);
+    delete loaded;
+
+    loaded = parseExample(files[0], files[1]);
+    encodeExample(loaded, true);
+    checkSame(loaded, saved);
+    InstanceCache(loaded, getCacheDir(), files).save();
+    delete loaded;
+    EXPECT_EQ(readFile(snapshotFile), contents);
+  }
+  delete saved;
+}
@@ -0,0 +1,291 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "global.h"
+#include "parser.h"
+#include "test_helper.h"
+#include "timetabler.h"
+
+class TestParser : public TestTimetabler {
+ public:
+  Timetabler *parseExample1();
+  Timetabler *parseClashExample();
+  std::vector<std::tuple<unsigned, unsigned, unsigned>> findClashesPairwise(
+      Data &, FieldType);
+};
+
+Timetabler *TestParser::parseExample1() {
+  return parseExample(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml",
+                      TIMETABLER_EXAMPLES_DIR "/example1/input.csv");
+}
+
+/*
+ * Parses example 1 with other slots, and an input in which the Courses clash
+ * in the same slot, in overlapping slots and in a minor slot overlapping
+ * another slot, but not in adjacent slots, in disjoint segments, through
+ * elective programs or without a classroom or a slot.
+ */
+Timetabler *TestParser::parseClashExample() {
+  std::ifstream in(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml");
+  std::ostringstream stream;
+  stream << in.rdbuf();
+  std::string fields = stream.str();
+  size_t start = fields.find("slots:");
+  size_t end = fields.find("programs:");
+  EXPECT_NE(start, std::string::npos);
+  EXPECT_NE(end, std::string::npos);
+  fields.replace(start, end - start,
+                 "slots:\n"
+                 "  - name: A\n"
+                 "    is_minor: false\n"
+                 "    time_periods:\n"
+                 "      - day: Monday\n"
+                 "        start: 10:00\n"
+                 "        end: 11:00\n"
+                 "  - name: B\n"
+                 "    is_minor: false\n"
+                 "    time_periods:\n"
+                 "      - day: Monday\n"
+                 "        start: 10:30\n"
+                 "        end: 11:30\n"
+                 "  - name: C\n"
+                 "    is_minor: false\n"
+                 "    time_periods:\n"
+                 "      - day: Monday\n"
+                 "        start: 11:00\n"
+                 "        end: 12:00\n"
+                 "  - name: D\n"
+                 "    is_minor: false\n"
+                 "    time_periods:\n"
+                 "      - day: Tuesday\n"
+                 "        start: 10:00\n"
+                 "        end: 11:00\n"
+                 "  - name: M\n"
+                 "    is_minor: true\n"
+                 "    time_periods:\n"
+                 "      - day: Tuesday\n"
+                 "        start: 10:30\n"
+                 "        end: 11:30\n"
+                 "\n");
+  std::string fieldsFile = writeTempFile("fields.yaml", fields);
+  std::string inputFile = writeTempFile(
+      "input.csv",
+      "name,class_size,instructor,segment,is_minor,B.Tech.1,B.Tech.2,"
+      "B.Tech.3,B.Tech.4,M.Tech.,classroom,slot\n"
+      "C1,30,A,16,No,Core,No,No,No,No,CL1,A\n"
+      "C2,30,A,16,No,No,Core,No,No,No,CL2,A\n"
+      "C3,30,B,16,No,Core,No,No,No,No,CL1,B\n"
+      "C4,30,B,14,No,No,No,No,No,No,CL2,C\n"
+      "C5,30,A,56,No,No,Core,No,No,No,CL2,A\n"
+      "C6,30,B,16,Yes,Elective,No,No,No,No,CL3,M\n"
+      "C7,30,B,16,No,Core,No,No,No,No,CL3,D\n"
+      "C8,30,A,16,No,No,No,No,No,No,,D\n"
+      "C9,30,A,16,No,Core,No,No,No,No,CL1,\n");
+  return parseExample(fieldsFile, inputFile);
+}
+
+/*
+ * Finds the clashes by comparing every pair of Courses, as verify did before
+ * the Courses were bucketed by time unit.
+ */
+std::vector<std::tuple<unsigned, unsigned, unsigned>>
+TestParser::findClashesPairwise(Data &data, FieldType fieldType) {
+  std::vector<std::tuple<unsigned, unsigned, unsigned>> clashes;
+  for (unsigned j = 0; j < data.courses.size(); j++) {
+    for (unsigned i = 0; i < j; i++) {
+      Course &course1 = data.courses[i];
+      Course &course2 = data.courses[j];
+      if (course1.getSlot() == -1 || course2.getSlot() == -1 ||
+          !data.isIntersecting(FieldType::segment, course1.getSegment(),
+                               course2.getSegment()) ||
+          !data.isIntersecting(FieldType::slot, course1.getSlot(),
+                               course2.getSlot())) {
+        continue;
+      }
+      if (fieldType == FieldType::instructor &&
+          course1.getInstructor() == course2.getInstructor()) {
+        clashes.push_back(std::make_tuple(course1.getInstructor(), i, j));
+      } else if (fieldType == FieldType::classroom &&
+                 course1.getClassroom() != -1 &&
+                 course1.getClassroom() == course2.getClassroom()) {
+        clashes.push_back(std::make_tuple(course1.getClassroom(), i, j));
+      } else if (fieldType == FieldType::program) {
+        for (int program1 : course1.getPrograms()) {
+          for (int program2 : course2.getPrograms()) {
+            if (program1 == program2 &&
+                data.programs[program1].isCoreProgram()) {
+              clashes.push_back(std::make_tuple(program1, i, j));
+            }
+          }
+        }
+      }
+    }
+  }
+  return clashes;
+}
+
+/*
+ * The clashes found by bucketing the Courses by time unit are the clashes
+ * found by comparing every pair of Courses, and are the expected ones.
+ */
+TEST_F(TestParser, ClashesMatchPairwiseScan) {
+  Timetabler *parsed = parseClashExample();
+  Data &data = parsed->data;
+  Parser parser(parsed);
+  std::vector<std::tuple<unsigned, unsigned, unsigned>> expected[] = {
+      {std::make_tuple(0, 0, 1), std::make_tuple(0, 0, 4),
+       std::make_tuple(0, 1, 4), std::make_tuple(1, 2, 3),
+       std::make_tuple(1, 5, 6)},
+      {std::make_tuple(0, 0, 2), std::make_tuple(1, 1, 4),
+       std::make_tuple(2, 5, 6)},
+      {std::make_tuple(0, 0, 2), std::make_tuple(2, 1, 4)}};
+  FieldType fieldTypes[] = {FieldType::instructor, FieldType::classroom,
+                            FieldType::program};
+  for (unsigned k = 0; k < 3; k++) {
+    std::vector<std::tuple<unsigned, unsigned, unsigned>> clashes =
+        parser.findClashes(fieldTypes[k]);
+    std::vector<std::tuple<unsigned, unsigned, unsigned>> pairwiseClashes =
+        findClashesPairwise(data, fieldTypes[k]);
+    std::sort(clashes.begin(), clashes.end());
+    std::sort(pairwiseClashes.begin(), pairwiseClashes.end());
+    EXPECT_EQ(clashes, pairwiseClashes);
+    EXPECT_EQ(clashes, expected[k]);
+  }
+  delete parsed;
+}
+
+/*
+ * Clashes make the input invalid only if their constraint is hard.
+ */
+TEST_F(TestParser, VerifyClashesOfHardConstraints) {
+  Timetabler *parsed = parseClashExample();
+  Data &data = parsed->data;
+  Parser parser(parsed);
+  for (PredefinedClauses clause :
+       {PredefinedClauses::instructorSingleCourseAtATime,
+        PredefinedClauses::classroomSingleCourseAtATime,
+        PredefinedClauses::programSingleCoreCourseAtATime,
+        PredefinedClauses::minorInMinorTime}) {
+    data.predefinedClausesWeights[clause] = 1;
+  }
+  EXPECT_TRUE(parser.verify());
+  for (PredefinedClauses clause :
+       {PredefinedClauses::instructorSingleCourseAtATime,
+        PredefinedClauses::classroomSingleCourseAtATime,
+        PredefinedClauses::programSingleCoreCourseAtATime}) {
+    data.predefinedClausesWeights[clause] = -1;
+    EXPECT_FALSE(parser.verify());
+    data.predefinedClausesWeights[clause] = 1;
+  }
+  delete parsed;
+}
+
+/*
+ * Only the known values of the columns that are present are hinted, and only
+ * for the courses of the input.
+ */
+TEST_F(TestParser, HintOfKnownValues) {
+  Timetabler *parsed = parseExample1();
+  Data &data = parsed->data;
+  std::string hintFile = writeTempFile(
+      "hint.csv",
+      "name,classroom,slot,B.Tech.1\n"
+      "C1,CL2,A,Elective\n"
+      "C2,,Nowhere,No\n"
+      "Unknown,CL1,A,Core\n");
+  Parser parser(parsed);
+  parser.parseHint(hintFile);
+
+  ASSERT_EQ(data.hintValues.size(), data.courses.size());
+  int c1 = data.getCourseIndex("C1");
+  int c2 = data.getCourseIndex("C2");
+  ASSERT_NE(c1, -1);
+  ASSERT_NE(c2, -1);
+  int classroom = data.getFieldValueIndex(FieldType::classroom, "CL2");
+  int slot = data.getFieldValueIndex(FieldType::slot, "A");
+  ASSERT_NE(classroom, -1);
+  ASSERT_NE(slot, -1);
+
+  const std::vector<std::vector<lbool>> &hint1 = data.hintValues[c1];
+  ASSERT_EQ(hint1[FieldType::classroom].size(), data.classrooms.size());
+  for (unsigned k = 0; k < data.classrooms.size(); k++) {
+    EXPECT_EQ(hint1[FieldType::classroom][k], lbool((int)k == classroom));
+  }
+  ASSERT_EQ(hint1[FieldType::slot].size(), data.slots.size());
+  for (unsigned k = 0; k < data.slots.size(); k++) {
+    EXPECT_EQ(hint1[FieldType::slot][k], lbool((int)k == slot));
+  }
+  for (lbool value : hint1[FieldType::instructor]) {
+    EXPECT_EQ(value, l_Undef);
+  }
+  ASSERT_EQ(hint1[FieldType::program].size(), data.programs.size());
+  EXPECT_EQ(hint1[FieldType::program][0], l_False);
+  EXPECT_EQ(hint1[FieldType::program][1], l_True);
+  for (unsigned k = 2; k < data.programs.size(); k++) {
+    EXPECT_EQ(hint1[FieldType::program][k], l_Undef);
+  }
+
+  const std::vector<std::vector<lbool>> &hint2 = data.hintValues[c2];
+  for (lbool value : hint2[FieldType::classroom]) {
+    EXPECT_EQ(value, l_Undef);
+  }
+  for (lbool value : hint2[FieldType::slot]) {
+    EXPECT_EQ(value, l_Undef);
+  }
+  EXPECT_EQ(hint2[FieldType::program][0], l_False);
+  EXPECT_EQ(hint2[FieldType::program][1], l_False);
+
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    if ((int)i != c1 && (int)i != c2) {
+      EXPECT_TRUE(data.hintValues[i][FieldType::slot].empty());
+    }
+  }
+  delete parsed;
+}
+
+/*
+ * An earlier output is a valid hint, which hints every field of every course.
+ */
+TEST_F(TestParser, HintOfOutput) {
+  Timetabler *solved = parseExample1();
+  encodeExample(solved, true);
+  EXPECT_NE(solved->solve(), SolverStatus::Unsolved);
+  std::string outputFile = getTempPath("output.csv");
+  solved->writeOutput(outputFile);
+
+  Timetabler *parsed = parseExample1();
+  Parser parser(parsed);
+  parser.parseHint(outputFile);
+  Data &data = parsed->data;
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    for (FieldType fieldType : {FieldType::classroom, FieldType::slot,
+                                FieldType::instructor, FieldType::segment}) {
+      const std::vector<lbool> &hint = data.hintValues[i][fieldType];
+      const std::vector<Var> &vars =
+          solved->data.fieldValueVars[i][fieldType];
+      ASSERT_EQ(hint.size(), vars.size());
+      for (unsigned k = 0; k < vars.size(); k++) {
+        EXPECT_EQ(hint[k], lbool(solved->isVarTrue(vars[k])));
+      }
+    }
+  }
+  delete solved;
+  delete parsed;
+}
+
+/*
+ * A hint file without a name column is an error, which is logged to the
+ * standard output and exits.
+ */
+TEST_F(TestParser, HintWithoutNameColumn) {
+  Timetabler *parsed = parseExample1();
+  std::string hintFile =
+      writeTempFile("hint.csv", "course,classroom,slot\nC1,CL2,A\n");
+  Parser parser(parsed);
+  EXPECT_EXIT(parser.parseHint(hintFile), ::testing::ExitedWithCode(1), "");
+  delete parsed;
+}
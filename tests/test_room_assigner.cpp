@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "global.h"
+#include "global_vars.h"
+#include "test_helper.h"
+#include "timetabler.h"
+
+class TestRoomAssigner : public TestTimetabler {
+ public:
+  uint64_t solveExample(std::string, std::string, bool);
+  int getValue(unsigned, FieldType);
+};
+
+/*
+ * Gets the index of the field value of a course in the model, -1 if it has
+ * none.
+ */
+int TestRoomAssigner::getValue(unsigned course, FieldType fieldType) {
+  const std::vector<Var> &vars =
+      timetabler->data.fieldValueVars[course][fieldType];
+  for (unsigned k = 0; k < vars.size(); k++) {
+    if (timetabler->isVarTrue(vars[k])) {
+      return k;
+    }
+  }
+  return -1;
+}
+
+/*
+ * Solves an example in one or two stages, checks that no two courses held at
+ * an intersecting time share a classroom, and returns the optimal cost.
+ */
+uint64_t TestRoomAssigner::solveExample(std::string fieldsFile,
+                                        std::string inputFile,
+                                        bool twoStage) {
+  parseExample(fieldsFile, inputFile);
+  timetabler->data.twoStage = twoStage;
+  encodeExample(timetabler, true);
+  EXPECT_NE(timetabler->solve(), SolverStatus::Unsolved);
+  EXPECT_TRUE(timetabler->isOptimal());
+  Data &data = timetabler->data;
+  for (unsigned i = 0; i < data.courses.size(); i++) {
+    for (unsigned j = i + 1; j < data.courses.size(); j++) {
+      bool intersecting =
+          data.isIntersecting(FieldType::slot, getValue(i, FieldType::slot),
+                              getValue(j, FieldType::slot)) &&
+          data.isIntersecting(FieldType::segment,
+                              getValue(i, FieldType::segment),
+                              getValue(j, FieldType::segment));
+      EXPECT_FALSE(intersecting && getValue(i, FieldType::classroom) ==
+                                       getValue(j, FieldType::classroom));
+    }
+  }
+  uint64_t cost = timetabler->getCost();
+  delete timetabler;
+  return cost;
+}
+
+TEST_F(TestRoomAssigner, TwoStageKeepsOptimalCostExample1) {
+  uint64_t cost =
+      solveExample(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml",
+                   TIMETABLER_EXAMPLES_DIR "/example1/input.csv", false);
+  ASSERT_EQ(solveExample(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml",
+                         TIMETABLER_EXAMPLES_DIR "/example1/input.csv", true),
+            cost);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "search_progress.h"
+#include "test_helper.h"
+#include "timetabler.h"
+
+class TestSearchProgress : public TestTimetabler {
+ public:
+  std::vector<SearchProgress> reports;
+  Timetabler *solveExample(std::string, std::string, uint64_t);
+  void checkReports(Timetabler *);
+};
+
+/*
+ * Solves an example with the given conflict limit, keeping every progress
+ * report of the search.
+ */
+Timetabler *TestSearchProgress::solveExample(std::string fieldsFile,
+                                             std::string inputFile,
+                                             uint64_t conflictLimit) {
+  Timetabler *solved = parseExample(fieldsFile, inputFile);
+  encodeExample(solved, true);
+  solved->setSearchLimits(0, conflictLimit);
+  reports.clear();
+  solved->setProgressCallback(
+      [this](const SearchProgress &progress) { reports.push_back(progress); });
+  solved->solve();
+  return solved;
+}
+
+/*
+ * Checks that the reports start with a started event and end with a single
+ * final event, that the bounds only improve, and that the final report agrees
+ * with the result of the search.
+ */
+void TestSearchProgress::checkReports(Timetabler *solved) {
+  ASSERT_GE(reports.size(), 2);
+  EXPECT_EQ(reports.front().type, ProgressEventType::Started);
+  for (unsigned i = 1; i < reports.size(); i++) {
+    const SearchProgress &previous = reports[i - 1];
+    const SearchProgress &current = reports[i];
+    EXPECT_NE(previous.type, ProgressEventType::Completed);
+    EXPECT_NE(previous.type, ProgressEventType::Stopped);
+    EXPECT_GE(current.elapsedSeconds, previous.elapsedSeconds);
+    EXPECT_GE(current.modelCount, previous.modelCount);
+    EXPECT_GE(current.coreCount, previous.coreCount);
+    EXPECT_GE(current.lowerBound, previous.lowerBound);
+    if (previous.modelCount > 0) {
+      EXPECT_LE(current.upperBound, previous.upperBound);
+    }
+  }
+  for (const SearchProgress &progress : reports) {
+    if (progress.modelCount > 0) {
+      EXPECT_LE(progress.lowerBound, progress.upperBound);
+    }
+  }
+  const SearchProgress &last = reports.back();
+  if (solved->isOptimal()) {
+    EXPECT_EQ(last.type, ProgressEventType::Completed);
+    EXPECT_EQ(last.upperBound, solved->getCost());
+    EXPECT_EQ(last.lowerBound, solved->getCost());
+  } else {
+    EXPECT_EQ(last.type, ProgressEventType::Stopped);
+  }
+}
+
+TEST_F(TestSearchProgress, CompletedSearchExample1) {
+  Timetabler *solved =
+      solveExample(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml",
+                   TIMETABLER_EXAMPLES_DIR "/example1/input.csv", 0);
+  ASSERT_TRUE(solved->isOptimal());
+  checkReports(solved);
+  EXPECT_GT(reports.back().modelCount, 0);
+  delete solved;
+}
+
+TEST_F(TestSearchProgress, StoppedSearchExample1) {
+  Timetabler *solved =
+      solveExample(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml",
+                   TIMETABLER_EXAMPLES_DIR "/example1/input.csv", 1);
+  ASSERT_FALSE(solved->isOptimal());
+  checkReports(solved);
+  delete solved;
+}
+
+TEST_F(TestSearchProgress, JsonHasEveryField) {
+  SearchProgress progress;
+  progress.type = ProgressEventType::UpperBound;
+  progress.configuration = 2;
+  progress.elapsedSeconds = 0.5;
+  progress.upperBound = 7;
+  progress.lowerBound = 3;
+  progress.coreSize = 4;
+  progress.coreCount = 5;
+  progress.modelCount = 1;
+  progress.variableCount = 100;
+  progress.clauseCount = 200;
+  EXPECT_EQ(progress.toJson(),
+            "{\"event\":\"upper_bound\",\"configuration\":2,\"elapsed\":0.5,"
+            "\"upper_bound\":7,\"lower_bound\":3,\"core_size\":4,\"cores\":5,"
+            "\"models\":1,\"variables\":100,\"clauses\":200}");
+}
+
+/*
+ * The upper bound is null until a model has been found.
+ */
+TEST_F(TestSearchProgress, JsonUpperBoundNullWithoutModel) {
+  SearchProgress progress;
+  progress.upperBound = 7;
+  EXPECT_EQ(progress.toJson(),
+            "{\"event\":\"started\",\"configuration\":0,\"elapsed\":0,"
+            "\"upper_bound\":null,\"lower_bound\":0,\"core_size\":0,"
+            "\"cores\":0,\"models\":0,\"variables\":0,\"clauses\":0}");
+}
@@ -0,0 +1,607 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "clauses.h"
+#include "component_solver.h"
+#include "global.h"
+#include "parser.h"
+#include "search_progress.h"
+#include "test_helper.h"
+#include "timetabler.h"
+
+class TestTimetablerSolve : public TestTimetabler {
+ public:
+  Timetabler *encode(std::string, std::string);
+  void checkOutput(Timetabler *, bool);
+  Timetabler *startSession(std::string, std::string);
+  uint64_t solveFresh(Timetabler *);
+  int getValue(Timetabler *, unsigned, FieldType);
+  Timetabler *encodeIslands();
+  void checkHardClauses(Timetabler *);
+  uint64_t getModelCost(Timetabler *);
+};
+
+/*
+ * Parses an example and adds all of its constraints, as in a run of the
+ * timetabler.
+ */
+Timetabler *TestTimetablerSolve::encode(std::string fieldsFile,
+                                        std::string inputFile) {
+  Timetabler *encoded = parseExample(fieldsFile, inputFile);
+  encodeExample(encoded, true);
+  return encoded;
+}
+
+/*
+ * Writes the output of a solved Timetabler, and checks that it has a row for
+ * every course, with a status column only if the timetable is not optimal.
+ */
+void TestTimetablerSolve::checkOutput(Timetabler *solved, bool optimal) {
+  std::string fileName = getTempPath("output.csv");
+  solved->writeOutput(fileName);
+  std::ifstream file(fileName);
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(file, line);) {
+    lines.push_back(line);
+  }
+  ASSERT_EQ(lines.size(), solved->data.courses.size() + 1);
+  std::string header = lines[0];
+  bool hasStatus = header.size() >= 7 &&
+                   header.compare(header.size() - 7, 7, ",status") == 0;
+  EXPECT_EQ(hasStatus, !optimal);
+  for (unsigned i = 1; i < lines.size(); i++) {
+    std::string status = lines[i].substr(lines[i].rfind(',') + 1);
+    if (optimal) {
+      EXPECT_NE(status, "non-optimal");
+    } else {
+      EXPECT_TRUE(status == "non-optimal" || status == "greedy");
+    }
+  }
+}
+
+/*
+ * Encodes an example with the default configuration, and starts an
+ * incremental session on it.
+ */
+Timetabler *TestTimetablerSolve::startSession(std::string fieldsFile,
+                                              std::string inputFile) {
+  Timetabler *session = parseExample(fieldsFile, inputFile);
+  encodeExample(session, true);
+  session->startSession();
+  return session;
+}
+
+/*
+ * Solves an edited instance from scratch, and returns its optimal cost.
+ */
+uint64_t TestTimetablerSolve::solveFresh(Timetabler *fresh) {
+  EXPECT_NE(fresh->solve(), SolverStatus::Unsolved);
+  EXPECT_TRUE(fresh->isOptimal());
+  uint64_t cost = fresh->getCost();
+  delete fresh;
+  return cost;
+}
+
+/*
+ * Gets the index of the field value of a course in the model, -1 if it has
+ * none.
+ */
+int TestTimetablerSolve::getValue(Timetabler *solved, unsigned course,
+                                  FieldType fieldType) {
+  const std::vector<Var> &vars = solved->data.fieldValueVars[course][fieldType];
+  for (unsigned k = 0; k < vars.size(); k++) {
+    if (solved->isVarTrue(vars[k])) {
+      return k;
+    }
+  }
+  return -1;
+}
+
+/*
+ * Encodes the fields of example 1 with two pairs of courses that share
+ * nothing but their slots. Each pair has its own instructor, program and
+ * classroom, and the classrooms are hard existing assignments, so the courses
+ * of the two pairs are in separate components.
+ */
+Timetabler *TestTimetablerSolve::encodeIslands() {
+  std::string input = writeTempFile(
+      "input.csv",
+      "name,class_size,instructor,segment,is_minor,B.Tech.1,B.Tech.2,"
+      "B.Tech.3,B.Tech.4,M.Tech.,classroom,slot\n"
+      "C1,30,A,16,No,No,No,No,No,Core,CL1,\n"
+      "C2,50,A,14,No,No,No,No,No,Core,CL1,\n"
+      "C3,50,B,14,No,Core,No,No,No,No,CL2,\n"
+      "C4,50,B,16,No,Core,No,No,No,No,CL2,\n");
+  Timetabler *encoded =
+      parseExample(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml", input);
+  encoded->data.existingAssignmentWeights[FieldType::classroom] = -1;
+  encoded->data.symmetryBreaking = false;
+  encodeExample(encoded, true);
+  return encoded;
+}
+
+/*
+ * Checks that the model of a solved Timetabler satisfies every hard clause of
+ * its formula.
+ */
+void TestTimetablerSolve::checkHardClauses(Timetabler *solved) {
+  MaxSATFormula *formula = solved->getFormula();
+  for (int i = 0; i < formula->nHard(); i++) {
+    const vec<Lit> &clause = formula->getHardClause(i).clause;
+    bool satisfied = false;
+    for (int j = 0; j < clause.size() && !satisfied; j++) {
+      satisfied = solved->isVarTrue(var(clause[j])) != sign(clause[j]);
+    }
+    ASSERT_TRUE(satisfied);
+  }
+}
+
+/*
+ * Computes the total weight of the soft clauses not satisfied by the model of
+ * a solved Timetabler.
+ */
+uint64_t TestTimetablerSolve::getModelCost(Timetabler *solved) {
+  MaxSATFormula *formula = solved->getFormula();
+  uint64_t modelCost = 0;
+  for (int i = 0; i < formula->nSoft(); i++) {
+    const vec<Lit> &clause = formula->getSoftClause(i).clause;
+    bool satisfied = false;
+    for (int j = 0; j < clause.size() && !satisfied; j++) {
+      satisfied = solved->isVarTrue(var(clause[j])) != sign(clause[j]);
+    }
+    modelCost += satisfied ? 0 : formula->getSoftClause(i).weight;
+  }
+  return modelCost;
+}
+
+/*
+ * The solvers of a portfolio own their copies of the formula, which are
+ * deleted with them.
+ */
+TEST_F(TestTimetablerSolve, PortfolioKeepsOptimalCostExample1) {
+  std::string fields = TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml";
+  std::string input = TIMETABLER_EXAMPLES_DIR "/example1/input.csv";
+  Timetabler *single = encode(fields, input);
+  EXPECT_NE(single->solve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(single->isOptimal());
+
+  Timetabler *portfolio = encode(fields, input);
+  portfolio->setThreadCount(2);
+  EXPECT_NE(portfolio->solve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(portfolio->isOptimal());
+  EXPECT_EQ(portfolio->getCost(), single->getCost());
+  EXPECT_EQ(portfolio->getLowerBound(), portfolio->getCost());
+  delete single;
+  delete portfolio;
+}
+
+TEST_F(TestTimetablerSolve, NoLimitWritesNoStatusExample1) {
+  Timetabler *solved =
+      encode(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml",
+             TIMETABLER_EXAMPLES_DIR "/example1/input.csv");
+  EXPECT_NE(solved->solve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(solved->isOptimal());
+  checkOutput(solved, true);
+  delete solved;
+}
+
+TEST_F(TestTimetablerSolve, ConflictLimitReportsNonOptimalExample1) {
+  Timetabler *solved =
+      encode(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml",
+             TIMETABLER_EXAMPLES_DIR "/example1/input.csv");
+  solved->setSearchLimits(0, 1);
+  solved->solve();
+  ASSERT_FALSE(solved->isOptimal());
+  EXPECT_LE(solved->getLowerBound(), solved->getCost());
+  checkOutput(solved, false);
+  delete solved;
+}
+
+/*
+ * The search is held at its start for longer than the time limit, so that it
+ * is always stopped by the limit.
+ */
+TEST_F(TestTimetablerSolve, TimeLimitReportsNonOptimalExample1) {
+  Timetabler *solved =
+      encode(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml",
+             TIMETABLER_EXAMPLES_DIR "/example1/input.csv");
+  solved->setSearchLimits(0.001, 0);
+  solved->setProgressCallback([](const SearchProgress &progress) {
+    if (progress.type == ProgressEventType::Started) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+  });
+  solved->solve();
+  ASSERT_FALSE(solved->isOptimal());
+  checkOutput(solved, false);
+  delete solved;
+}
+
+/*
+ * The first stage and the room stage are each held at their start for two
+ * thirds of the time limit. The first stage ends within the limit, and the
+ * room stage only has the rest of the time, so it is stopped by the limit.
+ */
+TEST_F(TestTimetablerSolve, TimeLimitSharedByStagesExample1) {
+  Timetabler *solved = parseExample(
+      TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml",
+      TIMETABLER_EXAMPLES_DIR "/example1/input.csv");
+  solved->data.twoStage = true;
+  encodeExample(solved, true);
+  solved->setSearchLimits(0.3, 0);
+  unsigned startCount = 0;
+  solved->setProgressCallback([&startCount](const SearchProgress &progress) {
+    if (progress.type == ProgressEventType::Started && startCount++ < 2) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+  });
+  solved->solve();
+  ASSERT_GE(startCount, 2);
+  EXPECT_FALSE(solved->isOptimal());
+  delete solved;
+}
+
+TEST_F(TestTimetablerSolve, ResolveAfterWeightChangeExample1) {
+  std::string fields = TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml";
+  std::string input = TIMETABLER_EXAMPLES_DIR "/example1/input.csv";
+  const std::vector<int> weights = {5, 0, 1};
+  std::vector<uint64_t> freshCosts;
+  for (int weight : weights) {
+    Timetabler *fresh = parseExample(fields, input);
+    fresh->data.predefinedClausesWeights[PredefinedClauses::coreInMorningTime] =
+        weight;
+    encodeExample(fresh, true);
+    freshCosts.push_back(solveFresh(fresh));
+  }
+  ASSERT_NE(freshCosts[0], freshCosts[1]);
+
+  Timetabler *session = startSession(fields, input);
+  EXPECT_NE(session->resolve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(session->isOptimal());
+  EXPECT_EQ(session->getCost(), freshCosts[2]);
+  for (unsigned i = 0; i < weights.size(); i++) {
+    for (unsigned j = 0; j < session->data.courses.size(); j++) {
+      session->setConstraintWeight(PredefinedClauses::coreInMorningTime, j,
+                                   weights[i]);
+    }
+    EXPECT_NE(session->resolve(), SolverStatus::Unsolved);
+    ASSERT_TRUE(session->isOptimal());
+    EXPECT_EQ(session->getCost(), freshCosts[i]);
+  }
+  delete session;
+}
+
+/*
+ * A course is pinned to a slot other than its slot in the optimal timetable,
+ * which gives the same cost as the instance with that slot made hard, until
+ * the assumption is cleared.
+ */
+TEST_F(TestTimetablerSolve, ResolveAfterPinnedAssumptionExample1) {
+  std::string fields = TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml";
+  std::string input = TIMETABLER_EXAMPLES_DIR "/example1/input.csv";
+  Timetabler *session = startSession(fields, input);
+  EXPECT_NE(session->resolve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(session->isOptimal());
+  uint64_t optimalCost = session->getCost();
+  int slot = getValue(session, 0, FieldType::slot);
+  ASSERT_NE(slot, -1);
+
+  unsigned checked = 0;
+  for (unsigned k = 0; k < session->data.slots.size(); k++) {
+    Var v = session->data.fieldValueVars[0][FieldType::slot][k];
+    if ((int)k == slot || v == session->data.falseVar) {
+      continue;
+    }
+    Timetabler *fresh = parseExample(fields, input);
+    fresh->data.symmetryBreaking = false;
+    encodeExample(fresh, true);
+    fresh->addToFormula(
+        mkLit(fresh->data.fieldValueVars[0][FieldType::slot][k], false), -1);
+    uint64_t freshCost = solveFresh(fresh);
+
+    session->setFieldValueAssumption(0, FieldType::slot, k, l_True);
+    EXPECT_NE(session->resolve(), SolverStatus::Unsolved);
+    ASSERT_TRUE(session->isOptimal());
+    EXPECT_EQ(getValue(session, 0, FieldType::slot), (int)k);
+    EXPECT_EQ(session->getCost(), freshCost);
+    EXPECT_GE(session->getCost(), optimalCost);
+    session->setFieldValueAssumption(0, FieldType::slot, k, l_Undef);
+    checked++;
+  }
+  ASSERT_GT(checked, 0);
+  session->clearAssumptions();
+  EXPECT_NE(session->resolve(), SolverStatus::Unsolved);
+  EXPECT_EQ(session->getCost(), optimalCost);
+  delete session;
+}
+
+/*
+ * Assumptions on field values fixed by the presolve are kept per course, even
+ * though the fixed values share their variables. An assumption agreeing with
+ * a fixed value changes nothing, and one contradicting it leaves no model
+ * until it is removed.
+ */
+TEST_F(TestTimetablerSolve, ResolveAfterFixedValueAssumptionsExample1) {
+  std::string fields = TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml";
+  std::string input = TIMETABLER_EXAMPLES_DIR "/example1/input.csv";
+  Timetabler *session = startSession(fields, input);
+  EXPECT_NE(session->resolve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(session->isOptimal());
+  uint64_t optimalCost = session->getCost();
+  int instructor0 = session->data.courses[0].getInstructor();
+  int instructor1 = session->data.courses[1].getInstructor();
+  ASSERT_EQ(
+      session->data.fieldValueVars[0][FieldType::instructor][instructor0],
+      session->data.trueVar);
+  ASSERT_EQ(
+      session->data.fieldValueVars[1][FieldType::instructor][instructor1],
+      session->data.trueVar);
+
+  session->setFieldValueAssumption(1, FieldType::instructor, instructor1,
+                                   l_True);
+  EXPECT_NE(session->resolve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(session->isOptimal());
+  EXPECT_EQ(session->getCost(), optimalCost);
+
+  session->setFieldValueAssumption(0, FieldType::instructor, instructor0,
+                                   l_False);
+  EXPECT_EQ(session->resolve(), SolverStatus::Unsolved);
+  EXPECT_TRUE(session->isOptimal());
+  session->setFieldValueAssumption(1, FieldType::instructor, instructor1,
+                                   l_Undef);
+  EXPECT_EQ(session->resolve(), SolverStatus::Unsolved);
+
+  session->setFieldValueAssumption(0, FieldType::instructor, instructor0,
+                                   l_Undef);
+  EXPECT_NE(session->resolve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(session->isOptimal());
+  EXPECT_EQ(session->getCost(), optimalCost);
+  delete session;
+}
+
+/*
+ * Clauses added to the session hold in every following search, as if they
+ * were hard clauses of the instance.
+ */
+TEST_F(TestTimetablerSolve, ResolveAfterSessionClausesExample1) {
+  std::string fields = TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml";
+  std::string input = TIMETABLER_EXAMPLES_DIR "/example1/input.csv";
+  Timetabler *session = startSession(fields, input);
+  EXPECT_NE(session->resolve(), SolverStatus::Unsolved);
+  int slot = getValue(session, 0, FieldType::slot);
+  ASSERT_NE(slot, -1);
+  Var v = session->data.fieldValueVars[0][FieldType::slot][slot];
+  ASSERT_NE(v, session->data.trueVar);
+
+  Timetabler *fresh = parseExample(fields, input);
+  fresh->data.symmetryBreaking = false;
+  encodeExample(fresh, true);
+  fresh->addToFormula(
+      mkLit(fresh->data.fieldValueVars[0][FieldType::slot][slot], true), -1);
+  uint64_t freshCost = solveFresh(fresh);
+
+  session->addSessionClauses(Clauses(mkLit(v, true)));
+  EXPECT_NE(session->resolve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(session->isOptimal());
+  EXPECT_NE(getValue(session, 0, FieldType::slot), slot);
+  EXPECT_EQ(session->getCost(), freshCost);
+  delete session;
+}
+
+/*
+ * With symmetry breaking on, as it is by default, pinning a course to an
+ * interchangeable classroom, or ruling one out by a session clause, gives the
+ * same cost as the instance with that choice made hard and without symmetry
+ * breaking. Clearing the assumption restores the optimal cost.
+ */
+TEST_F(TestTimetablerSolve, ResolveWithSymmetryBreakingExample1) {
+  std::string fields = TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml";
+  std::string input = TIMETABLER_EXAMPLES_DIR "/example1/input.csv";
+  Timetabler *session = startSession(fields, input);
+  ASSERT_TRUE(session->data.symmetryBreaking);
+  ASSERT_NE(session->data.symmetryBreakingVar, var_Undef);
+  EXPECT_NE(session->resolve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(session->isOptimal());
+  uint64_t optimalCost = session->getCost();
+  Var v = session->data.fieldValueVars[0][FieldType::classroom][1];
+  ASSERT_NE(v, session->data.trueVar);
+  ASSERT_NE(v, session->data.falseVar);
+
+  for (bool pinned : {true, false}) {
+    Timetabler *fresh = parseExample(fields, input);
+    fresh->data.symmetryBreaking = false;
+    encodeExample(fresh, true);
+    fresh->addToFormula(
+        mkLit(fresh->data.fieldValueVars[0][FieldType::classroom][1], !pinned),
+        -1);
+    uint64_t freshCost = solveFresh(fresh);
+
+    session->setFieldValueAssumption(0, FieldType::classroom, 1,
+                                     pinned ? l_True : l_False);
+    EXPECT_NE(session->resolve(), SolverStatus::Unsolved);
+    ASSERT_TRUE(session->isOptimal());
+    EXPECT_EQ(session->isVarTrue(v), pinned);
+    EXPECT_EQ(session->getCost(), freshCost);
+  }
+  session->clearAssumptions();
+  EXPECT_NE(session->resolve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(session->isOptimal());
+  EXPECT_EQ(session->getCost(), optimalCost);
+
+  Timetabler *fresh = parseExample(fields, input);
+  fresh->data.symmetryBreaking = false;
+  encodeExample(fresh, true);
+  fresh->addToFormula(
+      mkLit(fresh->data.fieldValueVars[0][FieldType::classroom][0], true), -1);
+  uint64_t freshCost = solveFresh(fresh);
+  session->addSessionClauses(Clauses(
+      mkLit(session->data.fieldValueVars[0][FieldType::classroom][0], true)));
+  EXPECT_NE(session->resolve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(session->isOptimal());
+  EXPECT_EQ(session->getCost(), freshCost);
+  delete session;
+}
+
+/*
+ * The components share no variable, and every clause that is not satisfied by
+ * the fixed variables lies within a single component.
+ */
+TEST_F(TestTimetablerSolve, SplitFormulaGivesIndependentComponents) {
+  Timetabler *encoded = encodeIslands();
+  MaxSATFormula *formula = encoded->getFormula();
+  std::vector<std::vector<Var>> componentVars;
+  std::vector<lbool> fixedValues;
+  uint64_t fixedCost;
+  std::vector<MaxSATFormula *> components =
+      ComponentSolver(formula).splitFormula(componentVars, fixedValues,
+                                            fixedCost);
+  ASSERT_GE(components.size(), 2);
+  ASSERT_EQ(componentVars.size(), components.size());
+
+  std::vector<int> componentOf(formula->nVars(), -1);
+  for (unsigned i = 0; i < componentVars.size(); i++) {
+    EXPECT_EQ(componentVars[i].size(), components[i]->nVars());
+    for (Var v : componentVars[i]) {
+      EXPECT_EQ(fixedValues[v], l_Undef);
+      EXPECT_EQ(componentOf[v], -1);
+      componentOf[v] = i;
+    }
+  }
+  // the slots of the courses of a pair are linked, and those of the two pairs
+  // are not
+  const std::vector<std::vector<std::vector<Var>>> &vars =
+      encoded->data.fieldValueVars;
+  int pair1 = componentOf[vars[0][FieldType::slot][0]];
+  int pair2 = componentOf[vars[2][FieldType::slot][0]];
+  ASSERT_NE(pair1, -1);
+  ASSERT_NE(pair2, -1);
+  EXPECT_NE(pair1, pair2);
+  EXPECT_EQ(componentOf[vars[1][FieldType::slot][0]], pair1);
+  EXPECT_EQ(componentOf[vars[3][FieldType::slot][0]], pair2);
+
+  int hardCount = 0;
+  int softCount = 0;
+  for (int i = 0; i < formula->nHard() + formula->nSoft(); i++) {
+    bool hard = i < formula->nHard();
+    const vec<Lit> &clause =
+        hard ? formula->getHardClause(i).clause
+             : formula->getSoftClause(i - formula->nHard()).clause;
+    bool satisfied = false;
+    int component = -1;
+    for (int j = 0; j < clause.size(); j++) {
+      Var v = var(clause[j]);
+      if (fixedValues[v] == l_Undef) {
+        EXPECT_TRUE(component == -1 || componentOf[v] == component);
+        component = componentOf[v];
+      } else if (fixedValues[v] == (sign(clause[j]) ? l_False : l_True)) {
+        satisfied = true;
+      }
+    }
+    if (!satisfied && component != -1) {
+      hard ? hardCount++ : softCount++;
+    }
+  }
+  int componentHardCount = 0;
+  int componentSoftCount = 0;
+  for (unsigned i = 0; i < components.size(); i++) {
+    componentHardCount += components[i]->nHard();
+    componentSoftCount += components[i]->nSoft();
+    delete components[i];
+  }
+  EXPECT_EQ(componentHardCount, hardCount);
+  EXPECT_EQ(componentSoftCount, softCount);
+  delete encoded;
+}
+
+/*
+ * The merged model of the components is a model of the whole formula with
+ * the optimal cost of a monolithic solve.
+ */
+TEST_F(TestTimetablerSolve, DecompositionKeepsOptimalCost) {
+  Timetabler *monolithic = encodeIslands();
+  EXPECT_NE(monolithic->solve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(monolithic->isOptimal());
+  uint64_t cost = monolithic->getCost();
+  delete monolithic;
+
+  for (unsigned threadCount = 1; threadCount <= 2; threadCount++) {
+    Timetabler *decomposed = encodeIslands();
+    decomposed->setDecomposition(true);
+    decomposed->setThreadCount(threadCount);
+    EXPECT_NE(decomposed->solve(), SolverStatus::Unsolved);
+    ASSERT_TRUE(decomposed->isOptimal());
+    EXPECT_EQ(decomposed->getCost(), cost);
+    EXPECT_EQ(decomposed->getLowerBound(), cost);
+    checkHardClauses(decomposed);
+    EXPECT_EQ(getModelCost(decomposed), cost);
+    delete decomposed;
+  }
+}
+
+/*
+ * The repaired model of the large neighbourhood search satisfies the hard
+ * clauses, and its cost only improves on the initial model.
+ */
+TEST_F(TestTimetablerSolve, LnsImprovesModelExample1) {
+  std::string fields = TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml";
+  std::string input = TIMETABLER_EXAMPLES_DIR "/example1/input.csv";
+  Timetabler *exact = encode(fields, input);
+  EXPECT_NE(exact->solve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(exact->isOptimal());
+  uint64_t optimalCost = exact->getCost();
+  delete exact;
+
+  for (unsigned threadCount = 1; threadCount <= 2; threadCount++) {
+    Timetabler *repaired = encode(fields, input);
+    repaired->setLns(true);
+    repaired->setThreadCount(threadCount);
+    std::vector<uint64_t> upperBounds;
+    repaired->setProgressCallback(
+        [&upperBounds](const SearchProgress &progress) {
+          if (progress.type == ProgressEventType::UpperBound) {
+            upperBounds.push_back(progress.upperBound);
+          }
+        });
+    EXPECT_NE(repaired->solve(), SolverStatus::Unsolved);
+    checkHardClauses(repaired);
+    EXPECT_EQ(getModelCost(repaired), repaired->getCost());
+    EXPECT_GE(repaired->getCost(), optimalCost);
+    for (unsigned i = 1; i < upperBounds.size(); i++) {
+      EXPECT_LT(upperBounds[i], upperBounds[i - 1]);
+    }
+    if (upperBounds.size() > 0) {
+      EXPECT_EQ(upperBounds.back(), repaired->getCost());
+    }
+    delete repaired;
+  }
+}
+
+/*
+ * Starting from an optimal timetable given as the hint, the large
+ * neighbourhood search keeps its cost.
+ */
+TEST_F(TestTimetablerSolve, LnsKeepsCostOfHintExample1) {
+  std::string fields = TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml";
+  std::string input = TIMETABLER_EXAMPLES_DIR "/example1/input.csv";
+  Timetabler *exact = encode(fields, input);
+  EXPECT_NE(exact->solve(), SolverStatus::Unsolved);
+  ASSERT_TRUE(exact->isOptimal());
+  uint64_t optimalCost = exact->getCost();
+  std::string hintFile = getTempPath("hint.csv");
+  exact->writeOutput(hintFile);
+  delete exact;
+
+  Timetabler *repaired = parseExample(fields, input);
+  Parser parser(repaired);
+  parser.parseHint(hintFile);
+  encodeExample(repaired, true);
+  repaired->setLns(true);
+  EXPECT_NE(repaired->solve(), SolverStatus::Unsolved);
+  checkHardClauses(repaired);
+  EXPECT_EQ(repaired->getCost(), optimalCost);
+  EXPECT_EQ(getModelCost(repaired), optimalCost);
+  delete repaired;
+}
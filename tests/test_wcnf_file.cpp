@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "MaxSATFormula.h"
+#include "global.h"
+#include "global_vars.h"
+#include "test_helper.h"
+#include "timetabler.h"
+#include "wcnf_file.h"
+
+class TestWcnfFile : public TestTimetabler {};
+
+/*
+ * Writes the formula of example 1 to a temporary file, reads it back, and
+ * checks that the clauses, the variables in Data and the optimal cost are the
+ * same.
+ */
+TEST_F(TestWcnfFile, WriteAndReadExample1) {
+  std::string file = getTempPath("example1.wcnf");
+  Timetabler *written =
+      parseExample(TIMETABLER_EXAMPLES_DIR "/example1/fields.yaml",
+                   TIMETABLER_EXAMPLES_DIR "/example1/input.csv");
+  encodeExample(written, true);
+  WcnfFile(written).write(file);
+
+  Timetabler *read = new Timetabler();
+  timetabler = read;
+  WcnfFile(read).read(file);
+  MaxSATFormula *writtenFormula = written->getFormula();
+  MaxSATFormula *readFormula = read->getFormula();
+  ASSERT_EQ(readFormula->nVars(), writtenFormula->nVars());
+  ASSERT_EQ(readFormula->nHard(), writtenFormula->nHard());
+  ASSERT_EQ(readFormula->nSoft(), writtenFormula->nSoft());
+  for (int i = 0; i < readFormula->nSoft(); i++) {
+    ASSERT_EQ(readFormula->getSoftClause(i).weight,
+              writtenFormula->getSoftClause(i).weight);
+    ASSERT_EQ(readFormula->getSoftClause(i).clause.size(),
+              writtenFormula->getSoftClause(i).clause.size());
+  }
+  ASSERT_EQ(read->data.fieldValueVars, written->data.fieldValueVars);
+  ASSERT_EQ(read->data.highLevelVars, written->data.highLevelVars);
+  ASSERT_EQ(read->data.predefinedConstraintVars,
+            written->data.predefinedConstraintVars);
+  ASSERT_EQ(read->data.trueVar, written->data.trueVar);
+
+  timetabler = written;
+  written->solve();
+  timetabler = read;
+  read->setGreedyStart(false);
+  read->solve();
+  ASSERT_TRUE(read->isOptimal());
+  ASSERT_EQ(read->getCost(), written->getCost());
+
+  delete read;
+  delete written;
+}